@@ -38,7 +38,21 @@ namespace RestFrames {
     // Event analysis functions
     void ClearFourVectors();
     GroupElementID AddLabFrameFourVector(const TLorentzVector& V);
+    // a labelled element may only be assigned to the frames
+    // allowed for its label (any frame, if none are set)
+    GroupElementID AddLabFrameFourVector(const TLorentzVector& V, const string& label);
     int GetNFourVectors() const;
+    string GetLabel(const GroupElementID elementID) const;
+    // four-vector and label of the i-th element added
+    TLorentzVector GetElementFourVector(int i) const;
+    string GetElementLabel(int i) const;
+
+    void AddFrameForLabel(const string& label, const RestFrame& frame);
+    void AddFrameForLabel(const string& label, const RestFrame* framePtr);
+    void AddFrameForLabel(const string& label, const RestFrameList* framesPtr);
+    void ClearFramesForLabels();
+    // whether the element may be assigned to any of the frames
+    bool IsAllowedInFrames(const GroupElementID elementID, const RestFrameList* framesPtr) const;
 
     virtual void ClearEvent();
     virtual bool AnalyzeEvent();
@@ -55,6 +69,11 @@ namespace RestFrames {
     
     vector<int> m_StateKeys;
 
+    vector<TLorentzVector> m_ElementFourVectors;
+    vector<string> m_ElementLabels;
+    vector<string> m_Labels;
+    vector<RestFrameList> m_LabelFrames;
+
     virtual State* InitializeGroupState();
     void ClearElements();
     void AddElement(State* statePtr);
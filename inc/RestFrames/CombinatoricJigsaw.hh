@@ -3,10 +3,14 @@
 #include <iostream>
 #include <string>
 #include <vector>
+#include <limits>
+#include <algorithm>
+#include <chrono>
 #include "RestFrames/RestFrame.hh"
 #include "RestFrames/RestFrameList.hh"
 #include "RestFrames/Jigsaw.hh"
 #include "RestFrames/JigsawList.hh"
+#include "RestFrames/JigsawGraph.hh"
 #include "RestFrames/State.hh"
 #include "RestFrames/CombinatoricState.hh"
 #include "RestFrames/StateList.hh"
@@ -25,6 +29,51 @@ namespace RestFrames {
   class CombinatoricState;
   class CombinatoricGroup;
 
+  ///////////////////////////////////////////////
+  // CombinatoricSolutions class
+  // the N best combinatorics seen, by smallest cost
+  // and, of equal costs, the later combinatoric
+  ///////////////////////////////////////////////
+  class CombinatoricSolutions {
+  public:
+    CombinatoricSolutions(int N = 1);
+
+    void Clear();
+    void SetNMax(int N);
+    int GetNMax() const { return m_NMax; }
+
+    // kept as a heap with the worst solution first
+    // until sorted by Sort (best first)
+    void Add(double cost, long long c){
+      if(!(cost <= numeric_limits<double>::max())) return;
+      Solution sol(cost, c);
+      if(int(m_Solutions.size()) < m_NMax){
+	m_Solutions.push_back(sol);
+	push_heap(m_Solutions.begin(), m_Solutions.end(), IsBetter);
+	return;
+      }
+      if(!IsBetter(sol, m_Solutions.front())) return;
+      pop_heap(m_Solutions.begin(), m_Solutions.end(), IsBetter);
+      m_Solutions.back() = sol;
+      push_heap(m_Solutions.begin(), m_Solutions.end(), IsBetter);
+    }
+    void Add(const CombinatoricSolutions& solutions);
+    void Sort();
+
+    int GetN() const { return m_Solutions.size(); }
+    double GetCost(int i) const;
+    long long GetCombinatoric(int i) const;
+
+  protected:
+    typedef pair<double,long long> Solution;
+    static bool IsBetter(const Solution& a, const Solution& b){
+      return a.first < b.first || (a.first == b.first && a.second > b.second);
+    }
+
+    int m_NMax;
+    vector<Solution> m_Solutions;
+  };
+
   ///////////////////////////////////////////////
   // CombinatoricJigsaw class
   ///////////////////////////////////////////////
@@ -43,6 +92,60 @@ namespace RestFrames {
     virtual void AddFrame(RestFrameList* framesPtr, int i = 0);
 
     virtual bool InitializeJigsawExecutionList(JigsawList* chain_jigsawPtr);
+    // jigsaws executed for each combinatoric hypothesis, as found
+    // by InitializeJigsawExecutionList (or restored from a snapshot)
+    JigsawList* GetExecuteJigsaws() const;
+    void SetExecuteJigsaws(const JigsawList* jigsawsPtr);
+
+    // one evaluation, including the execute list, per assignment
+    virtual double GetExecutionCost() const;
+
+    // brute force searches over at least min_assign assignments
+    // are shared among Nthread threads (including the calling one),
+    // which persist until this is called again. When the dependancy
+    // states change between assignments, each thread executes its
+    // own copies of the jigsaws they are built from (if all can be
+    // copied, see Jigsaw::NewSearchCopy, and no event trace is
+    // recording)
+    void SetParallelSearch(int Nthread, int min_assign = 4096);
+    int GetNSearchThreads() const;
+
+    // Keeps the N best assignments of each event's search. After
+    // the event is analyzed, RLabFrame::AnalyzeSolution evaluates
+    // the tree for any of them
+    void SetNSolutions(int N);
+    // solutions found for the current event, best first
+    int GetNSolutions() const;
+    double GetSolutionCost(int i) const;
+    // assigns the outputs to solution i, without executing jigsaws
+    bool UseSolution(int i);
+
+    // Bounds the search of each event to max_candidates assignments
+    // (if positive) and max_time seconds (if positive). When there
+    // are too many inputs to try every assignment, the softest are
+    // merged with their nearest neighbours (for outputs without
+    // exclusive multiplicities). Searches still over max_candidates
+    // (exclusive ones, where only the allowed assignments are
+    // counted) use a local search instead, and the rest are
+    // searched until the time runs out
+    void SetSearchBudget(int max_candidates, double max_time = 0.);
+    // whether the current event's result came from a reduced search.
+    // A search finding no allowed assignment within the budget
+    // falls back to a local search (see SetLocalSearch)
+    bool IsApproximate() const;
+
+    // Searches with at least min_inputs free inputs (if positive),
+    // whose dependancy states do not change between assignments,
+    // use a local search (see HemisphereLocalSearch) instead of
+    // trying every assignment. Only its solution is kept, and the
+    // result is flagged as approximate
+    void SetLocalSearch(int min_inputs);
+    int GetLocalSearch() const;
+
+    // inputs of the current event, and the current outputs
+    // as a combinatoric
+    int GetNInputs() const;
+    long long GetCurrentCombinatoric() const;
   
   protected:
     virtual State* NewOutputState();
@@ -50,11 +153,78 @@ namespace RestFrames {
     JigsawList m_ExecuteJigsaws;
     bool ExecuteDependancyJigsaws();
 
+    // the execute list, split by what each jigsaw reads: jigsaws
+    // independent of this one's outputs (run once per event),
+    // jigsaws the dependancy states are built from (run for each
+    // combinatoric) and the rest (run only for the chosen one)
+    JigsawList m_InvariantJigsaws;
+    JigsawList m_SearchJigsaws;
+    JigsawList m_ResultJigsaws;
+    bool m_ExecuteSplit;
+    void SplitExecuteJigsaws();
+    bool ExecuteJigsaws(const JigsawList& jigsaws);
+
+    int m_NSearchThreads;
+    int m_MinParallelAssignments;
+    JigsawExecutor* m_SearchPoolPtr;
+
+    // per search thread: copies of m_SearchJigsaws, of the outputs
+    // they read and of the dependancy states, built when first
+    // needed (none if a search jigsaw cannot be copied)
+    vector<vector<Jigsaw*> > m_SearchCopies;
+    vector<vector<CombinatoricState*> > m_OutputCopies;
+    vector<vector<StateList*> > m_DependancyCopies;
+    bool m_SearchCopiesBuilt;
+    bool InitializeSearchCopies();
+    void ClearSearchCopies();
+
     vector<State*> m_Inputs;
     vector<CombinatoricState*> m_Outputs;
     vector<int> m_NForOutput;
     vector<bool> m_NExclusive;
+    // output states and their multiplicities, resolved once
+    // after initialization rather than each event
+    bool m_OutputsResolved;
+    bool ResolveOutputStates(CombinatoricGroup* groupPtr);
     virtual bool InitializeEvent();
+
+    // two output combinatorics: bit i of c puts input i in output 1
+    // (so at most 63 inputs)
+    bool IsValidCombinatoric(const int* Nhem) const;
+    void SetCombinatoric(long long c);
+    void SetCombinatoric(long long c, const vector<CombinatoricState*>& outputs) const;
+
+    CombinatoricSolutions m_Solutions;
+
+    // inputs whose group labels allow only one output are fixed,
+    // and only the free ones (or groups of them, when merged to
+    // fit the budget) are enumerated: combinatoric k of
+    // GetNCombinatorics() is GetCombinatoric(k). When an output's
+    // multiplicity is exclusive, only the choices of m_NChosen
+    // free inputs for output 1 are enumerated (m_NChosen is -1
+    // otherwise)
+    bool m_Constrained;
+    long long m_FixedCombinatoric;
+    vector<long long> m_FreeMasks;
+    int m_NChosen;
+    long long GetNCombinatorics() const;
+    long long GetCombinatoric(int k) const;
+    void MergeFreeInputs(int Nmax);
+
+    int m_MaxCandidates;
+    double m_MaxSearchTime;
+    double m_SearchDeadline;
+    bool m_Approximate;
+    // number of the GetNCombinatorics() to try, merging free inputs
+    // first if there are too many for the budget (0 if still too
+    // many, or too many to enumerate without a budget)
+    int GetNSearchCombinatorics();
+    // whether the time budget has run out
+    bool IsOverTime() const;
+
+    int m_LocalSearchMin;
+    // whether the current event is searched locally
+    bool UseLocalSearch() const;
     
   private:
     void Init();
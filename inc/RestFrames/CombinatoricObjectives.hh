@@ -0,0 +1,166 @@
+#ifndef CombinatoricObjectives_HH
+#define CombinatoricObjectives_HH
+#include <iostream>
+#include <string>
+#include <vector>
+#include <cmath>
+#include <TLorentzVector.h>
+#include <TVector3.h>
+#include "RestFrames/State.hh"
+#include "RestFrames/FourVector.hh"
+
+using namespace std;
+
+namespace RestFrames {
+
+  class State;
+
+  ///////////////////////////////////////////////
+  // Objectives for ObjectiveCombinatoricJigsaw
+  // GetElementScore is given each input element and its group
+  // label (see CombinatoricGroup::AddLabFrameFourVector). GetCost
+  // is given the lab frame four-vectors of the two
+  // hemispheres (which it may modify), their numbers of
+  // elements and their summed element scores, and returns
+  // a cost to be minimized. It is a template over the
+  // four-vector type, TLorentzVector or, in single precision
+  // searches, FourVector<float> (see FourVector.hh)
+  ///////////////////////////////////////////////
+
+  ///////////////////////////////////////////////
+  // MaximizeMomentumObjective class
+  // maximizes the sum of the hemisphere momenta in their
+  // combined rest frame (minimizing their masses)
+  ///////////////////////////////////////////////
+  class MaximizeMomentumObjective {
+  public:
+    double GetElementScore(const State* elementPtr, const string& label) const { return 0.; }
+
+    template <class V>
+    double GetCost(V* hem, const int* Nhem, const double* score) const {
+      if(Nhem[0] == 0 || Nhem[1] == 0) return 0.;
+      auto boost = (hem[0]+hem[1]).BoostVector();
+      hem[0].Boost(-boost);
+      hem[1].Boost(-boost);
+      return -(hem[0].P()+hem[1].P());
+    }
+  };
+
+  ///////////////////////////////////////////////
+  // MinimizeMassDifferenceObjective class
+  ///////////////////////////////////////////////
+  class MinimizeMassDifferenceObjective {
+  public:
+    double GetElementScore(const State* elementPtr, const string& label) const { return 0.; }
+
+    template <class V>
+    double GetCost(V* hem, const int* Nhem, const double* score) const {
+      return fabs(hem[0].M()-hem[1].M());
+    }
+  };
+
+  ///////////////////////////////////////////////
+  // MinimizeMaxMassObjective class
+  ///////////////////////////////////////////////
+  class MinimizeMaxMassObjective {
+  public:
+    double GetElementScore(const State* elementPtr, const string& label) const { return 0.; }
+
+    template <class V>
+    double GetCost(V* hem, const int* Nhem, const double* score) const {
+      return max(hem[0].M(), hem[1].M());
+    }
+  };
+
+  ///////////////////////////////////////////////
+  // MassChi2Objective class
+  // chi^2 of both hemisphere masses to a known mass
+  ///////////////////////////////////////////////
+  class MassChi2Objective {
+  public:
+    MassChi2Objective(){
+      m_Mass = 0.;
+      m_Width = 1.;
+    }
+
+    void SetMass(double mass){ m_Mass = mass; }
+    void SetWidth(double width){ if(width > 0.) m_Width = width; }
+    double GetMass() const { return m_Mass; }
+    double GetWidth() const { return m_Width; }
+
+    double GetElementScore(const State* elementPtr, const string& label) const { return 0.; }
+
+    template <class V>
+    double GetCost(V* hem, const int* Nhem, const double* score) const {
+      double chi2 = 0.;
+      for(int i = 0; i < 2; i++){
+	double pull = (hem[i].M()-m_Mass)/m_Width;
+	chi2 += pull*pull;
+      }
+      return chi2;
+    }
+
+  protected:
+    double m_Mass;
+    double m_Width;
+  };
+
+  ///////////////////////////////////////////////
+  // BTagObjective class
+  // adds to the cost of Base a penalty for each hemisphere
+  // whose summed b-tag weight differs from one. Weights are
+  // set per element label (see CombinatoricGroup::
+  // AddLabFrameFourVector) and kept until ClearTags, so each
+  // event only has to label its elements
+  ///////////////////////////////////////////////
+  template <class Base>
+  class BTagObjective : public Base {
+  public:
+    BTagObjective(){
+      m_Penalty = 1.;
+    }
+
+    void SetPenalty(double penalty){ m_Penalty = penalty; }
+    double GetPenalty() const { return m_Penalty; }
+
+    void ClearTags(){
+      m_Labels.clear();
+      m_Tags.clear();
+    }
+
+    void SetTag(const string& label, double weight = 1.){
+      if(label.empty()) return;
+      int N = m_Labels.size();
+      for(int i = 0; i < N; i++){
+	if(m_Labels[i] == label){
+	  m_Tags[i] = weight;
+	  return;
+	}
+      }
+      m_Labels.push_back(label);
+      m_Tags.push_back(weight);
+    }
+
+    double GetElementScore(const State* elementPtr, const string& label) const {
+      if(label.empty()) return 0.;
+      int N = m_Labels.size();
+      for(int i = 0; i < N; i++)
+	if(m_Labels[i] == label) return m_Tags[i];
+      return 0.;
+    }
+
+    template <class V>
+    double GetCost(V* hem, const int* Nhem, const double* score) const {
+      return Base::GetCost(hem, Nhem, score) +
+	m_Penalty*(fabs(score[0]-1.)+fabs(score[1]-1.));
+    }
+
+  protected:
+    double m_Penalty;
+    vector<string> m_Labels;
+    vector<double> m_Tags;
+  };
+
+}
+
+#endif
@@ -3,6 +3,7 @@
 #include <iostream>
 #include <string>
 #include <vector>
+#include <atomic>
 #include <TLorentzVector.h>
 #include <TVector3.h>
 //#include "RestFrames/State.hh"
@@ -26,16 +27,38 @@ namespace RestFrames {
 	
     virtual void Boost(const TVector3& B);
     virtual TLorentzVector GetFourVector() const; 
+    virtual double GetMass() const;
+    virtual double GetMomentum() const;
+    virtual void SaveFourVectors(vector<TLorentzVector>& Ps) const;
+    virtual int RestoreFourVectors(const vector<TLorentzVector>& Ps, int i);
 
     void ClearElements();
     void AddElement(State* statePtr);
     void AddElement(StateList* statesPtr);
     StateList* GetElements() const;
+    // the state's own list, not a copy
+    const StateList* GetElementList() const { return &m_Elements; }
     int GetNElements() const;
     bool ContainsElement(const State* statePtr) const;
+    // to be called after setting the four-vectors of elements
+    // directly, rather than through a combinatoric state
+    static void SetElementsChanged();
 
   protected:
     StateList m_Elements;
+
+    // sum of the elements' four-vectors, kept as elements are
+    // added and refilled on the first read after a Boost. Elements
+    // changed elsewhere (through another combinatoric state, or by
+    // their group) advance m_ElementsEpoch; the next read then
+    // checks the sum of their versions (see State)
+    mutable TLorentzVector m_ElementsP;
+    mutable unsigned long long m_ElementsVersion;
+    mutable atomic<unsigned long long> m_ElementsEpochSeen;
+    mutable bool m_ElementsDirty;
+    static atomic<unsigned long long> m_ElementsEpoch;
+    const TLorentzVector& GetElementsFourVector() const;
+    void UpdateElementsCache();
   
   private:
     void Init();
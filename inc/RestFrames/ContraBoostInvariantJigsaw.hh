@@ -37,6 +37,7 @@ namespace RestFrames {
 
     virtual double GetMinimumMass();
     virtual bool AnalyzeEvent();
+    virtual Jigsaw* NewSearchCopy(StateMap& states) const;
 
     virtual void FillInvisibleMassJigsawDependancies(JigsawList* jigsaws);
 
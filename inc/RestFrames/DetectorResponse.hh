@@ -0,0 +1,93 @@
+#ifndef DetectorResponse_HH
+#define DetectorResponse_HH
+#include <iostream>
+#include <string>
+#include <vector>
+#include <TLorentzVector.h>
+#include <TVector3.h>
+#include <TRandom.h>
+#include "RestFrames/RestFrame.hh"
+
+using namespace std;
+
+namespace RestFrames {
+
+  class RestFrame;
+
+  ///////////////////////////////////////////////
+  // DetectorResponse class
+  // Gaussian energy/angle smearing, efficiency
+  // and missing momentum response applied to
+  // generator level objects (see FrameBridge).
+  // Settings not given for a frame follow the
+  // default ones, whenever those are set
+  ///////////////////////////////////////////////
+  class DetectorResponse {
+  public:
+    DetectorResponse(const string& sname, const string& stitle);
+    virtual ~DetectorResponse();
+
+    void Clear();
+
+    string GetName() const;
+    string GetTitle() const;
+
+    void SetSeed(int seed);
+
+    // relative energy resolution
+    // sigma_E/E = stochastic/sqrt(E) (+) constant (+) noise/E
+    void SetEnergyResolution(double stochastic, double constant = 0., double noise = 0.);
+    void SetEnergyResolution(const RestFrame& frame, double stochastic,
+			     double constant = 0., double noise = 0.);
+    // absolute pseudo-rapidity and azimuthal angle resolution
+    void SetAngularResolution(double sigma_eta, double sigma_phi);
+    void SetAngularResolution(const RestFrame& frame, double sigma_eta, double sigma_phi);
+    // probability for an object to be reconstructed
+    void SetEfficiency(double eff);
+    void SetEfficiency(const RestFrame& frame, double eff);
+    // resolution on each transverse component of the
+    // unclustered (soft) missing momentum
+    void SetMissingMomentumResolution(double sigma);
+
+    // index of the response settings used for frame
+    // (0 for the default settings)
+    int GetResponseIndex(const RestFrame* framePtr) const;
+    // changed whenever the response indices change
+    int GetVersion() const;
+
+    // Smears all objects of an event in place. Objects which are
+    // lost are flagged in accepted, and the change in the visible
+    // transverse momentum is added to dMET
+    void SmearEvent(const vector<int>& index, vector<TLorentzVector>& P,
+		    vector<bool>& accepted, TVector3& dMET);
+    bool SmearObject(int index, TLorentzVector& P);
+
+  protected:
+    static int m_class_key;
+
+    string m_Name;
+    string m_Title;
+
+    vector<const RestFrame*> m_Frames;
+    vector<double> m_EnergyStochastic;
+    vector<double> m_EnergyConstant;
+    vector<double> m_EnergyNoise;
+    vector<double> m_SigmaEta;
+    vector<double> m_SigmaPhi;
+    vector<double> m_Efficiency;
+    double m_SigmaMET;
+    int m_Version;
+
+    // per-frame settings are negative until set
+    int AddResponseIndex(const RestFrame* framePtr);
+    double GetSetting(const vector<double>& settings, int index) const;
+
+  private:
+    TRandom *m_Random;
+    void Init();
+
+  };
+
+}
+
+#endif
@@ -0,0 +1,137 @@
+#ifndef EventSource_HH
+#define EventSource_HH
+#include <iostream>
+#include <string>
+#include <vector>
+#include <cstdio>
+#include <TLorentzVector.h>
+#include <TVector3.h>
+
+using namespace std;
+
+namespace RestFrames {
+
+  class CombinatoricGroup;
+  class InvisibleGroup;
+
+  ///////////////////////////////////////////////
+  // EventSource class
+  // sequence of events, each a list of visible
+  // lab frame four-vectors plus missing momentum
+  ///////////////////////////////////////////////
+  class EventSource {
+  public:
+    EventSource(const string& sname, const string& stitle);
+    virtual ~EventSource();
+
+    string GetName() const;
+    string GetTitle() const;
+
+    virtual long GetNEvents() const = 0;
+    virtual bool ReadEvent(long ievent) = 0;
+    bool NextEvent();
+    long GetCurrentEvent() const;
+
+    virtual int GetNVisible() const = 0;
+    // (px, py, pz, E) of the i-th visible object
+    virtual const double* GetVisibleData(int i) const = 0;
+    virtual TVector3 GetMET() const = 0;
+    TLorentzVector GetVisibleFourVector(int i) const;
+
+    // Fills the inputs of a reconstruction tree with the current
+    // event (call between RLabFrame::ClearEvent and AnalyzeEvent)
+    bool TransferEvent(CombinatoricGroup& group, InvisibleGroup& inv_group) const;
+    bool TransferEvent(CombinatoricGroup* groupPtr, InvisibleGroup* inv_groupPtr) const;
+
+  protected:
+    string m_Name;
+    string m_Title;
+    long m_CurrentEvent;
+
+  };
+
+  ///////////////////////////////////////////////
+  // BinaryEventSource class
+  // memory-mapped flat binary event file:
+  //
+  //  header:  char[8] "RFEVENTS", uint32 version, uint32 (unused),
+  //           uint64 number of events, uint64 offset of index
+  //  event:   uint32 N, uint32 (unused), double MET[3],
+  //           double P[N][4] as (px, py, pz, E)
+  //  index:   uint64 offset of each event, in increasing order
+  //
+  // all fields are 8-byte aligned, native byte order
+  ///////////////////////////////////////////////
+  class BinaryEventSource : public EventSource {
+  public:
+    BinaryEventSource(const string& sname, const string& stitle);
+    virtual ~BinaryEventSource();
+
+    bool Open(const string& filename);
+    void Close();
+    bool IsOpen() const;
+
+    // number of events paged in ahead of the current one
+    void SetBlockSize(long N);
+
+    virtual long GetNEvents() const;
+    virtual bool ReadEvent(long ievent);
+
+    virtual int GetNVisible() const;
+    virtual const double* GetVisibleData(int i) const;
+    virtual TVector3 GetMET() const;
+
+    static const char* m_Magic;
+    static const unsigned int m_Version;
+
+  protected:
+    int m_File;
+    char* m_Map;
+    size_t m_MapSize;
+    long m_NEvents;
+    const unsigned long long* m_Index;
+
+    long m_BlockSize;
+    long m_CurrentBlock;
+
+    int m_NVisible;
+    const double* m_METData;
+    const double* m_VisibleData;
+
+    void ReadAhead(long block);
+
+  };
+
+  ///////////////////////////////////////////////
+  // BinaryEventWriter class
+  // writes files readable by BinaryEventSource
+  ///////////////////////////////////////////////
+  class BinaryEventWriter {
+  public:
+    BinaryEventWriter(const string& sname, const string& stitle);
+    virtual ~BinaryEventWriter();
+
+    string GetName() const;
+    string GetTitle() const;
+
+    bool Open(const string& filename);
+    bool Close();
+    bool IsOpen() const;
+
+    bool WriteEvent(const vector<TLorentzVector>& P_visible, const TVector3& MET);
+    long GetNEvents() const;
+
+  protected:
+    string m_Name;
+    string m_Title;
+
+    FILE* m_File;
+    unsigned long long m_Offset;
+    vector<unsigned long long> m_Index;
+    vector<double> m_Buffer;
+
+  };
+
+}
+
+#endif
@@ -0,0 +1,151 @@
+#ifndef EventTrace_HH
+#define EventTrace_HH
+#include <iostream>
+#include <string>
+#include <vector>
+#include <cstdio>
+#include <chrono>
+#include <TLorentzVector.h>
+#include "RestFrames/Jigsaw.hh"
+#include "RestFrames/JigsawList.hh"
+
+using namespace std;
+
+namespace RestFrames {
+
+  class Jigsaw;
+  class JigsawList;
+
+  // One entry of an event trace: an execution of a jigsaw or,
+  // for jigsaws executed by a combinatoric search, all of their
+  // executions under the same parent entry
+  struct JigsawExecution {
+    int Jigsaw;              // index among the trace's jigsaws
+    int Depth;               // 0 for the lab frame's execution chain
+    int NCalls;
+    int NFailures;
+    double Time;             // seconds, including nested executions
+    // combinatoric jigsaws, after the last call
+    int NInputs;
+    int Approximate;
+    long long Combinatoric;  // bit i set: input i assigned to output 1
+  };
+
+  // the inputs of an analyzed event and its jigsaw executions
+  struct TraceEvent {
+    long long Number;        // count of the event while recording
+    double Time;             // seconds in RLabFrame::AnalyzeEvent
+    bool Analyzed;           // whether AnalyzeEvent succeeded
+    vector<int> Sources;     // of each input, index among the trace's sources
+    vector<TLorentzVector> Inputs;
+    vector<string> Labels;
+    vector<JigsawExecution> Executions;
+  };
+
+  ///////////////////////////////////////////////
+  // EventTrace class
+  // records the events analyzed by an RLabFrame (see
+  // RLabFrame::SetEventTrace): their inputs and the sequence
+  // of jigsaw executions, with times. Any recorded event can
+  // then be analyzed again by RLabFrame::ReplayEvent, in a
+  // job with the same tree, e.g. under a profiler
+  //
+  //  header:  char[8] "RFTRACES", uint32 version, uint32 (unused),
+  //           uint64 hash of the analysis (see RLabFrame::SaveAnalysis),
+  //           uint32 N jigsaws, uint32 N sources, then the name of
+  //           each jigsaw and source (uint32 length, chars)
+  //  event:   int64 number, double time, uint32 analyzed,
+  //           uint32 N inputs, uint32 N executions, uint32 (unused),
+  //           per input: int32 source, label (uint32 length, chars),
+  //           double P[4] as (px, py, pz, E)
+  //           per execution: int32 jigsaw, depth, N calls, N failures,
+  //           double time, int32 N inputs, approximate, int64 combinatoric
+  //
+  // Sources are the visible frames of the lab states, then the
+  // groups, of the lab frame
+  ///////////////////////////////////////////////
+  class EventTrace {
+  public:
+    EventTrace(const string& sname, const string& stitle);
+    virtual ~EventTrace();
+
+    string GetName() const;
+    string GetTitle() const;
+
+    // Only events taking at least min_time seconds are kept: in
+    // memory or, while a file is open, written to it
+    void SetMinTime(double min_time);
+    double GetMinTime() const;
+    bool Open(const string& filename);
+    bool Close();
+    bool IsOpen() const;
+
+    // loads the events of a trace file (those before an
+    // incomplete last event, if truncated)
+    bool Read(const string& filename);
+
+    // events analyzed while recording, and those kept
+    long long GetNRecorded() const;
+    long GetNEvents() const;
+    const TraceEvent& GetEvent(long i) const;
+    // the last event analyzed, whether kept or not
+    const TraceEvent& GetLastEvent() const;
+    // index of the kept event with the longest time (-1 if none)
+    long GetSlowestEvent() const;
+
+    unsigned long long GetAnalysisHash() const;
+    int GetNJigsaws() const;
+    string GetJigsawName(int i) const;
+    int GetNSources() const;
+    string GetSourceName(int i) const;
+
+    void Print(const TraceEvent& event) const;
+
+    // used by RLabFrame and Jigsaw while recording
+    void SetAnalysis(unsigned long long hash, const JigsawList& jigsaws,
+		     const vector<string>& sources);
+    void StartEvent();
+    void AddInput(int source, const TLorentzVector& P, const string& label = "");
+    void StopEvent(bool analyzed);
+    void StartJigsaw(const Jigsaw* jigsawPtr);
+    void StopJigsaw(const Jigsaw* jigsawPtr, bool ok);
+
+    static const char* m_Magic;
+    static const unsigned int m_Version;
+
+  protected:
+    typedef chrono::steady_clock Clock;
+
+    string m_Name;
+    string m_Title;
+    double m_MinTime;
+
+    unsigned long long m_AnalysisHash;
+    JigsawList m_Jigsaws;
+    vector<string> m_JigsawNames;
+    vector<string> m_SourceNames;
+
+    FILE* m_File;
+    bool m_HeaderWritten;
+    bool m_WriteError;
+
+    long long m_NRecorded;
+    vector<TraceEvent> m_Events;
+
+    // the event being recorded, and its open executions
+    TraceEvent m_Current;
+    bool m_InEvent;
+    Clock::time_point m_EventStart;
+    vector<int> m_Stack;
+    vector<Clock::time_point> m_Starts;
+
+    bool WriteHeader();
+    bool WriteEvent(const TraceEvent& event);
+    // the rest of an event, after its number
+    bool ReadEvent(FILE* file, TraceEvent& event);
+
+  };
+
+}
+
+#endif
@@ -0,0 +1,131 @@
+#ifndef FourVector_HH
+#define FourVector_HH
+#include <cmath>
+#include <TLorentzVector.h>
+#include <TVector3.h>
+
+using namespace std;
+
+namespace RestFrames {
+
+  ///////////////////////////////////////////////
+  // ThreeVector and FourVector classes
+  // minimal kinematics in scalar type T, with the names of
+  // TVector3 and TLorentzVector (and the same formulae), so
+  // that kernels written for ROOT vectors can be instantiated
+  // in single precision. All arithmetic is done in T
+  ///////////////////////////////////////////////
+  template <class T>
+  class ThreeVector {
+  public:
+    ThreeVector() : m_X(0), m_Y(0), m_Z(0) { }
+    ThreeVector(T x, T y, T z) : m_X(x), m_Y(y), m_Z(z) { }
+    explicit ThreeVector(const TVector3& V) :
+      m_X(T(V.X())), m_Y(T(V.Y())), m_Z(T(V.Z())) { }
+
+    T X() const { return m_X; }
+    T Y() const { return m_Y; }
+    T Z() const { return m_Z; }
+
+    T Mag2() const { return m_X*m_X + m_Y*m_Y + m_Z*m_Z; }
+    T Mag() const { return sqrt(Mag2()); }
+
+    ThreeVector operator-() const { return ThreeVector(-m_X, -m_Y, -m_Z); }
+
+    TVector3 GetTVector3() const { return TVector3(m_X, m_Y, m_Z); }
+
+  protected:
+    T m_X;
+    T m_Y;
+    T m_Z;
+  };
+
+  template <class T>
+  class FourVector {
+  public:
+    FourVector() : m_X(0), m_Y(0), m_Z(0), m_E(0) { }
+    FourVector(T px, T py, T pz, T E) : m_X(px), m_Y(py), m_Z(pz), m_E(E) { }
+    explicit FourVector(const TLorentzVector& P) :
+      m_X(T(P.Px())), m_Y(T(P.Py())), m_Z(T(P.Pz())), m_E(T(P.E())) { }
+
+    void SetPxPyPzE(T px, T py, T pz, T E){
+      m_X = px;
+      m_Y = py;
+      m_Z = pz;
+      m_E = E;
+    }
+
+    T Px() const { return m_X; }
+    T Py() const { return m_Y; }
+    T Pz() const { return m_Z; }
+    T E() const { return m_E; }
+
+    ThreeVector<T> Vect() const { return ThreeVector<T>(m_X, m_Y, m_Z); }
+    T P() const { return Vect().Mag(); }
+    T M2() const { return m_E*m_E - Vect().Mag2(); }
+    T M() const {
+      T mm = M2();
+      return mm < 0 ? -sqrt(-mm) : sqrt(mm);
+    }
+
+    ThreeVector<T> BoostVector() const {
+      return ThreeVector<T>(m_X/m_E, m_Y/m_E, m_Z/m_E);
+    }
+
+    void Boost(const ThreeVector<T>& B){
+      T bx = B.X();
+      T by = B.Y();
+      T bz = B.Z();
+      T b2 = bx*bx + by*by + bz*bz;
+      T gamma = T(1)/sqrt(T(1) - b2);
+      T bp = bx*m_X + by*m_Y + bz*m_Z;
+      T gamma2 = b2 > 0 ? (gamma - T(1))/b2 : T(0);
+      m_X += gamma2*bp*bx + gamma*bx*m_E;
+      m_Y += gamma2*bp*by + gamma*by*m_E;
+      m_Z += gamma2*bp*bz + gamma*bz*m_E;
+      m_E = gamma*(m_E + bp);
+    }
+
+    FourVector& operator+=(const FourVector& V){
+      m_X += V.m_X;
+      m_Y += V.m_Y;
+      m_Z += V.m_Z;
+      m_E += V.m_E;
+      return *this;
+    }
+    FourVector operator+(const FourVector& V) const {
+      FourVector sum = *this;
+      sum += V;
+      return sum;
+    }
+
+    TLorentzVector GetTLorentzVector() const {
+      return TLorentzVector(m_X, m_Y, m_Z, m_E);
+    }
+
+  protected:
+    T m_X;
+    T m_Y;
+    T m_Z;
+    T m_E;
+  };
+
+  ///////////////////////////////////////////////
+  // KinematicsTraits
+  // the four-vector type of kernels in scalar type T:
+  // ROOT's own vectors in double precision, so that double
+  // kernels are unchanged, and FourVector<T> otherwise
+  ///////////////////////////////////////////////
+  template <class T>
+  struct KinematicsTraits {
+    typedef FourVector<T> Vector;
+  };
+
+  template <>
+  struct KinematicsTraits<double> {
+    typedef TLorentzVector Vector;
+  };
+
+}
+
+#endif
@@ -0,0 +1,109 @@
+#ifndef FrameBridge_HH
+#define FrameBridge_HH
+#include <iostream>
+#include <string>
+#include <vector>
+#include <TLorentzVector.h>
+#include <TVector3.h>
+#include "RestFrames/RestFrame.hh"
+
+using namespace std;
+
+namespace RestFrames {
+
+  class RestFrame;
+  class VisibleFrame;
+  class CombinatoricGroup;
+  class InvisibleGroup;
+  class DetectorResponse;
+
+  ///////////////////////////////////////////////
+  // FrameBridge class
+  // maps generator (G) frames onto the inputs of
+  // a reconstruction (R) tree, transferring their
+  // lab frame four-vectors each event
+  ///////////////////////////////////////////////
+  class FrameBridge {
+  public:
+    FrameBridge(const string& sname, const string& stitle);
+    virtual ~FrameBridge();
+
+    void Clear();
+
+    string GetName() const;
+    string GetTitle() const;
+
+    // generator visible frame -> RVisibleFrame
+    bool AddVisibleFrame(const RestFrame& gen_frame, RestFrame& reco_frame);
+    bool AddVisibleFrame(const RestFrame* gen_framePtr, RestFrame* reco_framePtr);
+    // generator visible frame -> element of CombinatoricGroup
+    bool AddVisibleFrame(const RestFrame& gen_frame, CombinatoricGroup& group);
+    bool AddVisibleFrame(const RestFrame* gen_framePtr, CombinatoricGroup* groupPtr);
+    // generator invisible frames -> (summed) InvisibleGroup input
+    bool AddInvisibleFrame(const RestFrame& gen_frame, InvisibleGroup& group);
+    bool AddInvisibleFrame(const RestFrame* gen_framePtr, InvisibleGroup* groupPtr);
+
+    // if true (default) only the transverse part of the
+    // invisible sum is passed to each InvisibleGroup
+    void SetTransverseInvisible(bool transverse = true);
+
+    // optional detector response applied to the visible
+    // objects, with the missing momentum recomputed (its change
+    // shared among the InvisibleGroups by transverse momentum)
+    void SetResponse(DetectorResponse& response);
+    void SetResponse(DetectorResponse* responsePtr);
+    DetectorResponse* GetResponse() const;
+
+    int GetNVisibleFrames() const;
+    int GetNInvisibleFrames() const;
+
+    // Call once per event after the generator tree has been
+    // analyzed and the reconstruction tree cleared. Frames lost
+    // to the detector response are left out of their
+    // CombinatoricGroup, and give their RVisibleFrame a zero
+    // four-vector (see IsAccepted)
+    bool TransferEvent();
+    // whether gen_frame was reconstructed in the last event
+    bool IsAccepted(const RestFrame& gen_frame) const;
+    bool IsAccepted(const RestFrame* gen_framePtr) const;
+    // number of generator visible frames lost in the last event
+    int GetNLostFrames() const;
+
+  protected:
+    string m_Name;
+    string m_Title;
+    bool m_Init;
+    bool m_TransverseInvisible;
+    DetectorResponse* m_ResponsePtr;
+
+    vector<const RestFrame*> m_VisibleFrames;
+    vector<VisibleFrame*> m_VisibleRecoFrames;
+    vector<CombinatoricGroup*> m_VisibleGroups;
+    vector<int> m_VisibleIndex;
+
+    // each generator frame is transferred (and smeared) once,
+    // however many reconstruction inputs it is mapped to
+    vector<const RestFrame*> m_UniqueFrames;
+    vector<vector<const RestFrame*> > m_UniquePaths;
+    vector<int> m_ResponseIndex;
+    int m_ResponseVersion;
+    vector<TLorentzVector> m_UniqueP;
+    vector<bool> m_UniqueAccepted;
+
+    vector<const RestFrame*> m_InvisibleFrames;
+    vector<int> m_InvisibleGroupIndex;
+    vector<vector<const RestFrame*> > m_InvisiblePaths;
+    vector<InvisibleGroup*> m_InvisibleGroups;
+    vector<TLorentzVector> m_InvisibleSums;
+
+    bool InitializeBridge();
+    void InitializeResponseIndex();
+    bool FillPathToLabFrame(const RestFrame* framePtr, vector<const RestFrame*>& path) const;
+    TLorentzVector GetLabFrameFourVector(const RestFrame* framePtr,
+					 const vector<const RestFrame*>& path) const;
+
+  };
+
+}
+
+#endif
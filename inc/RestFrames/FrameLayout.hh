@@ -0,0 +1,192 @@
+#ifndef FrameLayout_HH
+#define FrameLayout_HH
+#include <sstream>
+#include <string>
+#include <vector>
+#include "RestFrames/RestFrame.hh"
+#include "RestFrames/RFrame.hh"
+#include "RestFrames/RVisibleFrame.hh"
+#include "RestFrames/RDecayFrame.hh"
+#include "RestFrames/RestFrameList.hh"
+#include "RestFrames/Jigsaw.hh"
+#include "RestFrames/JigsawList.hh"
+#include "RestFrames/State.hh"
+#include "RestFrames/StateList.hh"
+#include "RestFrames/Group.hh"
+#include "RestFrames/CombinatoricGroup.hh"
+
+using namespace std;
+
+namespace RestFrames {
+
+  class FramePlotNode;
+  class FramePlotLink;
+
+  enum FramePlotType { PNone, PFrame, PGroup };
+
+  ///////////////////////////////////////////////
+  // FrameLayout class
+  // lays out a tree of frames (or of a group's states) on
+  // a grid of rows, in coordinates from 0 to 1, and writes
+  // it as SVG or as a graphviz DOT graph. Uses no ROOT
+  // graphics, so trees can be exported in batch jobs without
+  // a canvas. FramePlot draws the same layout with ROOT
+  ///////////////////////////////////////////////
+  class FrameLayout {
+  public:
+    FrameLayout(const string& sname, const string& stitle);
+    virtual ~FrameLayout();
+
+    string GetName() const;
+    string GetTitle() const;
+
+    void AddFrameTree(const RestFrame* framePtr);
+    void AddFrameTree(const RFrame* framePtr, const JigsawList* jigsawsPtr);
+    void AddFrameTree(const RFrame* framePtr, Jigsaw* jigsawPtr);
+    void AddGroupTree(const Group* groupPtr);
+    void AddJigsaw(Jigsaw* jigsawPtr);
+
+    void AddFrameTree(const RestFrame& frame);
+    void AddFrameTree(const RFrame& frame, const JigsawList& jigsaws);
+    void AddFrameTree(const RFrame& frame, Jigsaw& jigsaw);
+    void AddGroupTree(const Group& group);
+    void AddJigsaw(Jigsaw& jigsaw);
+
+    // image of xpix by ypix pixels
+    string GetSVG(double xpix = 600., double ypix = 600.) const;
+    // nodes ranked by row, for graphviz's dot
+    string GetDOT() const;
+    bool WriteSVG(const string& filename, double xpix = 600., double ypix = 600.) const;
+    bool WriteDOT(const string& filename) const;
+
+  protected:
+    string m_Name;
+    string m_Title;
+    FramePlotType m_Type;
+
+    int m_Nrow;
+    vector<int> m_Ncol;
+    double m_Node_R;
+    bool m_SelfAssembling;
+
+    RestFrameList m_Frames;
+    JigsawList m_Jigsaws;
+    const Group* m_GroupPtr;
+
+    vector<FramePlotNode*> m_TreeNodes;
+    vector<FramePlotLink*> m_TreeLinks;
+    vector<FramePlotLink*> m_LeafLinks;
+
+    virtual void ClearTree();
+
+    void InitTreeGrid();
+    void ConvertNodeCoordinates(vector<FramePlotNode*>* nodesPtr);
+
+    string GetStateTitle(State* statePtr);
+    string GetSetTitle(const string& set, const string& index);
+
+    void AddFrame(RestFrame* framePtr);
+    void FillFrameTree(const RestFrame* framePtr);
+    void FillFrameTreeMap(int irow, const RestFrame* framePtr);
+    void FillFrameTreeMap(int irow, const RDecayFrame* framePtr);
+    void FillGroupTree(const Group* groupPtr);
+    void FillGroupTreeMap(int irow, State* statePtr);
+    void FillJigsawLink(Jigsaw* jigsawPtr);
+
+    // index of jigsawPtr among the added jigsaws of its type
+    int GetJigsawTypeIndex(const Jigsaw* jigsawPtr) const;
+
+    // SVG colors for frame types (line, fill) and jigsaws
+    string GetSVGColor(const RestFrame* framePtr, bool fill) const;
+    string GetSVGColor(const Jigsaw* jigsawPtr) const;
+    void WriteSVGLink(ostream& out, const FramePlotLink* linkPtr, double xpix, double ypix) const;
+    void WriteSVGNode(ostream& out, const FramePlotNode* nodePtr, bool with_rings,
+		      double xpix, double ypix) const;
+    void WriteSVGLegend(ostream& out, double xpix, double ypix) const;
+  };
+
+  ///////////////////////////////////////////////
+  // FramePlotNode class
+  ///////////////////////////////////////////////
+  class FramePlotNode {
+  public:
+    FramePlotNode();
+    ~FramePlotNode();
+
+    void SetX(double x);
+    void SetY(double y);
+    void SetFrame(const RestFrame* framePtr);
+    void AddJigsaw(Jigsaw* jigsawPtr);
+    void SetState(State* statePtr);
+    void SetLabel(const string& label);
+    void SetSquare(bool square);
+    double GetX() const;
+    double GetY() const;
+    string GetLabel() const;
+    const RestFrame* GetFrame() const;
+    int GetNJigsaws() const;
+    JigsawList* GetJigsawList() const;
+    State* GetState() const;
+    bool DoLabel() const;
+    bool DoSquare() const;
+
+  private:
+    double m_X;
+    double m_Y;
+    string m_Label;
+    bool m_DoLabel;
+    bool m_DoSquare;
+    const RestFrame* m_FramePtr;
+    JigsawList* m_JigsawsPtr;
+    State* m_StatePtr;
+    void Init();
+  };
+
+  ///////////////////////////////////////////////
+  // FramePlotLink class
+  ///////////////////////////////////////////////
+  class FramePlotLink {
+  public:
+    FramePlotLink(FramePlotNode* Node1Ptr, FramePlotNode* Node2Ptr);
+    ~FramePlotLink();
+
+    void SetLabel(const string& label);
+    void SetWavy(bool wavy);
+    void SetJigsaw(Jigsaw* jigsawPtr);
+
+    FramePlotNode* GetNode1() const;
+    FramePlotNode* GetNode2() const;
+    bool DoWavy() const;
+    string GetLabel() const;
+    bool DoLabel() const;
+    Jigsaw* GetJigsaw() const;
+
+  private:
+    FramePlotNode* m_Node1Ptr;
+    FramePlotNode* m_Node2Ptr;
+    bool m_Wavy;
+    bool m_DoLabel;
+    string m_Label;
+    Jigsaw* m_JigsawPtr;
+    void Init();
+  };
+
+  ///////////////////////////////////////////////
+  // Utility functions
+  ///////////////////////////////////////////////
+  template <typename T>
+  string NumToString ( T Num )
+  {
+    ostringstream ss;
+    ss << Num;
+    return ss.str();
+  }
+
+  // TLatex title as plain text, with sub- and superscripts
+  // (and some greek letters) as SVG tspans or DOT HTML tags
+  string LatexToSVG(const string& latex);
+  string LatexToDOT(const string& latex);
+
+}
+
+#endif
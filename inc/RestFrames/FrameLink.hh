@@ -1,6 +1,7 @@
 #ifndef FrameLink_HH
 #define FrameLink_HH
 #include <iostream>
+#include <atomic>
 #include <TLorentzVector.h>
 #include <TVector3.h>
 #include "RestFrames/RestFrame.hh"
@@ -29,8 +30,13 @@ namespace RestFrames {
  
     void SetBoostVector(const TVector3& boost);
     TVector3 GetBoostVector();
+
+    // changed whenever a link is made, changed or deleted,
+    // so copies of a tree (FrameTable) can tell it changed
+    static unsigned long long GetTreeVersion();
 	
   protected:
+    static atomic<unsigned long long> m_class_version;
     TVector3 m_B; // 3-vector of the velocity of boost
     RestFrame* m_parent_framePtr; //link to parent frame
     RestFrame* m_child_framePtr; //link to child frame
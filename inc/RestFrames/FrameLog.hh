@@ -2,6 +2,7 @@
 #define FrameLog_HH
 #include <iostream>
 #include <string>
+#include <atomic>
 #include <exception>
 #include "RestFrames/RestFrame.hh"
 #include "RestFrames/Jigsaw.hh"
@@ -15,11 +16,39 @@ namespace RestFrames {
   class Jigsaw;
   class Group;
 
+  enum LogType { LogDebug, LogInfo, LogWarning, LogError, LogNone };
+
   ///////////////////////////////////////////////
   // FrameLog class
+  // messages of the library, by type. Messages of at least the
+  // log level are printed, and every message is counted, so
+  // failures in the per-event path can be summarized
+  // (PrintSummary) rather than printed each event. Messages
+  // logged with RF_LOG are counted by the place they are logged
+  // from (a Site), and printed from there at most a number of
+  // times; those below the log level cost an atomic increment.
+  // Thread-safe.
+  //
+  // Debug messages (RF_DEBUG) are only compiled in when the
+  // library is built with -DRESTFRAMES_DEBUG
   ///////////////////////////////////////////////
   class FrameLog {
   public:
+    // a place messages are logged from (see RF_LOG), whose
+    // message is a string literal
+    class Site {
+    public:
+      Site(LogType type, const char* message);
+      LogType GetType() const { return m_Type; }
+      const char* GetMessage() const { return m_Message; }
+      long long GetCount() const { return m_N.load(memory_order_relaxed); }
+    private:
+      LogType m_Type;
+      const char* m_Message;
+      atomic<long long> m_N;
+      friend class FrameLog;
+    };
+
     FrameLog(const string& message, bool error = false);
     FrameLog(const string& message, RestFrame* frame_ptr, bool error = false);
     FrameLog(const string& message, Jigsaw* jigsaw_ptr, bool error = false);
@@ -35,38 +64,68 @@ namespace RestFrames {
       m_error = error;
     }
 
-    void SetPrint(bool print = true){
-      m_print = print;
-    }
+    static void Log(LogType type, const string& message);
+    static void Log(LogType type, const string& message, const RestFrame* frame_ptr);
+    static void Log(LogType type, const string& message, const Jigsaw* jigsaw_ptr);
+    static void Log(LogType type, const string& message, const Group* group_ptr);
+    // counts a message from site, returning its count if it is
+    // to be printed (else 0)
+    static long long Count(Site& site);
+    // prints the N-th message from site; text (if not empty) is
+    // printed instead of the site's message
+    static void Log(const Site& site, long long N, const string& text);
+    static void Log(const Site& site, long long N, const RestFrame* frame_ptr, const string& text = "");
+    static void Log(const Site& site, long long N, const Jigsaw* jigsaw_ptr, const string& text = "");
+    static void Log(const Site& site, long long N, const Group* group_ptr, const string& text = "");
 
-    void SetOutputStream(ostream* ostr) {
-      m_default_ostr = ostr;
+    // messages of at least this type are printed (default LogWarning)
+    static void SetLevel(LogType type);
+    static LogType GetLevel();
+    static bool IsPrinted(LogType type){
+      return int(type) >= m_level.load(memory_order_relaxed);
     }
-	
+
+    // messages from each site are printed at most N times (N <= 0:
+    // no limit), and then counted only (default 10)
+    static void SetMaxRepeats(int N);
+    static void SetColor(bool color = true);
+    static void SetPrint(bool print = true);
+    static void SetOutputStream(ostream* ostr);
+
+    // messages logged since the last ClearCounts
+    static long long GetCount(LogType type);
+    static void PrintSummary();
+    static void ClearCounts();
+
+    static void PrintBanner();
+
   protected:
-    string m_message;   
+    string m_message;
     bool m_error;
 
   private:
-    static bool m_print;
-    static std::ostream* m_default_ostr; 
-    void ErrorMessage();
-    void AddMessage(const string& message);
-    void PrintMessage();
-    void FrameMessage(RestFrame* frame_ptr);
-    void JigsawMessage(Jigsaw* jigsaw_ptr);
-    void GroupMessage(Group* group_ptr);
+    static atomic<int> m_level;
+    static atomic<int> m_max_repeats;
+    static atomic<bool> m_print;
+    static bool m_color;
+    static ostream* m_default_ostr;
+    static atomic<long long> m_counts[LogNone];
+
+    // count the message, returning whether to print it
+    static bool Count(LogType type);
+    static void Print(LogType type, const string& source, const string& message, long long N);
+    static string Prefix(LogType type);
   };
 
   class RestFramesException : public exception, public FrameLog {
   public:
-    RestFramesException(const string& message) : 
+    RestFramesException(const string& message) :
       FrameLog(message, true) {}
-    RestFramesException(const string& message, RestFrame* frame_ptr) : 
+    RestFramesException(const string& message, RestFrame* frame_ptr) :
       FrameLog(message, frame_ptr, true) {}
-    RestFramesException(const string& message, Jigsaw* jigsaw_ptr) : 
+    RestFramesException(const string& message, Jigsaw* jigsaw_ptr) :
       FrameLog(message, jigsaw_ptr, true) {}
-    RestFramesException(const string& message, Group* group_ptr) : 
+    RestFramesException(const string& message, Group* group_ptr) :
       FrameLog(message, group_ptr, true) {}
 
     virtual ~RestFramesException() throw() {}
@@ -74,9 +133,25 @@ namespace RestFrames {
     virtual const char* what() const throw(){
       return m_message.c_str();
     }
-	
+
   };
 
 }
 
+#ifdef RESTFRAMES_DEBUG
+#define RF_DEBUG(...) RestFrames::FrameLog::Log(RestFrames::LogDebug, __VA_ARGS__)
+#else
+#define RF_DEBUG(...) do {} while(0)
+#endif
+
+// logs message (a string literal) of type from a Site of its own,
+// with a source (RestFrame, Jigsaw or Group) and/or text to print,
+// which are only evaluated if the message is printed
+#define RF_LOG(type, message, ...) do {					\
+    static RestFrames::FrameLog::Site rf_log_site(type, message);	\
+    long long rf_log_N = RestFrames::FrameLog::Count(rf_log_site);	\
+    if(rf_log_N > 0)							\
+      RestFrames::FrameLog::Log(rf_log_site, rf_log_N, __VA_ARGS__);	\
+  } while(0)
+
 #endif
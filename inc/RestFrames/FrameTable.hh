@@ -0,0 +1,67 @@
+#ifndef FrameTable_HH
+#define FrameTable_HH
+#include <iostream>
+#include <vector>
+#include <TLorentzVector.h>
+#include <TVector3.h>
+#include "RestFrames/RestFrame.hh"
+
+using namespace std;
+
+namespace RestFrames {
+
+  class RestFrame;
+  class FrameLink;
+
+  ///////////////////////////////////////////////
+  // FrameTable class
+  // flat copy of a tree of frames, in depth-first order:
+  // parent indices, depths and links (to the parent of each
+  // frame) in contiguous arrays. Filled by the lab frame at
+  // the end of an event when the tree has changed since (see
+  // FrameLink::GetTreeVersion), it lets frames find the boosts
+  // between one another without searching the FrameLink
+  // objects of the tree; the boosts themselves are read from
+  // the links. Each frame points back to the table it is in
+  // until the table is cleared or destroyed, or the frame is
+  // destroyed
+  ///////////////////////////////////////////////
+  class FrameTable {
+  public:
+    FrameTable();
+    virtual ~FrameTable();
+
+    void Clear();
+    // (re)builds the table from the tree below labPtr
+    void Fill(RestFrame* labPtr);
+    // filled, and no link of any tree has changed since
+    bool IsFilled() const;
+
+    int GetNFrames() const;
+    RestFrame* GetFrame(int i) const;
+    // index of framePtr, or -1 if it is not in the table
+    int GetIndex(const RestFrame* framePtr) const;
+
+    // boosts V from frame i to frame j
+    void Boost(TLorentzVector& V, int i, int j) const;
+
+  protected:
+    bool m_Filled;
+    unsigned long long m_Version;
+
+    vector<RestFrame*> m_Frames;
+    vector<int> m_Parent;
+    vector<int> m_Depth;
+    vector<FrameLink*> m_Links;
+
+    void FillRecursive(RestFrame* framePtr, FrameLink* linkPtr, int parent, int depth);
+    void BoostDown(TLorentzVector& V, int j, int top) const;
+
+    // called by a frame in the table when it is destroyed
+    void RemoveFrame(RestFrame* framePtr);
+    friend class RestFrame;
+  };
+
+}
+
+#endif
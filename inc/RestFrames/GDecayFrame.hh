@@ -34,6 +34,8 @@ namespace RestFrames {
   protected:
     mutable double m_Mass;
     mutable bool m_MassSet;
+    // child masses used to calculate m_Mass
+    mutable double m_MassChildMass[2];
 
     // For two-body decays
     double m_ChildP;
@@ -41,12 +43,21 @@ namespace RestFrames {
     double m_CosDecayAngle;
     double m_DeltaPhiDecayPlane;
 
+    // two-body momentum, cached for the masses it was
+    // calculated with (constant for fixed mass decays)
+    double m_Pcm;
+    double m_PcmMass;
+    double m_PcmChildMass[2];
+
     virtual bool IsSoundBody() const;
 
     virtual void ResetFrame();
     virtual bool GenerateFrame();
 
     void ResetDecayAngles();
+    double GetTwoBodyMomentum(double M, double m0, double m1);
+    void GenerateTwoBody(double M, double m0, double m1,
+			 const TVector3& axis_par, const TVector3& axis_perp);
     double GenerateTwoBodyRecursive(double M, const vector<double>& M_children, 
 				    const TVector3& axis_par, const TVector3& axis_perp,
 				    vector<TLorentzVector>& P_children);
@@ -35,6 +35,11 @@ namespace RestFrames {
     virtual bool GenerateFrame() = 0;
 
     void SetChildren(const vector<TLorentzVector>& P_children);
+    void SetChild(int i, const TLorentzVector& P_child);
+
+    // child frames, cast again only when the tree changes
+    vector<GFrame*> m_ChildGFrames;
+    GFrame* GetChildGFrame(int i);
 
     double GetRandom();
 
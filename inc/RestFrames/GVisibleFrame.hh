@@ -26,6 +26,7 @@ namespace RestFrames {
     virtual ~GVisibleFrame();
 
     virtual void SetMass(double val);
+    virtual double GetMass() const;
 
   protected:
     double m_Mass;
@@ -3,6 +3,7 @@
 #include <iostream>
 #include <string>
 #include <vector>
+#include <unordered_map>
 #include <TLorentzVector.h>
 #include <TVector3.h>
 #include "RestFrames/Jigsaw.hh"
@@ -59,12 +60,16 @@ namespace RestFrames {
     virtual bool AddJigsaw(Jigsaw& jigsaw) = 0;
     virtual bool AddJigsaw(Jigsaw* jigsawPtr) = 0;
     JigsawList* GetJigsaws() const;
+    JigsawList* GetJigsawsToUse() const;
 
     State* GetGroupState() const;
     bool GetState(const RestFrameList* framesPtr, StateList*& statesPtr);
     State* GetState(const RestFrame* framePtr) const;
 
     virtual bool InitializeAnalysis();
+    // replays the splitting recorded by a previous InitializeAnalysis
+    // (its GetJigsaws() list, in order) instead of searching for it
+    virtual bool InitializeAnalysis(const JigsawList* split_jigsawsPtr);
     virtual void ClearEvent() = 0;
     virtual bool AnalyzeEvent() = 0;
 
@@ -88,7 +93,16 @@ namespace RestFrames {
     JigsawList* m_JigsawsPtr;
     JigsawList* m_JigsawsToUsePtr;
 
+    // by frame key: the indices in m_StatesPtr of the states
+    // holding the frame, and the jigsaws to use with it among
+    // their outputs, so that states and splits are found
+    // without scanning every state and jigsaw
+    unordered_map<int, vector<int> > m_FrameStates;
+    unordered_map<int, vector<Jigsaw*> > m_FrameJigsaws;
+
     virtual State* InitializeGroupState();
+    void InitializeStates();
+    void AddState(State* statePtr);
     bool InitializeJigsaws();
     void InitializeJigsaw(Jigsaw* jigsawPtr);
     bool SplitState(const State* statePtr);
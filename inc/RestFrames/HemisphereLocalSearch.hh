@@ -0,0 +1,315 @@
+#ifndef HemisphereLocalSearch_HH
+#define HemisphereLocalSearch_HH
+#include <iostream>
+#include <string>
+#include <vector>
+#include <TLorentzVector.h>
+#include <TVector3.h>
+#include "RestFrames/CombinatoricObjectives.hh"
+
+using namespace std;
+
+namespace RestFrames {
+
+  ///////////////////////////////////////////////
+  // HemisphereLocalSearch class
+  // approximate split of units (four-vectors) between two
+  // hemispheres, minimizing Objective::GetCost: the plane of
+  // the two hardest units in the CM frame gives the seed,
+  // which is improved by moving single units (or, when a move
+  // would break an exclusive multiplicity, swapping two)
+  // until no change lowers the cost. Each pass is O(N), or
+  // O(N^2) for swaps. See CombinatoricObjectives.hh
+  ///////////////////////////////////////////////
+  template <class Objective>
+  class HemisphereLocalSearch {
+  public:
+    HemisphereLocalSearch(const Objective& objective) : m_Objective(objective) {
+      Clear();
+    }
+    virtual ~HemisphereLocalSearch(){ }
+
+    void Clear(){
+      m_P.clear();
+      m_N.clear();
+      m_Score.clear();
+      m_Hem.clear();
+      for(int i = 0; i < 2; i++){
+	m_FixedP[i].SetPxPyPzE(0.,0.,0.,0.);
+	m_FixedN[i] = 0;
+	m_FixedScore[i] = 0.;
+	m_NMin[i] = 0;
+	m_Exclusive[i] = false;
+      }
+      m_Cost = 0.;
+      m_NEvaluations = 0;
+    }
+
+    // a unit of N elements that may go in either hemisphere
+    void AddUnit(const TLorentzVector& P, int N = 1, double score = 0.){
+      m_P.push_back(P);
+      m_N.push_back(N);
+      m_Score.push_back(score);
+      m_Hem.push_back(0);
+    }
+    // content fixed in hemisphere i
+    void AddFixed(int i, const TLorentzVector& P, int N = 1, double score = 0.){
+      if(i < 0 || i > 1) return;
+      m_FixedP[i] += P;
+      m_FixedN[i] += N;
+      m_FixedScore[i] += score;
+    }
+    // at least (or, if exclusive, exactly) N elements in hemisphere i
+    void SetMultiplicity(int i, int N, bool exclusive){
+      if(i < 0 || i > 1) return;
+      m_NMin[i] = N;
+      m_Exclusive[i] = exclusive;
+    }
+
+    // returns whether a valid split was found,
+    // within Npass_max improvement passes
+    bool Search(int Npass_max = 100){
+      m_NEvaluations = 0;
+      if(!Seed()) return false;
+      for(int pass = 0; pass < Npass_max; pass++){
+	if(MoveUnits()) continue;
+	if(!SwapUnits()) break;
+      }
+      Sum();
+      m_Cost = Evaluate(m_Hem0, m_Nhem0, m_Score0);
+      return true;
+    }
+
+    int GetNUnits() const { return m_P.size(); }
+    // hemisphere of unit u in the split found
+    int GetHemisphere(int u) const {
+      if(u < 0 || u >= GetNUnits()) return -1;
+      return m_Hem[u];
+    }
+    double GetCost() const { return m_Cost; }
+    // number of cost evaluations made by the last search
+    int GetNEvaluations() const { return m_NEvaluations; }
+
+  protected:
+    const Objective& m_Objective;
+
+    vector<TLorentzVector> m_P;
+    vector<int> m_N;
+    vector<double> m_Score;
+    vector<int> m_Hem;
+
+    TLorentzVector m_FixedP[2];
+    int m_FixedN[2];
+    double m_FixedScore[2];
+    int m_NMin[2];
+    bool m_Exclusive[2];
+
+    double m_Cost;
+    int m_NEvaluations;
+
+    // hemisphere sums of the current split
+    TLorentzVector m_Hem0[2];
+    int m_Nhem0[2];
+    double m_Score0[2];
+
+    void Sum(){
+      for(int i = 0; i < 2; i++){
+	m_Hem0[i] = m_FixedP[i];
+	m_Nhem0[i] = m_FixedN[i];
+	m_Score0[i] = m_FixedScore[i];
+      }
+      int Nunit = GetNUnits();
+      for(int u = 0; u < Nunit; u++){
+	m_Hem0[m_Hem[u]] += m_P[u];
+	m_Nhem0[m_Hem[u]] += m_N[u];
+	m_Score0[m_Hem[u]] += m_Score[u];
+      }
+    }
+
+    bool IsValid(const int* Nhem) const {
+      for(int i = 0; i < 2; i++){
+	if(m_Exclusive[i]){
+	  if(Nhem[i] != m_NMin[i]) return false;
+	} else {
+	  if(Nhem[i] < m_NMin[i]) return false;
+	}
+      }
+      return true;
+    }
+
+    double Evaluate(const TLorentzVector* hem, const int* Nhem, const double* score){
+      m_NEvaluations++;
+      TLorentzVector temp[2] = { hem[0], hem[1] };
+      return m_Objective.GetCost(temp, Nhem, score);
+    }
+
+    // cost of the current split with unit u (and unit v,
+    // if v >= 0) moved to the other hemisphere, if valid
+    bool EvaluateChange(int u, int v, double& cost){
+      TLorentzVector hem[2] = { m_Hem0[0], m_Hem0[1] };
+      int Nhem[2] = { m_Nhem0[0], m_Nhem0[1] };
+      double score[2] = { m_Score0[0], m_Score0[1] };
+      int units[2] = { u, v };
+      for(int k = 0; k < 2; k++){
+	int w = units[k];
+	if(w < 0) continue;
+	int from = m_Hem[w];
+	hem[from] -= m_P[w];
+	hem[1-from] += m_P[w];
+	Nhem[from] -= m_N[w];
+	Nhem[1-from] += m_N[w];
+	score[from] -= m_Score[w];
+	score[1-from] += m_Score[w];
+      }
+      if(!IsValid(Nhem)) return false;
+      cost = Evaluate(hem, Nhem, score);
+      return true;
+    }
+
+    void Change(int u){
+      int from = m_Hem[u];
+      m_Hem0[from] -= m_P[u];
+      m_Hem0[1-from] += m_P[u];
+      m_Nhem0[from] -= m_N[u];
+      m_Nhem0[1-from] += m_N[u];
+      m_Score0[from] -= m_Score[u];
+      m_Score0[1-from] += m_Score[u];
+      m_Hem[u] = 1-from;
+    }
+
+    // the best of the four splits by the plane of the two hardest
+    // units, repaired (if needed) to the multiplicities
+    bool Seed(){
+      int Nunit = GetNUnits();
+      TLorentzVector TOT = m_FixedP[0]+m_FixedP[1];
+      for(int u = 0; u < Nunit; u++) TOT += m_P[u];
+      TVector3 boost = TOT.BoostVector();
+      vector<TVector3> P(Nunit);
+      int hard[2] = { -1, -1 };
+      for(int u = 0; u < Nunit; u++){
+	TLorentzVector Pu = m_P[u];
+	Pu.Boost(-boost);
+	P[u] = Pu.Vect();
+	if(hard[0] < 0 || P[u].Mag() > P[hard[0]].Mag()){
+	  hard[1] = hard[0];
+	  hard[0] = u;
+	} else if(hard[1] < 0 || P[u].Mag() > P[hard[1]].Mag()){
+	  hard[1] = u;
+	}
+      }
+
+      vector<int> best;
+      double cost_best = 0.;
+      if(Nunit < 2){
+	for(int h = 0; h < 2; h++){
+	  m_Hem.assign(Nunit, h);
+	  if(!Repair()) continue;
+	  double cost = Evaluate(m_Hem0, m_Nhem0, m_Score0);
+	  if(best.empty() || cost < cost_best){
+	    best = m_Hem;
+	    cost_best = cost;
+	  }
+	}
+      } else {
+	TVector3 nRef = P[hard[0]].Cross(P[hard[1]]);
+	vector<int> plane(Nunit);
+	for(int u = 0; u < Nunit; u++) plane[u] = int(P[u].Dot(nRef) > 0.);
+	for(int j = 0; j < 4; j++){
+	  m_Hem = plane;
+	  m_Hem[hard[0]] = j%2;
+	  m_Hem[hard[1]] = j/2;
+	  if(!Repair()) continue;
+	  double cost = Evaluate(m_Hem0, m_Nhem0, m_Score0);
+	  if(best.empty() || cost < cost_best){
+	    best = m_Hem;
+	    cost_best = cost;
+	  }
+	}
+      }
+      if(best.empty()) return false;
+      m_Hem = best;
+      Sum();
+      m_Cost = cost_best;
+      return true;
+    }
+
+    // moves units, the cheapest first, from hemispheres with
+    // too many elements (exclusive) to those with too few
+    bool Repair(){
+      Sum();
+      int Nunit = GetNUnits();
+      for(int iter = 0; iter <= Nunit; iter++){
+	int to = -1;
+	for(int i = 0; i < 2; i++){
+	  if(m_Nhem0[i] < m_NMin[i]) to = i;
+	  else if(m_Exclusive[i] && m_Nhem0[i] > m_NMin[i]) to = 1-i;
+	}
+	if(to < 0) return IsValid(m_Nhem0);
+	int u_best = -1;
+	double cost_best = 0.;
+	for(int u = 0; u < Nunit; u++){
+	  if(m_Hem[u] == to) continue;
+	  Change(u);
+	  double cost = Evaluate(m_Hem0, m_Nhem0, m_Score0);
+	  Change(u);
+	  if(u_best < 0 || cost < cost_best){
+	    u_best = u;
+	    cost_best = cost;
+	  }
+	}
+	if(u_best < 0) return false;
+	Change(u_best);
+      }
+      return IsValid(m_Nhem0);
+    }
+
+    // one pass of improving single unit moves
+    bool MoveUnits(){
+      bool improved = false;
+      int Nunit = GetNUnits();
+      for(int u = 0; u < Nunit; u++){
+	double cost;
+	if(!EvaluateChange(u, -1, cost)) continue;
+	if(cost < m_Cost){
+	  Change(u);
+	  m_Cost = cost;
+	  improved = true;
+	}
+      }
+      // sums are updated incrementally, so restart from exact ones
+      if(improved) Sum();
+      return improved;
+    }
+
+    // the best improving exchange of units between hemispheres
+    bool SwapUnits(){
+      int Nunit = GetNUnits();
+      int u_best = -1;
+      int v_best = -1;
+      double cost_best = m_Cost;
+      for(int u = 0; u < Nunit; u++){
+	if(m_Hem[u] != 0) continue;
+	for(int v = 0; v < Nunit; v++){
+	  if(m_Hem[v] != 1) continue;
+	  double cost;
+	  if(!EvaluateChange(u, v, cost)) continue;
+	  if(cost < cost_best){
+	    u_best = u;
+	    v_best = v;
+	    cost_best = cost;
+	  }
+	}
+      }
+      if(u_best < 0) return false;
+      Change(u_best);
+      Change(v_best);
+      Sum();
+      m_Cost = cost_best;
+      return true;
+    }
+
+  };
+
+}
+
+#endif
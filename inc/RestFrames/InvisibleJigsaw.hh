@@ -47,11 +47,14 @@ namespace RestFrames {
     virtual double GetMinimumMass();
     virtual bool InitializeDependancyJigsaws();
     virtual void FillInvisibleMassJigsawDependancies(JigsawList* jigsaws);
+    virtual void FillReadJigsaws(JigsawList* jigsawsPtr);
 
     virtual bool InitializeJigsawExecutionList(JigsawList* chain_jigsawPtr);
 
   protected:
     virtual State* NewOutputState();
+    // child state i, or nullptr if it is not an InvisibleState
+    InvisibleState* GetChildInvisibleState(int i) const;
 
   private:
     void Init();
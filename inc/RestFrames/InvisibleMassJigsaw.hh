@@ -31,6 +31,7 @@ namespace RestFrames {
     virtual ~InvisibleMassJigsaw();
 
     virtual bool AnalyzeEvent();
+    virtual Jigsaw* NewSearchCopy(StateMap& states) const;
     
   protected:
     void Init();
@@ -32,6 +32,7 @@ namespace RestFrames {
     virtual ~InvisibleRapidityJigsaw();
 
     virtual bool AnalyzeEvent();
+    virtual Jigsaw* NewSearchCopy(StateMap& states) const;
 
   protected:
     void Init();
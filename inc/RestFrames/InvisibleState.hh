@@ -26,10 +26,16 @@ namespace RestFrames {
     InvisibleState(int ikey);
     virtual ~InvisibleState();
 
+    using State::AddFrame;
+    virtual void AddFrame(RestFrame* framePtr);
+
     virtual double GetMinimumMass();
     virtual void FillInvisibleMassJigsawDependancies(JigsawList* jigsawsPtr);
 
   protected:
+    // the frame of a single-frame state, resolved when added
+    RInvisibleFrame* m_InvisibleFramePtr;
+
     void Init();
  
   };
@@ -3,6 +3,7 @@
 #include <iostream>
 #include <string>
 #include <vector>
+#include <map>
 #include <TLorentzVector.h>
 #include <TVector3.h>
 #include "RestFrames/RestFrame.hh"
@@ -24,9 +25,13 @@ namespace RestFrames {
   class JigsawList;
   class State;
   class StateList;
+  class EventTrace;
 
   enum JigsawType { JInvisible, JCombinatoric };
 
+  // copies of states, by the state copied
+  typedef map<const State*, State*> StateMap;
+
   ///////////////////////////////////////////////
   // Jigsaw class
   ///////////////////////////////////////////////
@@ -68,14 +73,36 @@ namespace RestFrames {
     virtual State* GetChildState(int i) const;
     virtual RestFrameList* GetChildFrames(int i) const;
     virtual RestFrameList* GetChildFrames() const;
+    // frames of all the output states
+    RestFrameList* GetOutputFrames() const;
+    // frames whose states are needed with output state i
+    int GetNDependancyFrames() const;
+    RestFrameList* GetDependancyFrames(int i) const;
 
     virtual void FillGroupJigsawDependancies(JigsawList* jigsawsPtr);
     virtual void FillStateJigsawDependancies(JigsawList* jigsawsPtr);
+    // jigsaws whose outputs are read when this one is executed
+    // (including itself)
+    virtual void FillReadJigsaws(JigsawList* jigsawsPtr);
 
     virtual bool InitializeJigsawExecutionList(JigsawList* chain_jigsawPtr) = 0;
     bool DependsOnJigsaw(Jigsaw* jigsawPtr);
 
     virtual bool AnalyzeEvent() = 0;
+    // rough relative cost of AnalyzeEvent for the current event
+    virtual double GetExecutionCost() const;
+
+    // AnalyzeEvent, recorded by the event trace if one is set
+    // (see RLabFrame::SetEventTrace)
+    bool Execute();
+    void SetEventTrace(EventTrace* tracePtr);
+
+    // copy of this jigsaw for one thread of a parallel search
+    // (see CombinatoricJigsaw::SetParallelSearch), reading the
+    // copies in states of the states it reads and writing new
+    // output states, which are added to states. nullptr if the
+    // jigsaw cannot be copied
+    virtual Jigsaw* NewSearchCopy(StateMap& states) const;
   
   protected:
     static int m_class_key;
@@ -101,12 +128,18 @@ namespace RestFrames {
 
     JigsawList* m_DependancyJigsawsPtr;
 
+    EventTrace* m_TracePtr;
+
     virtual State* NewOutputState();
     void AddOutputFrame(RestFrame* framePtr, int i = 0);
     void AddOutputFrame(RestFrameList* framesPtr, int i = 0);
     void AddDependancyFrame(RestFrame* framePtr, int i = 0);
     void AddDependancyFrame(RestFrameList* framesPtr, int i = 0);
 
+    // sets up a copy of jigsaw made by NewSearchCopy
+    void CopySearchStates(const Jigsaw& jigsaw, StateMap& states);
+    static State* GetSearchState(const StateMap& states, State* statePtr);
+
   private:
     void Init(const string& sname, const string& stitle);
     int GenKey();
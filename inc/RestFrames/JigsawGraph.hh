@@ -0,0 +1,108 @@
+#ifndef JigsawGraph_HH
+#define JigsawGraph_HH
+#include <iostream>
+#include <string>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include "RestFrames/Jigsaw.hh"
+#include "RestFrames/JigsawList.hh"
+
+using namespace std;
+
+namespace RestFrames {
+
+  class Jigsaw;
+  class JigsawList;
+
+  ///////////////////////////////////////////////
+  // JigsawGraph class
+  // dependency graph of a jigsaw execution chain:
+  // jigsaw i must follow jigsaw j if one writes a
+  // state the other reads or writes. Jigsaws in the
+  // same level are independent of one another.
+  ///////////////////////////////////////////////
+  class JigsawGraph {
+  public:
+    JigsawGraph();
+    virtual ~JigsawGraph();
+
+    void Clear();
+    // builds the graph from an execution chain, as
+    // found by Jigsaw::InitializeJigsawExecutionList
+    bool Build(const JigsawList* chainPtr);
+
+    int GetNJigsaws() const;
+    Jigsaw* GetJigsaw(int i) const;
+    int GetIndex(const Jigsaw* jigsawPtr) const;
+
+    // jigsaws (by index) that must run before jigsaw i
+    int GetNDependancies(int i) const;
+    int GetDependancy(int i, int d) const;
+
+    int GetNLevels() const;
+    int GetLevel(int i) const;
+    const vector<int>& GetLevelJigsaws(int level) const;
+
+  protected:
+    vector<Jigsaw*> m_Jigsaws;
+    vector<vector<int> > m_Dependancies;
+    vector<int> m_Level;
+    vector<vector<int> > m_Levels;
+
+  };
+
+  ///////////////////////////////////////////////
+  // JigsawExecutor class
+  // runs the levels of a JigsawGraph in order, with
+  // the jigsaws of a level whose execution cost
+  // reaches a threshold shared among worker threads.
+  // The workers persist, and can also be given other
+  // tasks (Run)
+  ///////////////////////////////////////////////
+  class JigsawExecutor {
+  public:
+    // Nthread includes the calling thread
+    JigsawExecutor(int Nthread);
+    virtual ~JigsawExecutor();
+
+    int GetNThreads() const;
+    // jigsaws estimated to be cheaper (Jigsaw::GetExecutionCost)
+    // run inline in the calling thread
+    void SetCostThreshold(double cost);
+    double GetCostThreshold() const;
+
+    bool Execute(const JigsawGraph& graph);
+    // task(i) for each i in [0, Ntask), shared among the threads,
+    // returning whether all succeeded
+    bool Run(int Ntask, const function<bool(int)>& task);
+
+  protected:
+    int m_NThreads;
+    double m_CostThreshold;
+
+    vector<Jigsaw*> m_Inline;
+    vector<Jigsaw*> m_Staged;
+    vector<Jigsaw*> m_Tasks;
+    const function<bool(int)>* m_TaskPtr;
+    int m_NTasks;
+    int m_NextTask;
+    int m_NPending;
+    bool m_Failed;
+    bool m_Stop;
+
+    vector<thread> m_Workers;
+    mutex m_Mutex;
+    condition_variable m_TaskCondition;
+    condition_variable m_DoneCondition;
+
+    void WorkerLoop();
+    void RunTasks(unique_lock<mutex>& lock);
+
+  };
+
+}
+
+#endif
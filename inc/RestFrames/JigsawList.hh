@@ -34,6 +34,11 @@ namespace RestFrames {
 
   protected:
     vector<Jigsaw*> m_Jigsaws;
+
+    // sorted keys of the members, as in RestFrameList
+    vector<int> m_Keys;
+    void AddKey(int key);
+    void RemoveKey(int key);
   };
 
 }
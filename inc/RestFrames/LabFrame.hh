@@ -4,6 +4,7 @@
 #include <TLorentzVector.h>
 #include <TVector3.h>
 #include "RestFrames/RestFrame.hh"
+#include "RestFrames/FrameTable.hh"
 
 using namespace std;
 
@@ -34,6 +35,10 @@ namespace RestFrames {
   protected:
     virtual bool IsSoundBody() const;
 
+    // flat copy of the tree, refilled at the end of an
+    // event when the tree has changed
+    FrameTable m_FrameTable;
+
   private:
     void Init();
   };
@@ -10,6 +10,7 @@
 #include "RestFrames/Jigsaw.hh"
 #include "RestFrames/JigsawList.hh"
 #include "RestFrames/CombinatoricJigsaw.hh"
+#include "RestFrames/ObjectiveCombinatoricJigsaw.hh"
 #include "RestFrames/State.hh"
 #include "RestFrames/StateList.hh"
 
@@ -27,8 +28,10 @@ namespace RestFrames {
 
   ///////////////////////////////////////////////
   // MinimizeMassesCombinatoricJigsaw class
+  // uses the N^3 hemisphere search when it applies,
+  // otherwise the brute force MaximizeMomentumObjective
   ///////////////////////////////////////////////
-  class MinimizeMassesCombinatoricJigsaw : public CombinatoricJigsaw{
+  class MinimizeMassesCombinatoricJigsaw : public ObjectiveCombinatoricJigsaw<MaximizeMomentumObjective> {
   public:
     MinimizeMassesCombinatoricJigsaw(const string& sname, const string& stitle);
     MinimizeMassesCombinatoricJigsaw(const string& sname, const string& stitle, int ikey);
@@ -0,0 +1,305 @@
+#ifndef ObjectiveCombinatoricJigsaw_HH
+#define ObjectiveCombinatoricJigsaw_HH
+#include <iostream>
+#include <string>
+#include <vector>
+#include <limits>
+#include <functional>
+#include <TLorentzVector.h>
+#include <TVector3.h>
+#include "RestFrames/CombinatoricJigsaw.hh"
+#include "RestFrames/CombinatoricObjectives.hh"
+#include "RestFrames/HemisphereLocalSearch.hh"
+#include "RestFrames/FourVector.hh"
+#include "RestFrames/State.hh"
+#include "RestFrames/StateList.hh"
+
+using namespace std;
+
+namespace RestFrames {
+
+  class CombinatoricJigsaw;
+  class State;
+  class StateList;
+
+  ///////////////////////////////////////////////
+  // ObjectiveCombinatoricJigsaw class
+  // splits the elements of its input state between two
+  // outputs, trying every assignment the group's labels
+  // allow and keeping the one of smallest
+  // Objective::GetCost (the last of equal costs), within
+  // the search budget. See CombinatoricObjectives.hh
+  //
+  // Scalar is the precision of the brute force search when
+  // no jigsaw depends on the combinatoric: hemispheres are
+  // summed, and costs evaluated, in KinematicsTraits<Scalar>
+  // four-vectors (see FourVector.hh). The chosen split is
+  // set in double precision either way
+  ///////////////////////////////////////////////
+  template <class Objective, class Scalar = double>
+  class ObjectiveCombinatoricJigsaw : public CombinatoricJigsaw {
+  public:
+    typedef typename KinematicsTraits<Scalar>::Vector Vector;
+
+    ObjectiveCombinatoricJigsaw(const string& sname, const string& stitle) :
+      CombinatoricJigsaw(sname, stitle) { }
+    ObjectiveCombinatoricJigsaw(const string& sname, const string& stitle, int ikey) :
+      CombinatoricJigsaw(sname, stitle, ikey) { }
+    virtual ~ObjectiveCombinatoricJigsaw(){ }
+
+    Objective& GetObjective(){ return m_Objective; }
+    const Objective& GetObjective() const { return m_Objective; }
+
+    virtual bool AnalyzeEvent(){
+      m_Spirit = false;
+      if(!m_Mind || !m_GroupPtr) return m_Spirit;
+      if(!InitializeEvent()) return m_Spirit;
+      m_Spirit = AnalyzeCombinatorics();
+      return m_Spirit;
+    }
+
+  protected:
+    Objective m_Objective;
+
+    // 2^N brute force (over the free inputs), cut short if
+    // over time, falling back to a local search if there are
+    // too many to try or no allowed assignment was tried
+    bool AnalyzeCombinatorics(){
+      if(int(m_Outputs.size()) != 2) return false;
+      int Ninput = m_Inputs.size();
+      if(Ninput < m_NForOutput[0]+m_NForOutput[1]) return false;
+      if(m_NExclusive[0] && m_NExclusive[1])
+	if(Ninput != m_NForOutput[0]+m_NForOutput[1]) return false;
+
+      // InitializeEvent checked the group is combinatoric
+      const CombinatoricGroup* groupPtr = static_cast<const CombinatoricGroup*>(m_GroupPtr);
+      vector<TLorentzVector> inputs;
+      vector<double> scores;
+      for(int i = 0; i < Ninput; i++){
+	inputs.push_back(m_Inputs[i]->GetFourVector());
+	scores.push_back(m_Objective.GetElementScore(m_Inputs[i], groupPtr->GetLabel(m_Inputs[i])));
+      }
+
+      // jigsaws independent of the combinatoric only need to run once
+      ExecuteJigsaws(m_InvariantJigsaws);
+      if(UseLocalSearch()) return LocalSearchCombinatorics(inputs, scores);
+
+      // only assignments the group's labels allow, within the budget
+      int N_comb = GetNSearchCombinatorics();
+      if(N_comb <= 0) return LocalSearchCombinatorics(inputs, scores);
+      int Ndeps = min(int(m_DependancyStates.size()), 2);
+
+      long long c_last = -1;
+      int Nthread = 1;
+      if(N_comb >= m_MinParallelAssignments && m_SearchPoolPtr)
+	Nthread = min(m_NSearchThreads, N_comb);
+      // solutions are ordered by cost, then combinatoric, so the
+      // merged result of a shared search does not depend on the
+      // partition
+      vector<CombinatoricSolutions> solutions(Nthread, CombinatoricSolutions(m_Solutions.GetNMax()));
+      vector<int> complete(Nthread, 1);
+      if(m_SearchJigsaws.GetN() == 0){
+	// dependancy states are fixed for every combinatoric, so
+	// the search only needs the input four-vectors
+	vector<Vector> search_inputs(inputs.begin(), inputs.end());
+	vector<Vector> deps;
+	for(int i = 0; i < Ndeps; i++) deps.push_back(Vector(m_DependancyStates[i]->GetFourVector()));
+	if(Nthread == 1){
+	  SearchCombinatorics(0, N_comb, search_inputs, scores, deps, m_Solutions, complete[0]);
+	} else {
+	  function<bool(int)> task = bind(&ObjectiveCombinatoricJigsaw::SearchPartition, this,
+					  placeholders::_1, Nthread, N_comb, cref(search_inputs), cref(scores),
+					  cref(deps), ref(solutions), ref(complete));
+	  m_SearchPoolPtr->Run(Nthread, task);
+	  for(int t = 0; t < Nthread; t++) m_Solutions.Add(solutions[t]);
+	}
+	for(int t = 0; t < Nthread; t++) if(!complete[t]) m_Approximate = true;
+      } else if(Nthread > 1 && !m_TracePtr && InitializeSearchCopies()){
+	// each thread assigns its own copies of the outputs, and
+	// executes its own copies of the search jigsaws
+	function<bool(int)> task = bind(&ObjectiveCombinatoricJigsaw::SearchCopyPartition, this,
+					placeholders::_1, Nthread, N_comb, cref(inputs), cref(scores),
+					ref(solutions), ref(complete));
+	m_SearchPoolPtr->Run(Nthread, task);
+	for(int t = 0; t < Nthread; t++) m_Solutions.Add(solutions[t]);
+	for(int t = 0; t < Nthread; t++) if(!complete[t]) m_Approximate = true;
+      } else {
+	for(int k = 0; k < N_comb; k++){
+	  if(k%64 == 63 && IsOverTime()){
+	    m_Approximate = true;
+	    break;
+	  }
+	  long long c = GetCombinatoric(k);
+	  TLorentzVector hem[2];
+	  int Nhem[2];
+	  double score[2];
+	  if(!FillCombinatoric(c, inputs, scores, hem, Nhem, score)) continue;
+	  // Execute the jigsaws the dependancy states need
+	  SetCombinatoric(c);
+	  ExecuteJigsaws(m_SearchJigsaws);
+	  c_last = c;
+	  for(int i = 0; i < Ndeps; i++) hem[i] += m_DependancyStates[i]->GetFourVector();
+	  m_Solutions.Add(m_Objective.GetCost(hem, Nhem, score), c);
+	}
+      }
+      m_Solutions.Sort();
+      // too many to enumerate, or the budget ran out first
+      if(m_Solutions.GetN() <= 0) return LocalSearchCombinatorics(inputs, scores);
+      long long c_min = m_Solutions.GetCombinatoric(0);
+
+      // Set outputs to best combinatoric
+      SetCombinatoric(c_min);
+      // search jigsaws are still set from the last combinatoric tried
+      if(c_min != c_last) ExecuteJigsaws(m_SearchJigsaws);
+      ExecuteJigsaws(m_ResultJigsaws);
+      return true;
+    }
+
+    // approximate search, over the free inputs, for large
+    // numbers of inputs. Dependancy states that change with
+    // the assignment are left out of its costs
+    bool LocalSearchCombinatorics(const vector<TLorentzVector>& inputs,
+				  const vector<double>& scores){
+      HemisphereLocalSearch<Objective> search(m_Objective);
+      int Ninput = inputs.size();
+      long long free = 0;
+      int Nfree = m_FreeMasks.size();
+      for(int j = 0; j < Nfree; j++){
+	TLorentzVector P(0.,0.,0.,0.);
+	int N = 0;
+	double score = 0.;
+	for(int i = 0; i < Ninput; i++){
+	  if(!((m_FreeMasks[j] >> i) & 1)) continue;
+	  P += inputs[i];
+	  N++;
+	  score += scores[i];
+	}
+	search.AddUnit(P, N, score);
+	free |= m_FreeMasks[j];
+      }
+      for(int i = 0; i < Ninput; i++)
+	if(!((free >> i) & 1))
+	  search.AddFixed((m_FixedCombinatoric >> i) & 1, inputs[i], 1, scores[i]);
+      int Ndeps = m_SearchJigsaws.GetN() == 0 ? min(int(m_DependancyStates.size()), 2) : 0;
+      for(int i = 0; i < Ndeps; i++)
+	search.AddFixed(i, m_DependancyStates[i]->GetFourVector(), 0);
+      for(int i = 0; i < 2; i++) search.SetMultiplicity(i, m_NForOutput[i], m_NExclusive[i]);
+      if(!search.Search()) return false;
+
+      long long c = m_FixedCombinatoric;
+      for(int j = 0; j < Nfree; j++)
+	if(search.GetHemisphere(j) == 1) c |= m_FreeMasks[j];
+      m_Solutions.Add(search.GetCost(), c);
+      m_Solutions.Sort();
+      m_Approximate = true;
+      SetCombinatoric(c);
+      ExecuteJigsaws(m_SearchJigsaws);
+      ExecuteJigsaws(m_ResultJigsaws);
+      return true;
+    }
+
+    // hemisphere four-vectors, multiplicities and scores for
+    // combinatoric c, returning whether it is allowed
+    template <class V>
+    bool FillCombinatoric(long long c, const vector<V>& inputs,
+			  const vector<double>& scores,
+			  V* hem, int* Nhem, double* score) const {
+      long long key = c;
+      for(int i = 0; i < 2; i++){
+	hem[i].SetPxPyPzE(0.,0.,0.,0.);
+	Nhem[i] = 0;
+	score[i] = 0.;
+      }
+      int Ninput = inputs.size();
+      for(int i = 0; i < Ninput; i++){
+	int ihem = key%2;
+	key /= 2;
+	Nhem[ihem]++;
+	hem[ihem] += inputs[i];
+	score[ihem] += scores[i];
+      }
+      return IsValidCombinatoric(Nhem);
+    }
+
+    // partition t of Nthread of the N_comb combinatorics
+    bool SearchPartition(int t, int Nthread, int N_comb,
+			 const vector<Vector>& inputs,
+			 const vector<double>& scores,
+			 const vector<Vector>& deps,
+			 vector<CombinatoricSolutions>& solutions,
+			 vector<int>& complete) const {
+      SearchCombinatorics(int((long(N_comb)*t)/Nthread), int((long(N_comb)*(t+1))/Nthread),
+			  inputs, scores, deps, solutions[t], complete[t]);
+      return true;
+    }
+
+    // partition t of Nthread of the N_comb combinatorics, with
+    // the dependancy states given by the copies of the search
+    // jigsaws for thread t (see InitializeSearchCopies)
+    bool SearchCopyPartition(int t, int Nthread, int N_comb,
+			     const vector<TLorentzVector>& inputs,
+			     const vector<double>& scores,
+			     vector<CombinatoricSolutions>& solutions,
+			     vector<int>& complete) const {
+      const vector<Jigsaw*>& jigsaws = m_SearchCopies[t];
+      const vector<StateList*>& deps = m_DependancyCopies[t];
+      int Nj = jigsaws.size();
+      int Ndeps = deps.size();
+      int k_begin = (long(N_comb)*t)/Nthread;
+      int k_end = (long(N_comb)*(t+1))/Nthread;
+      for(int k = k_begin; k < k_end; k++){
+	if((k-k_begin)%64 == 63 && IsOverTime()){
+	  complete[t] = 0;
+	  break;
+	}
+	long long c = GetCombinatoric(k);
+	TLorentzVector hem[2];
+	int Nhem[2];
+	double score[2];
+	if(!FillCombinatoric(c, inputs, scores, hem, Nhem, score)) continue;
+	SetCombinatoric(c, m_OutputCopies[t]);
+	for(int j = 0; j < Nj; j++) jigsaws[j]->Execute();
+	for(int i = 0; i < Ndeps; i++) hem[i] += deps[i]->GetFourVector();
+	solutions[t].Add(m_Objective.GetCost(hem, Nhem, score), c);
+      }
+      return true;
+    }
+
+    // Best of combinatorics [k_begin, k_end), with complete
+    // cleared if the time budget ran out first. Touches no
+    // states, so ranges can be searched concurrently
+    void SearchCombinatorics(int k_begin, int k_end,
+			     const vector<Vector>& inputs,
+			     const vector<double>& scores,
+			     const vector<Vector>& deps,
+			     CombinatoricSolutions& solutions, int& complete) const {
+      int Ndeps = deps.size();
+      for(int k = k_begin; k < k_end; k++){
+	if((k-k_begin)%1024 == 1023 && IsOverTime()){
+	  complete = 0;
+	  return;
+	}
+	long long c = GetCombinatoric(k);
+	Vector hem[2];
+	int Nhem[2];
+	double score[2];
+	if(!FillCombinatoric(c, inputs, scores, hem, Nhem, score)) continue;
+	for(int i = 0; i < Ndeps; i++) hem[i] += deps[i];
+	solutions.Add(m_Objective.GetCost(hem, Nhem, score), c);
+      }
+    }
+
+  };
+
+  typedef ObjectiveCombinatoricJigsaw<MinimizeMassDifferenceObjective>
+  MinimizeMassDifferenceCombinatoricJigsaw;
+  typedef ObjectiveCombinatoricJigsaw<MinimizeMaxMassObjective>
+  MinimizeMaxMassCombinatoricJigsaw;
+  typedef ObjectiveCombinatoricJigsaw<MassChi2Objective>
+  MassChi2CombinatoricJigsaw;
+  typedef ObjectiveCombinatoricJigsaw<BTagObjective<MinimizeMassDifferenceObjective> >
+  BTagMassDifferenceCombinatoricJigsaw;
+
+}
+
+#endif
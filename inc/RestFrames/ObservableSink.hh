@@ -0,0 +1,126 @@
+#ifndef ObservableSink_HH
+#define ObservableSink_HH
+#include <iostream>
+#include <string>
+#include <vector>
+#include <cstdio>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <condition_variable>
+#include "RestFrames/RestFrame.hh"
+
+using namespace std;
+
+namespace RestFrames {
+
+  class RestFrame;
+
+  enum ObservableType { OValue, OMass, OCosDecayAngle, ODeltaPhiDecayAngle,
+			ODeltaPhiBoostVisible, ODeltaPhiDecayVisible, ODeltaPhiVisible,
+			OVisibleShape, OScalarVisibleMomentum };
+
+  // value of a frame observable (0 for OValue)
+  double EvaluateObservable(ObservableType type, const RestFrame& frame);
+
+  ///////////////////////////////////////////////
+  // ObservableSink class
+  // writes registered observables, one contiguous
+  // array per observable, in chunks of rows:
+  //
+  //  header:  char[8] "RFCOLUMN", uint32 version, uint32 N columns,
+  //           per column: uint32 name length, name
+  //  chunk:   uint32 N rows, uint32 (unused), per column:
+  //           uint64 N bytes, uint32 compressed, uint32 value size,
+  //           N rows values (or their ROOT/zlib compressed form)
+  //  end:     chunk with zero rows
+  //
+  // Values are doubles (version 1, where the value size is
+  // unused) or, with SetSinglePrecision, floats (version 2)
+  ///////////////////////////////////////////////
+  class ObservableSink {
+  public:
+    ObservableSink(const string& sname, const string& stitle);
+    virtual ~ObservableSink();
+
+    string GetName() const;
+    string GetTitle() const;
+
+    // Observables are registered before Open. Each returns
+    // the column index, or -1 if the column was not added
+    int AddObservable(const string& name);
+    int AddObservable(const string& name, ObservableType type, const RestFrame& frame);
+    int AddMass(const string& name, const RestFrame& frame);
+    int AddCosDecayAngle(const string& name, const RestFrame& frame);
+    int AddVisibleShape(const string& name, const RestFrame& frame);
+    int GetNObservables() const;
+
+    void SetChunkSize(int N);
+    // ROOT compression level (0 for no compression)
+    void SetCompressionLevel(int level);
+    // write chunks from a background thread
+    void SetBackgroundWriting(bool background = true);
+    // write values as floats, halving the file size
+    void SetSinglePrecision(bool single = true);
+
+    bool Open(const string& filename);
+    bool Close();
+    bool IsOpen() const;
+
+    // sets the value of an OValue column for the current row
+    void SetValue(int index, double val);
+    // evaluates the frame observables and appends the row
+    bool Fill();
+    long GetNRows() const;
+
+  protected:
+    string m_Name;
+    string m_Title;
+
+    vector<string> m_Names;
+    vector<ObservableType> m_Types;
+    vector<const RestFrame*> m_Frames;
+    vector<double> m_Values;
+
+    // frames with more than one angle column have all their
+    // angles found at once (RestFrame::GetDecayAngles) each row
+    vector<const RestFrame*> m_AngleFrames;
+    vector<DecayAngles> m_Angles;
+    vector<int> m_AngleIndex;
+    void InitializeAngles();
+    bool IsAngle(ObservableType type) const;
+
+    int m_ChunkSize;
+    int m_CompressionLevel;
+    bool m_Background;
+    bool m_SinglePrecision;
+    long m_NRows;
+
+    FILE* m_File;
+    // set by the writer thread, read by Fill
+    atomic<bool> m_WriteError;
+
+    // two column-major chunk buffers: one filled by the
+    // analysis while the other is being written out
+    vector<double> m_Buffer[2];
+    int m_BufferRows[2];
+    int m_Active;
+    vector<char> m_Compressed;
+    vector<float> m_Narrowed;
+
+    thread m_Writer;
+    mutex m_Mutex;
+    condition_variable m_Condition;
+    int m_Pending;
+    bool m_Stop;
+
+    double Evaluate(int index) const;
+    void SubmitBuffer();
+    void WriteBuffer(int ibuf);
+    void WriterLoop();
+
+  };
+
+}
+
+#endif
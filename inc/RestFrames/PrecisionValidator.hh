@@ -0,0 +1,82 @@
+#ifndef PrecisionValidator_HH
+#define PrecisionValidator_HH
+#include <iostream>
+#include <string>
+#include <vector>
+#include "RestFrames/RestFrame.hh"
+#include "RestFrames/ObservableSink.hh"
+
+using namespace std;
+
+namespace RestFrames {
+
+  class RestFrame;
+
+  ///////////////////////////////////////////////
+  // PrecisionValidator class
+  // compares observables of two copies of an analysis, one
+  // reconstructed in double and one in single precision (see
+  // FourVector.hh), event by event. The difference of each
+  // observable is |single - double| / max(|double|, 1), so
+  // relative for masses and momenta, absolute for angles
+  ///////////////////////////////////////////////
+  class PrecisionValidator {
+  public:
+    PrecisionValidator(const string& sname, const string& stitle);
+    virtual ~PrecisionValidator();
+
+    string GetName() const;
+    string GetTitle() const;
+
+    // Observables return their index, or -1 if not added.
+    // OValue observables are set each event with SetValues
+    int AddObservable(const string& name);
+    int AddObservable(const string& name, ObservableType type,
+		      const RestFrame& frame, const RestFrame& single_frame);
+    int AddMass(const string& name, const RestFrame& frame, const RestFrame& single_frame);
+    int GetNObservables() const;
+
+    // differences above tolerance count as failures
+    void SetTolerance(double tolerance);
+    double GetTolerance() const;
+
+    void SetValues(int index, double val, double single_val);
+    // evaluates the observables of both analyses for this event
+    void Fill();
+    // clears the statistics, keeping the observables
+    void Clear();
+
+    long GetNEvents() const;
+    double GetMeanDifference(int index) const;
+    double GetMaxDifference(int index) const;
+    // events over tolerance, or where only one value is finite
+    long GetNFailures(int index) const;
+    // whether no event failed for any observable
+    bool IsValid() const;
+
+    void Print() const;
+
+  protected:
+    string m_Name;
+    string m_Title;
+    double m_Tolerance;
+    long m_NEvents;
+
+    vector<string> m_Names;
+    vector<ObservableType> m_Types;
+    vector<const RestFrame*> m_Frames;
+    vector<const RestFrame*> m_SingleFrames;
+    vector<double> m_Values;
+    vector<double> m_SingleValues;
+
+    vector<double> m_SumDifference;
+    vector<double> m_MaxDifference;
+    vector<long> m_NFailures;
+
+    bool IsIndex(int index) const;
+
+  };
+
+}
+
+#endif
@@ -43,10 +43,23 @@ namespace RestFrames {
     virtual void ClearEventRecursive();
     virtual bool AnalyzeEventRecursive();
 
+    // If immutable, the states boosted into each child frame are
+    // set back to their saved four-vectors after the child is
+    // analyzed, instead of being boosted back
+    virtual void SetImmutableStates(bool immutable = true);
+    bool GetImmutableStates() const;
+
   protected:
     vector<StateList*> m_ChildStates;
     Group* m_GroupPtr;
 
+    // child frames, resolved once by InitializeStates
+    vector<RFrame*> m_ChildRFrames;
+    bool ResolveChildRFrames();
+
+    bool m_ImmutableStates;
+    vector<TLorentzVector> m_SavedFourVectors;
+
     virtual bool InitializeStatesRecursive(const StateList* statesPtr, const GroupList* groupsPtr);
     virtual bool InitializeNoGroupStates(const StateList* statesPtr);
     virtual bool InitializeGroupStates(const GroupList* groupsPtr);
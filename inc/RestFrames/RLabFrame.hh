@@ -3,6 +3,7 @@
 #include <iostream>
 #include <string>
 #include <vector>
+#include <cstdio>
 #include <TLorentzVector.h>
 #include <TVector3.h>
 #include "VisibleFrame.hh"
@@ -13,6 +14,8 @@
 #include "RestFrames/RestFrameList.hh"
 #include "RestFrames/Jigsaw.hh"
 #include "RestFrames/JigsawList.hh"
+#include "RestFrames/JigsawGraph.hh"
+#include "RestFrames/EventTrace.hh"
 #include "RestFrames/FrameLink.hh"
 #include "RestFrames/State.hh"
 #include "RestFrames/StateList.hh"
@@ -23,6 +26,7 @@ namespace RestFrames {
 
   class FrameLink;
   class Jigsaw;
+  class CombinatoricJigsaw;
   class JigsawList;
   class RestFrame;
   class RFrame;
@@ -44,15 +48,85 @@ namespace RestFrames {
     virtual bool InitializeAnalysis();
     virtual void ClearEvent();
     virtual bool AnalyzeEvent();
+    // After AnalyzeEvent, re-evaluates the tree with the outputs of
+    // a combinatoric jigsaw set to its solution i (see
+    // CombinatoricJigsaw::SetNSolutions), executing only the jigsaws
+    // that depend on it. Solution 0 restores the event's result
+    bool AnalyzeSolution(CombinatoricJigsaw& jigsaw, int i);
+
+    // Saves the outcome of InitializeAnalysis (group splittings,
+    // jigsaw execution order) so that an identical tree, built in
+    // another job, can be initialized by LoadAnalysis without
+    // repeating the jigsaw dependency resolution. LoadAnalysis
+    // rejects snapshots taken of a tree with different frames,
+    // groups or jigsaws (call InitializeAnalysis instead).
+    //
+    //  header:  char[8] "RFANALYS", uint32 version, uint32 (unused),
+    //           uint64 hash of the tree, groups and jigsaws
+    //  body:    int32 arrays (length, then entries) of jigsaw indices:
+    //           one per group (its splittings), the execution chain,
+    //           then one per chain entry (combinatoric execute list)
+    bool SaveAnalysis(const string& filename) const;
+    bool LoadAnalysis(const string& filename);
+
+    // dependency graph of the jigsaw execution chain
+    const JigsawGraph& GetJigsawGraph() const;
+    // Runs independent jigsaws of the graph concurrently on Nthread
+    // threads, if their estimated cost (Jigsaw::GetExecutionCost)
+    // reaches min_cost. Nthread <= 1 restores serial execution.
+    void SetParallelJigsaws(int Nthread, double min_cost = 1000.);
+    // Keeps the lab states fixed during AnalyzeEventRecursive,
+    // every frame of the tree restoring the states it boosts
+    // rather than boosting them back (see RFrame). Results then
+    // carry no rounding from the undoing boosts
+    virtual void SetImmutableStates(bool immutable = true);
+
+    // Records each analyzed event, its inputs and jigsaw executions,
+    // in trace (nullptr stops recording). Needs the analysis to be
+    // initialized. While recording, jigsaws are executed serially
+    bool SetEventTrace(EventTrace& trace);
+    bool SetEventTrace(EventTrace* tracePtr);
+    // Sets the inputs of a recorded event and analyzes it again
+    // (after ClearEvent). The trace must be of the same analysis.
+    // Searches with time budgets may not reproduce the recording.
+    // The event is recorded if another trace is recording, not
+    // if it is the trace replayed
+    bool ReplayEvent(const EventTrace& trace, long ievent);
+    bool ReplayEvent(const EventTrace& trace, const TraceEvent& event);
+
+    static const char* m_AnalysisMagic;
+    static const unsigned int m_AnalysisVersion;
 
   protected:
     GroupList  m_LabGroups;
     StateList  m_LabStates;
+    // the frame of each lab state, resolved by InitializeLabStates
+    vector<VisibleFrame*> m_LabStateFrames;
     JigsawList m_LabJigsaws;
+    // built on first use (BuildJigsawGraph)
+    mutable JigsawGraph m_JigsawGraph;
+    mutable bool m_GraphBuilt;
+    JigsawExecutor* m_ExecutorPtr;
+    EventTrace* m_TracePtr;
+
+    // every jigsaw of the analysis, indexed for snapshots
+    JigsawList m_AnalysisJigsaws;
+    unsigned long long m_AnalysisHash;
   
     bool InitializeLabStates();
     bool InitializeLabGroups();
     bool InitializeLabJigsaws();
+    bool InitializeLabDependancyStates();
+    void SetLabStateFourVectors();
+    bool AnalyzeLabEvent();
+    bool BuildJigsawGraph() const;
+    // trace sources: the frames of the lab states, then the groups
+    vector<string> GetTraceSources() const;
+    void TraceInputs();
+
+    unsigned long long GetAnalysisHash(JigsawList& jigsaws);
+    bool WriteIndices(FILE* file, const JigsawList* jigsawsPtr) const;
+    bool ReadIndices(FILE* file, JigsawList& jigsaws) const;
 
     
     bool ExecuteJigsaws();
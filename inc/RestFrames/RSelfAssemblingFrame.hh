@@ -9,6 +9,7 @@
 #include "RestFrames/RDecayFrame.hh"
 #include "RestFrames/RVisibleFrame.hh"
 #include "RestFrames/CombinatoricState.hh"
+#include "RestFrames/HemisphereLocalSearch.hh"
 
 using namespace std;
 
@@ -28,16 +29,27 @@ namespace RestFrames {
 
     const RestFrame* GetFrame(GroupElementID obj) const;
 
+    // splits of at least min_inputs children (if positive) use
+    // a local search instead of the N^3 hemisphere search
+    void SetLocalSearch(int min_inputs);
+    int GetLocalSearch() const;
+
   private:
     void Init();
+
+    int m_LocalSearchMin;
     
     bool m_Body_UnAssembled;
     bool m_Mind_UnAssembled; 
     RestFrameList m_ChildFrames_UnAssembled;
     vector<StateList*> m_ChildStates_UnAssembled;
+    vector<RFrame*> m_ChildRFrames_UnAssembled;
 
     RestFrameList m_VisibleFrames;
     RestFrameList m_DecayFrames;
+    // the same frames, typed when they are created
+    vector<RFrame*> m_VisibleRFrames;
+    vector<RFrame*> m_DecayRFrames;
     int m_Nvisible;
     int m_Ndecay;
 
@@ -49,6 +61,9 @@ namespace RestFrames {
     void Disassemble();
     void Assemble();
     void AssembleRecursive(RestFrame* framePtr, vector<RestFrame*>& frames, vector<TLorentzVector>& Ps); 
+    void AssembleHemispheres(vector<RestFrame*>& frames, vector<TLorentzVector>& Ps,
+			     vector<RestFrame*>* child_frames, vector<TLorentzVector>* child_Ps,
+			     TLorentzVector* child_hem);
 
     //const RestFrame* GetFrame(const State* statePtr) const;
   };
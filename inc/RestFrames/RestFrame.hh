@@ -39,6 +39,7 @@ using namespace std;
 namespace RestFrames {
 
   class FrameLink;
+  class FrameTable;
   class RestFrameList;
 
   /// Type of RestFrame, with respect to its decays
@@ -47,6 +48,21 @@ namespace RestFrames {
   /// Type of RestFrame, with respect to its analysis capabilities
   enum AnaType { FReco, FGen };
 
+  ////////////////////////////////////////////////////////////////////
+  /// \brief Standard angular observables of a frame
+  ///
+  /// Filled by RestFrame::GetDecayAngles, each member equal to the
+  /// RestFrame member function of the same name with its defaults
+  ////////////////////////////////////////////////////////////////////
+  struct DecayAngles {
+    double CosDecayAngle;
+    double DeltaPhiDecayAngle;
+    double DeltaPhiBoostVisible;
+    double DeltaPhiDecayVisible;
+    double DeltaPhiVisible;
+    TVector3 DecayPlaneNormalVector;
+  };
+
   ////////////////////////////////////////////////////////////////////
   /// \brief Base class for all *reference* *frame* objects
   ///
@@ -263,6 +279,9 @@ namespace RestFrames {
     virtual TVector3 GetDecayPlaneNormalVector() const;
     virtual double GetProdPoM(int& NDecay) const;
     virtual double GetProdSinDecayAngle(int& NDecay) const;
+    // all of the above angles at once (with the azimuthal ones about
+    // axis), finding the four-vectors they share only once
+    virtual DecayAngles GetDecayAngles(const TVector3& axis = TVector3(0.,0.,1.)) const;
 
   protected:
     static int m_class_key;     
@@ -296,6 +315,22 @@ namespace RestFrames {
     const RestFrame* m_ProdFramePtr;
 
     virtual void SetFourVector(const TLorentzVector& V, const RestFrame* framePtr);
+    // boosts V from the production frame to framePtr
+    void BoostFromProductionFrame(TLorentzVector& V, const RestFrame* framePtr) const;
+
+    // visible and invisible four-vectors of the frames below this
+    // one, in the production frame, summed bottom-up at the end of
+    // AnalyzeEventRecursive by SumDescendantFourVectors
+    TLorentzVector m_VisibleP;
+    TLorentzVector m_InvisibleP;
+    void SumDescendantFourVectors();
+
+    // table of the lab frame this frame is filled into (see
+    // FrameTable), used (if filled) instead of FindPathToFrame
+    // for boosts
+    FrameTable* m_TablePtr;
+    int m_TableIndex;
+    friend class FrameTable;
     bool FindPathToFrame(const RestFrame* framePtr, vector<FrameLink*>* linksPtr, 
 			 vector<int>* linkSignsPtr, const RestFrame* prevPtr) const;
 
@@ -19,7 +19,7 @@ namespace RestFrames {
     ~RestFrameList();
   
     void Add(RestFrame* framePtr);
-    void Add(RestFrameList* framesPtr);
+    void Add(const RestFrameList* framesPtr);
     int Remove(const RestFrame* framePtr);
     void Remove(const RestFrameList* framesPtr);
     void Clear();
@@ -39,6 +39,12 @@ namespace RestFrames {
 
   protected:
     vector<RestFrame*> m_Frames;
+
+    // sorted keys of the members, so that Add and Contains
+    // do not scan the list
+    vector<int> m_Keys;
+    void AddKey(int key);
+    void RemoveKey(int key);
   };
 
 }
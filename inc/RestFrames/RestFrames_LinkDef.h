@@ -4,6 +4,9 @@
 using namespace RestFrames;
 
 #pragma link C++ class RestFrame;
+#pragma link C++ struct DecayAngles;
+#pragma link C++ struct JigsawExecution;
+#pragma link C++ struct TraceEvent;
 #pragma link C++ class RestFrameList;
 #pragma link C++ class LabFrame;
 #pragma link C++ class DecayFrame;
@@ -26,6 +29,9 @@ using namespace RestFrames;
 #pragma link C++ enum FrameType;
 #pragma link C++ class std::vector<FrameType>;
 #pragma link C++ class FrameLink;
+#pragma link C++ class FrameTable;
+#pragma link C++ class ThreeVector<float>;
+#pragma link C++ class FourVector<float>;
 
 #pragma link C++ class Group;
 #pragma link C++ class GroupList;
@@ -42,6 +48,20 @@ using namespace RestFrames;
 #pragma link C++ class ContraBoostInvariantJigsaw;
 
 #pragma link C++ class CombinatoricJigsaw;
+#pragma link C++ class CombinatoricSolutions;
+#pragma link C++ class MaximizeMomentumObjective;
+#pragma link C++ class MinimizeMassDifferenceObjective;
+#pragma link C++ class MinimizeMaxMassObjective;
+#pragma link C++ class MassChi2Objective;
+#pragma link C++ class BTagObjective<MinimizeMassDifferenceObjective>;
+#pragma link C++ class ObjectiveCombinatoricJigsaw<MaximizeMomentumObjective>;
+#pragma link C++ class ObjectiveCombinatoricJigsaw<MinimizeMassDifferenceObjective>;
+#pragma link C++ class ObjectiveCombinatoricJigsaw<MinimizeMaxMassObjective>;
+#pragma link C++ class ObjectiveCombinatoricJigsaw<MassChi2Objective>;
+#pragma link C++ class ObjectiveCombinatoricJigsaw<BTagObjective<MinimizeMassDifferenceObjective> >;
+#pragma link C++ class ObjectiveCombinatoricJigsaw<MinimizeMassDifferenceObjective,float>;
+#pragma link C++ class ObjectiveCombinatoricJigsaw<MinimizeMaxMassObjective,float>;
+#pragma link C++ class ObjectiveCombinatoricJigsaw<MassChi2Objective,float>;
 #pragma link C++ class MinimizeMassesCombinatoricJigsaw;
 
 #pragma link C++ class State;
@@ -49,10 +69,25 @@ using namespace RestFrames;
 #pragma link C++ class InvisibleState;
 #pragma link C++ class CombinatoricState;
 
+#pragma link C++ class FrameLayout;
 #pragma link C++ class FramePlot;
 #pragma link C++ class FramePlotNode;
 #pragma link C++ class FramePlotLink;
 
+#pragma link C++ class FrameBridge;
+#pragma link C++ class DetectorResponse;
+#pragma link C++ class EventSource;
+#pragma link C++ class BinaryEventSource;
+#pragma link C++ class BinaryEventWriter;
+#pragma link C++ enum ObservableType;
+#pragma link C++ class ObservableSink;
+#pragma link C++ class PrecisionValidator;
+#pragma link C++ class EventTrace;
+#pragma link C++ class JigsawGraph;
+#pragma link C++ class JigsawExecutor;
+#pragma link C++ enum LogType;
+#pragma link C++ class FrameLog;
+
 #elif __MAKECINT__
 
 #pragma link off all typedefs;
@@ -64,6 +99,9 @@ using namespace RestFrames;
 using namespace RestFrames;
 
 #pragma link C++ class RestFrame+;
+#pragma link C++ struct DecayAngles+;
+#pragma link C++ struct JigsawExecution+;
+#pragma link C++ struct TraceEvent+;
 #pragma link C++ class RestFrameList+;
 #pragma link C++ class LabFrame+;
 #pragma link C++ class DecayFrame+;
@@ -86,6 +124,9 @@ using namespace RestFrames;
 #pragma link C++ enum FrameType+;
 #pragma link C++ class std::vector<FrameType>+;
 #pragma link C++ class FrameLink+;
+#pragma link C++ class FrameTable+;
+#pragma link C++ class ThreeVector<float>+;
+#pragma link C++ class FourVector<float>+;
 
 #pragma link C++ class Group+;
 #pragma link C++ class GroupList+;
@@ -102,6 +143,20 @@ using namespace RestFrames;
 #pragma link C++ class ContraBoostInvariantJigsaw+;
 
 #pragma link C++ class CombinatoricJigsaw+;
+#pragma link C++ class CombinatoricSolutions+;
+#pragma link C++ class MaximizeMomentumObjective+;
+#pragma link C++ class MinimizeMassDifferenceObjective+;
+#pragma link C++ class MinimizeMaxMassObjective+;
+#pragma link C++ class MassChi2Objective+;
+#pragma link C++ class BTagObjective<MinimizeMassDifferenceObjective>+;
+#pragma link C++ class ObjectiveCombinatoricJigsaw<MaximizeMomentumObjective>+;
+#pragma link C++ class ObjectiveCombinatoricJigsaw<MinimizeMassDifferenceObjective>+;
+#pragma link C++ class ObjectiveCombinatoricJigsaw<MinimizeMaxMassObjective>+;
+#pragma link C++ class ObjectiveCombinatoricJigsaw<MassChi2Objective>+;
+#pragma link C++ class ObjectiveCombinatoricJigsaw<BTagObjective<MinimizeMassDifferenceObjective> >+;
+#pragma link C++ class ObjectiveCombinatoricJigsaw<MinimizeMassDifferenceObjective,float>+;
+#pragma link C++ class ObjectiveCombinatoricJigsaw<MinimizeMaxMassObjective,float>+;
+#pragma link C++ class ObjectiveCombinatoricJigsaw<MassChi2Objective,float>+;
 #pragma link C++ class MinimizeMassesCombinatoricJigsaw+;
 
 #pragma link C++ class State+;
@@ -109,9 +164,24 @@ using namespace RestFrames;
 #pragma link C++ class InvisibleState+;
 #pragma link C++ class CombinatoricState+;
 
+#pragma link C++ class FrameLayout+;
 #pragma link C++ class FramePlot+;
 #pragma link C++ class FramePlotNode+;
 #pragma link C++ class FramePlotLink+;
 
+#pragma link C++ class FrameBridge+;
+#pragma link C++ class DetectorResponse+;
+#pragma link C++ class EventSource+;
+#pragma link C++ class BinaryEventSource+;
+#pragma link C++ class BinaryEventWriter+;
+#pragma link C++ enum ObservableType+;
+#pragma link C++ class ObservableSink+;
+#pragma link C++ class PrecisionValidator+;
+#pragma link C++ class EventTrace+;
+#pragma link C++ class JigsawGraph+;
+#pragma link C++ class JigsawExecutor+;
+#pragma link C++ enum LogType+;
+#pragma link C++ class FrameLog+;
+
 #endif /* __ROOTCLING__ and __CINT__ */
 
@@ -35,11 +35,16 @@ namespace RestFrames {
     virtual State *Copy() const;
 
     int GetKey() const { return m_Key; }
+    StateType GetType() const { return m_Type; }
+    bool IsInvisibleState() const;
+    bool IsCombinatoricState() const;
 
     virtual void AddFrame(RestFrame* framePtr);
     virtual void AddFrame(RestFrameList* framesPtr);
     void ClearFrames();
     RestFrameList* GetFrames() const;
+    // the state's own list, not a copy
+    const RestFrameList* GetFrameList() const { return &m_Frames; }
     RestFrame* GetFrame() const;
     int GetNFrames() const { return m_Frames.GetN(); }
 
@@ -55,6 +60,14 @@ namespace RestFrames {
     virtual void Boost(const TVector3& B);
     void SetFourVector(const TLorentzVector& V);
     virtual TLorentzVector GetFourVector() const; 
+    virtual double GetMass() const;
+    virtual double GetMomentum() const;
+    // incremented whenever the four-vector changes
+    unsigned long long GetVersion() const { return m_Version; }
+    // appends the four-vectors changed by Boost to Ps, and sets
+    // them back from Ps, starting at i (returns the next index)
+    virtual void SaveFourVectors(vector<TLorentzVector>& Ps) const;
+    virtual int RestoreFourVectors(const vector<TLorentzVector>& Ps, int i);
 
     virtual void FillGroupJigsawDependancies(JigsawList* jigsawsPtr) const;
     virtual void FillStateJigsawDependancies(JigsawList* jigsawsPtr) const;
@@ -68,6 +81,19 @@ namespace RestFrames {
     TLorentzVector m_P;
     RestFrameList m_Frames;
 
+    // GetFourVector, GetMass and GetMomentum. Set four-vectors are
+    // cached at once, so states written by one jigsaw can be read by
+    // several in parallel; boosted ones (only while analyzing the
+    // tree) on their first read
+    mutable TLorentzVector m_CachedP;
+    mutable double m_CachedM;
+    mutable double m_CachedPMag;
+    mutable bool m_CacheValid;
+    unsigned long long m_Version;
+    void UpdateCache();
+    void InvalidateCache();
+    void FillCache() const;
+
     Jigsaw *m_ParentJigsawPtr;
     Jigsaw *m_ChildJigsawPtr;
 
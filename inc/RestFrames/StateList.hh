@@ -36,6 +36,8 @@ namespace RestFrames {
   
     TLorentzVector GetFourVector() const;
     void Boost(const TVector3& B);
+    void SaveFourVectors(vector<TLorentzVector>& Ps) const;
+    int RestoreFourVectors(const vector<TLorentzVector>& Ps, int i);
 
   protected:
     vector<State*> m_States;
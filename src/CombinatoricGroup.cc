@@ -33,6 +33,7 @@ namespace RestFrames {
     ClearElements();
     m_NElementsForFrame.clear();
     m_NExclusiveElementsForFrame.clear(); 
+    ClearFramesForLabels();
   }
 
   void CombinatoricGroup::AddFrame(RestFrame& frame){
@@ -99,10 +100,14 @@ namespace RestFrames {
       delete m_StateElements.Get(i);
     }
     m_StateElements.Clear();
+    m_ElementFourVectors.clear();
+    m_ElementLabels.clear();
   }
 
   void CombinatoricGroup::AddElement(State* statePtr){
     m_StateElements.Add(statePtr);
+    m_ElementFourVectors.push_back(statePtr->GetFourVector());
+    m_ElementLabels.push_back("");
   }
 
   int CombinatoricGroup::GetNElements() const{
@@ -120,9 +125,16 @@ namespace RestFrames {
       return m_Spirit;
     }
     
-    CombinatoricState* group_statePtr = dynamic_cast<CombinatoricState*>(m_GroupStatePtr);
-    if(!group_statePtr) return m_Spirit;
+    if(!m_GroupStatePtr->IsCombinatoricState()) return m_Spirit;
+    CombinatoricState* group_statePtr = static_cast<CombinatoricState*>(m_GroupStatePtr);
     
+    // elements are boosted with their frames, so each analysis
+    // of the event starts from their lab frame four-vectors
+    int N = GetNElements();
+    for(int i = 0; i < N; i++)
+      m_StateElements.Get(i)->SetFourVector(m_ElementFourVectors[i]);
+    CombinatoricState::SetElementsChanged();
+
     group_statePtr->ClearElements();
     group_statePtr->AddElement(&m_StateElements);    
 
@@ -148,22 +160,95 @@ namespace RestFrames {
     if(P.M() < 0.) P.SetVectM(V.Vect(),0.);
     statePtr->SetFourVector(P);
     AddElement(statePtr);
+    m_ElementFourVectors.back() = P;
    
     return statePtr;
   }
 
+  GroupElementID CombinatoricGroup::AddLabFrameFourVector(const TLorentzVector& V, const string& label){
+    GroupElementID elementID = AddLabFrameFourVector(V);
+    m_ElementLabels[GetNElements()-1] = label;
+    return elementID;
+  }
+
+  string CombinatoricGroup::GetLabel(const GroupElementID elementID) const {
+    int index = m_StateElements.GetIndex(elementID);
+    if(index < 0) return "";
+    return m_ElementLabels[index];
+  }
+
+  void CombinatoricGroup::AddFrameForLabel(const string& label, const RestFrame& frame){
+    AddFrameForLabel(label, &frame);
+  }
+
+  void CombinatoricGroup::AddFrameForLabel(const string& label, const RestFrame* framePtr){
+    if(!framePtr) return;
+    if(label.empty()) return;
+    int iframe = m_Frames.GetIndex(framePtr);
+    if(iframe < 0) return;
+    int N = m_Labels.size();
+    int index = -1;
+    for(int i = 0; i < N; i++)
+      if(m_Labels[i] == label) index = i;
+    if(index < 0){
+      m_Labels.push_back(label);
+      m_LabelFrames.push_back(RestFrameList());
+      index = N;
+    }
+    m_LabelFrames[index].Add(m_Frames.Get(iframe));
+  }
+
+  void CombinatoricGroup::AddFrameForLabel(const string& label, const RestFrameList* framesPtr){
+    if(!framesPtr) return;
+    int N = framesPtr->GetN();
+    for(int i = 0; i < N; i++) AddFrameForLabel(label, framesPtr->Get(i));
+  }
+
+  void CombinatoricGroup::ClearFramesForLabels(){
+    m_Labels.clear();
+    m_LabelFrames.clear();
+  }
+
+  bool CombinatoricGroup::IsAllowedInFrames(const GroupElementID elementID, const RestFrameList* framesPtr) const {
+    if(!framesPtr) return false;
+    if(m_Labels.empty()) return true;
+    int index = m_StateElements.GetIndex(elementID);
+    if(index < 0) return true;
+    const string& label = m_ElementLabels[index];
+    if(label.empty()) return true;
+    int Nlabel = m_Labels.size();
+    for(int i = 0; i < Nlabel; i++){
+      if(m_Labels[i] != label) continue;
+      int N = framesPtr->GetN();
+      for(int f = 0; f < N; f++)
+	if(m_LabelFrames[i].Contains(framesPtr->Get(f))) return true;
+      return false;
+    }
+    return true;
+  }
+
   int CombinatoricGroup::GetNFourVectors() const{
     return GetNElements();
   }
 
+  TLorentzVector CombinatoricGroup::GetElementFourVector(int i) const {
+    if(i < 0 || i >= int(m_ElementFourVectors.size())) return TLorentzVector(0.,0.,0.,0.);
+    return m_ElementFourVectors[i];
+  }
+
+  string CombinatoricGroup::GetElementLabel(int i) const {
+    if(i < 0 || i >= int(m_ElementLabels.size())) return "";
+    return m_ElementLabels[i];
+  }
+
   const RestFrame* CombinatoricGroup::GetFrame(const GroupElementID elementID){
     //State* elementPtr = (State*)elementID;
     const State* elementPtr = elementID;
     int N = m_StatesPtr->GetN();
     for(int i = N-1; i >= 0; i--){
-      CombinatoricState* statePtr = dynamic_cast<CombinatoricState*>(m_StatesPtr->Get(i));
-      if(!statePtr) continue;
-      if(statePtr->ContainsElement(elementPtr)){
+      State* statePtr = m_StatesPtr->Get(i);
+      if(!statePtr->IsCombinatoricState()) continue;
+      if(static_cast<CombinatoricState*>(statePtr)->ContainsElement(elementPtr)){
 	RestFrame* framePtr = statePtr->GetFrame();
 	if(framePtr) return framePtr;
       }
@@ -176,9 +261,9 @@ namespace RestFrames {
     TLorentzVector P(0.,0.,0.,0.);
     int N = m_StatesPtr->GetN();
     for(int i = N-1; i >= 0; i--){
-      CombinatoricState* statePtr = dynamic_cast<CombinatoricState*>(m_StatesPtr->Get(i));
-      if(!statePtr) continue;
-      if(statePtr->ContainsElement(elementPtr)){
+      State* statePtr = m_StatesPtr->Get(i);
+      if(!statePtr->IsCombinatoricState()) continue;
+      if(static_cast<CombinatoricState*>(statePtr)->ContainsElement(elementPtr)){
 	P = elementPtr->GetFourVector();
 	break;
       }
@@ -192,9 +277,9 @@ namespace RestFrames {
   int CombinatoricGroup::GetNElementsInFrame(const RestFrame* framePtr){
     if(!framePtr) return -1;
     if(!ContainsFrame(framePtr)) return -1;
-    CombinatoricState* statePtr = dynamic_cast<CombinatoricState*>(GetState(framePtr));
-    if(!statePtr) return -1;
-    return statePtr->GetNElements();
+    State* statePtr = GetState(framePtr);
+    if(!statePtr || !statePtr->IsCombinatoricState()) return -1;
+    return static_cast<CombinatoricState*>(statePtr)->GetNElements();
   }
 
 }
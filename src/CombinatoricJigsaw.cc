@@ -1,9 +1,46 @@
+#include <limits>
 #include "RestFrames/CombinatoricJigsaw.hh"
 
 using namespace std;
 
 namespace RestFrames {
 
+  ///////////////////////////////////////////////
+  // CombinatoricSolutions class
+  ///////////////////////////////////////////////
+  CombinatoricSolutions::CombinatoricSolutions(int N){
+    m_NMax = max(1, N);
+  }
+
+  void CombinatoricSolutions::Clear(){
+    m_Solutions.clear();
+  }
+
+  void CombinatoricSolutions::SetNMax(int N){
+    m_NMax = max(1, N);
+    Clear();
+  }
+
+  void CombinatoricSolutions::Add(const CombinatoricSolutions& solutions){
+    int N = solutions.m_Solutions.size();
+    for(int i = 0; i < N; i++)
+      Add(solutions.m_Solutions[i].first, solutions.m_Solutions[i].second);
+  }
+
+  void CombinatoricSolutions::Sort(){
+    sort_heap(m_Solutions.begin(), m_Solutions.end(), IsBetter);
+  }
+
+  double CombinatoricSolutions::GetCost(int i) const {
+    if(i < 0 || i >= GetN()) return 0.;
+    return m_Solutions[i].first;
+  }
+
+  long long CombinatoricSolutions::GetCombinatoric(int i) const {
+    if(i < 0 || i >= GetN()) return -1;
+    return m_Solutions[i].second;
+  }
+
   ///////////////////////////////////////////////
   // CombinatoricJigsaw class
   ///////////////////////////////////////////////
@@ -21,11 +58,26 @@ namespace RestFrames {
   }
 
   CombinatoricJigsaw::~CombinatoricJigsaw(){
-    
+    ClearSearchCopies();
+    delete m_SearchPoolPtr;
   }
 
   void CombinatoricJigsaw::Init(){
     m_Type = JCombinatoric;
+    m_NSearchThreads = 1;
+    m_MinParallelAssignments = 4096;
+    m_SearchPoolPtr = nullptr;
+    m_SearchCopiesBuilt = false;
+    m_ExecuteSplit = false;
+    m_OutputsResolved = false;
+    m_Constrained = false;
+    m_FixedCombinatoric = 0;
+    m_NChosen = -1;
+    m_MaxCandidates = 0;
+    m_MaxSearchTime = 0.;
+    m_SearchDeadline = 0.;
+    m_Approximate = false;
+    m_LocalSearchMin = 0;
   }
 
   void CombinatoricJigsaw::Clear(){
@@ -71,14 +123,17 @@ namespace RestFrames {
     if(!m_Mind) return false;
     if(chain_jigsawPtr->Contains(this)) return true;
     m_ExecuteJigsaws.Clear();
+    m_ExecuteSplit = false;
+    m_OutputsResolved = false;
+    ClearSearchCopies();
 
     // Add group dependancy jigsaws first
-    JigsawList* group_jigsawsPtr = new JigsawList();
-    FillGroupJigsawDependancies(group_jigsawsPtr);
-    group_jigsawsPtr->Remove(this);
-    int Ngroup = group_jigsawsPtr->GetN();
+    JigsawList group_jigsaws;
+    FillGroupJigsawDependancies(&group_jigsaws);
+    group_jigsaws.Remove(this);
+    int Ngroup = group_jigsaws.GetN();
     for(int i = Ngroup-1; i >= 0; i--){
-      Jigsaw* jigsawPtr = group_jigsawsPtr->Get(i);
+      Jigsaw* jigsawPtr = group_jigsaws.Get(i);
       m_DependancyJigsawsPtr->Remove(jigsawPtr);
       if(!chain_jigsawPtr->Contains(jigsawPtr)){
 	if(!jigsawPtr->InitializeJigsawExecutionList(chain_jigsawPtr)){
@@ -104,58 +159,392 @@ namespace RestFrames {
 	m_DependancyJigsawsPtr->Remove(jigsawPtr);
 	continue;
       }
-      JigsawList* temp_chainPtr = chain_jigsawPtr->Copy();
-      temp_chainPtr->Add(&m_ExecuteJigsaws);
-      temp_chainPtr->Add(this);
-      if(!jigsawPtr->InitializeJigsawExecutionList(temp_chainPtr)){
+      // chains are only appended to, so what follows the
+      // original chain in temp_chain (but this) is new
+      int Nchain = chain_jigsawPtr->GetN();
+      JigsawList temp_chain = *chain_jigsawPtr;
+      temp_chain.Add(&m_ExecuteJigsaws);
+      temp_chain.Add(this);
+      if(!jigsawPtr->InitializeJigsawExecutionList(&temp_chain)){
 	m_Mind = false;
 	return false;
       }
-      temp_chainPtr->Remove(this);
-      temp_chainPtr->Remove(chain_jigsawPtr);
-      m_DependancyJigsawsPtr->Remove(temp_chainPtr);
-      m_ExecuteJigsaws.Add(temp_chainPtr);
-      
-      delete temp_chainPtr;
+      JigsawList new_jigsaws;
+      int Ntemp = temp_chain.GetN();
+      for(int i = Nchain; i < Ntemp; i++)
+	if(!temp_chain.Get(i)->IsSame(this)) new_jigsaws.Add(temp_chain.Get(i));
+      m_DependancyJigsawsPtr->Remove(&new_jigsaws);
+      m_ExecuteJigsaws.Add(&new_jigsaws);
     }
     chain_jigsawPtr->Add(this);
     chain_jigsawPtr->Add(&m_ExecuteJigsaws);
     return true;
   }
 
+  JigsawList* CombinatoricJigsaw::GetExecuteJigsaws() const {
+    return m_ExecuteJigsaws.Copy();
+  }
+
+  void CombinatoricJigsaw::SetExecuteJigsaws(const JigsawList* jigsawsPtr){
+    m_ExecuteJigsaws.Clear();
+    if(jigsawsPtr) m_ExecuteJigsaws = *jigsawsPtr;
+    m_ExecuteSplit = false;
+    m_OutputsResolved = false;
+    ClearSearchCopies();
+  }
+
+  double CombinatoricJigsaw::GetExecutionCost() const {
+    if(!m_InputStatePtr || !m_InputStatePtr->IsCombinatoricState()) return 1.;
+    CombinatoricState* input_statePtr = static_cast<CombinatoricState*>(m_InputStatePtr);
+    double Nassign = pow(double(max(1, GetNChildStates())), input_statePtr->GetNElements());
+    if(m_MaxCandidates > 0) Nassign = min(Nassign, double(m_MaxCandidates));
+    return Nassign*double(1 + m_ExecuteJigsaws.GetN());
+  }
+
+  void CombinatoricJigsaw::SetParallelSearch(int Nthread, int min_assign){
+    m_NSearchThreads = max(1, Nthread);
+    m_MinParallelAssignments = max(1, min_assign);
+    ClearSearchCopies();
+    delete m_SearchPoolPtr;
+    m_SearchPoolPtr = nullptr;
+    if(m_NSearchThreads > 1) m_SearchPoolPtr = new JigsawExecutor(m_NSearchThreads);
+  }
+
+  int CombinatoricJigsaw::GetNSearchThreads() const {
+    return m_NSearchThreads;
+  }
+
+  void CombinatoricJigsaw::SetNSolutions(int N){
+    m_Solutions.SetNMax(N);
+  }
+
+  int CombinatoricJigsaw::GetNSolutions() const {
+    return m_Solutions.GetN();
+  }
+
+  double CombinatoricJigsaw::GetSolutionCost(int i) const {
+    return m_Solutions.GetCost(i);
+  }
+
+  bool CombinatoricJigsaw::UseSolution(int i){
+    if(!m_Spirit) return false;
+    long long c = m_Solutions.GetCombinatoric(i);
+    if(c < 0) return false;
+    SetCombinatoric(c);
+    return true;
+  }
+
+  void CombinatoricJigsaw::SetSearchBudget(int max_candidates, double max_time){
+    m_MaxCandidates = max(0, max_candidates);
+    m_MaxSearchTime = max(0., max_time);
+  }
+
+  bool CombinatoricJigsaw::IsApproximate() const {
+    return m_Approximate;
+  }
+
+  void CombinatoricJigsaw::SetLocalSearch(int min_inputs){
+    m_LocalSearchMin = max(0, min_inputs);
+  }
+
+  int CombinatoricJigsaw::GetLocalSearch() const {
+    return m_LocalSearchMin;
+  }
+
+  bool CombinatoricJigsaw::UseLocalSearch() const {
+    if(m_LocalSearchMin <= 0 || m_Outputs.size() != 2) return false;
+    if(int(m_FreeMasks.size()) < m_LocalSearchMin) return false;
+    return m_SearchJigsaws.GetN() == 0;
+  }
+
+  // seconds on a monotonic clock
+  static double GetSearchClock(){
+    return chrono::duration<double>(chrono::steady_clock::now().time_since_epoch()).count();
+  }
+
+  bool CombinatoricJigsaw::IsOverTime() const {
+    if(m_MaxSearchTime <= 0.) return false;
+    return GetSearchClock() > m_SearchDeadline;
+  }
+
+  int CombinatoricJigsaw::GetNSearchCombinatorics(){
+    // largest number of free inputs within the candidate budget
+    if(m_MaxCandidates > 0 && m_Outputs.size() == 2 && !m_NExclusive[0] && !m_NExclusive[1]){
+      int Nmax = 0;
+      while(Nmax < 30 && (2 << Nmax) <= m_MaxCandidates) Nmax++;
+      MergeFreeInputs(Nmax);
+    }
+    // the first m_MaxCandidates would all put the first
+    // inputs in the same output, so none are tried
+    long long N = GetNCombinatorics();
+    if(m_MaxCandidates > 0 && N > m_MaxCandidates) return 0;
+    if(N > (1LL << 30)) return 0;
+    return N;
+  }
+
+  int CombinatoricJigsaw::GetNInputs() const {
+    return m_Inputs.size();
+  }
+
+  long long CombinatoricJigsaw::GetCurrentCombinatoric() const {
+    if(m_Outputs.size() < 2) return -1;
+    long long c = 0;
+    int Ninput = m_Inputs.size();
+    for(int i = 0; i < Ninput; i++)
+      if(m_Outputs[1]->ContainsElement(m_Inputs[i])) c |= (1LL << i);
+    return c;
+  }
+
   bool CombinatoricJigsaw::ExecuteDependancyJigsaws(){
     int N = m_ExecuteJigsaws.GetN();
     for(int i = 0; i < N; i++){
-      if(!m_ExecuteJigsaws.Get(i)->AnalyzeEvent()) return false;
+      if(!m_ExecuteJigsaws.Get(i)->Execute()) return false;
     }
     return true;
   }
 
-  bool CombinatoricJigsaw::InitializeEvent(){
-    if(!m_Mind) return false;
+  bool CombinatoricJigsaw::ExecuteJigsaws(const JigsawList& jigsaws){
+    int N = jigsaws.GetN();
+    for(int i = 0; i < N; i++){
+      if(!jigsaws.Get(i)->Execute()) return false;
+    }
+    return true;
+  }
 
-    CombinatoricState* input_statePtr = dynamic_cast<CombinatoricState*>(m_InputStatePtr);
-    if(!input_statePtr) return false;
+  void CombinatoricJigsaw::SplitExecuteJigsaws(){
+    m_InvariantJigsaws.Clear();
+    m_SearchJigsaws.Clear();
+    m_ResultJigsaws.Clear();
 
-    CombinatoricGroup* groupPtr = dynamic_cast<CombinatoricGroup*>(m_GroupPtr);
-    if(!groupPtr) return false;
+    // jigsaws that change with the combinatoric, in execution order
+    int N = m_ExecuteJigsaws.GetN();
+    vector<JigsawList> reads(N);
+    vector<bool> varies(N, false);
+    JigsawList varying;
+    varying.Add(this);
+    for(int i = 0; i < N; i++){
+      m_ExecuteJigsaws.Get(i)->FillReadJigsaws(&reads[i]);
+      reads[i].Remove(m_ExecuteJigsaws.Get(i));
+      int Nr = reads[i].GetN();
+      for(int r = 0; r < Nr && !varies[i]; r++)
+	if(varying.Contains(reads[i].Get(r))) varies[i] = true;
+      if(varies[i]) varying.Add(m_ExecuteJigsaws.Get(i));
+    }
 
-    m_Inputs.clear();
-    const StateList* elementsPtr = input_statePtr->GetElements();
-    int Ninput = elementsPtr->GetN();
+    // and those the dependancy states need
+    JigsawList needed;
+    int Ndep = m_DependancyStates.size();
+    for(int d = 0; d < Ndep; d++){
+      int M = m_DependancyStates[d]->GetN();
+      for(int j = 0; j < M; j++)
+	m_DependancyStates[d]->Get(j)->FillStateJigsawDependancies(&needed);
+    }
+    for(int i = N-1; i >= 0; i--){
+      Jigsaw* jigsawPtr = m_ExecuteJigsaws.Get(i);
+      if(!needed.Contains(jigsawPtr)) continue;
+      needed.Add(&reads[i]);
+    }
+
+    for(int i = 0; i < N; i++){
+      Jigsaw* jigsawPtr = m_ExecuteJigsaws.Get(i);
+      if(!varies[i])
+	m_InvariantJigsaws.Add(jigsawPtr);
+      else if(needed.Contains(jigsawPtr))
+	m_SearchJigsaws.Add(jigsawPtr);
+      else
+	m_ResultJigsaws.Add(jigsawPtr);
+    }
+    m_ExecuteSplit = true;
+  }
+
+  bool CombinatoricJigsaw::IsValidCombinatoric(const int* Nhem) const {
+    for(int i = 0; i < 2; i++){
+      if(m_NExclusive[i]){
+	if(Nhem[i] != m_NForOutput[i]) return false;
+      } else {
+	if(Nhem[i] < m_NForOutput[i]) return false;
+      }
+    }
+    return true;
+  }
+
+  void CombinatoricJigsaw::SetCombinatoric(long long c){
+    SetCombinatoric(c, m_Outputs);
+  }
+
+  void CombinatoricJigsaw::SetCombinatoric(long long c, const vector<CombinatoricState*>& outputs) const {
+    for(int i = 0; i < 2; i++) outputs[i]->ClearElements();
+    long long key = c;
+    int Ninput = m_Inputs.size();
     for(int i = 0; i < Ninput; i++){
-      m_Inputs.push_back(elementsPtr->Get(i));
+      int ihem = key%2;
+      key /= 2;
+      outputs[ihem]->AddElement(m_Inputs[i]);
+    }
+  }
+
+  // states not copied (the inputs, and those written before
+  // the search) are only read, and shared by every thread
+  bool CombinatoricJigsaw::InitializeSearchCopies(){
+    if(m_SearchCopiesBuilt) return !m_SearchCopies.empty();
+    m_SearchCopiesBuilt = true;
+    if(m_NSearchThreads < 2 || m_Outputs.size() != 2) return false;
+    int Nj = m_SearchJigsaws.GetN();
+    int Ndeps = min(int(m_DependancyStates.size()), 2);
+    for(int t = 0; t < m_NSearchThreads; t++){
+      StateMap states;
+      m_OutputCopies.push_back(vector<CombinatoricState*>());
+      for(int i = 0; i < 2; i++){
+	CombinatoricState* statePtr = new CombinatoricState(m_Outputs[i]->GetKey());
+	states[m_Outputs[i]] = statePtr;
+	m_OutputCopies[t].push_back(statePtr);
+      }
+
+      map<const Jigsaw*, Jigsaw*> copies;
+      m_SearchCopies.push_back(vector<Jigsaw*>());
+      for(int j = 0; j < Nj; j++){
+	Jigsaw* jigsawPtr = m_SearchJigsaws.Get(j);
+	Jigsaw* copyPtr = jigsawPtr->NewSearchCopy(states);
+	if(!copyPtr){
+	  ClearSearchCopies();
+	  m_SearchCopiesBuilt = true;
+	  return false;
+	}
+	m_SearchCopies[t].push_back(copyPtr);
+	copies[jigsawPtr] = copyPtr;
+      }
+      // minimum masses are found through the child jigsaws of states
+      for(StateMap::iterator it = states.begin(); it != states.end(); ++it){
+	map<const Jigsaw*, Jigsaw*>::iterator c = copies.find(it->second->GetChildJigsaw());
+	if(c != copies.end()) it->second->SetChildJigsaw(c->second);
+      }
+
+      m_DependancyCopies.push_back(vector<StateList*>());
+      for(int d = 0; d < Ndeps; d++){
+	StateList* statesPtr = new StateList();
+	int N = m_DependancyStates[d]->GetN();
+	for(int i = 0; i < N; i++)
+	  statesPtr->Add(GetSearchState(states, m_DependancyStates[d]->Get(i)));
+	m_DependancyCopies[t].push_back(statesPtr);
+      }
+    }
+    return true;
+  }
+
+  void CombinatoricJigsaw::ClearSearchCopies(){
+    int Nt = m_SearchCopies.size();
+    for(int t = 0; t < Nt; t++){
+      int Nj = m_SearchCopies[t].size();
+      for(int j = 0; j < Nj; j++) delete m_SearchCopies[t][j];
+    }
+    Nt = m_OutputCopies.size();
+    for(int t = 0; t < Nt; t++){
+      int No = m_OutputCopies[t].size();
+      for(int i = 0; i < No; i++) delete m_OutputCopies[t][i];
+    }
+    Nt = m_DependancyCopies.size();
+    for(int t = 0; t < Nt; t++){
+      int Nd = m_DependancyCopies[t].size();
+      for(int d = 0; d < Nd; d++) delete m_DependancyCopies[t][d];
+    }
+    m_SearchCopies.clear();
+    m_OutputCopies.clear();
+    m_DependancyCopies.clear();
+    m_SearchCopiesBuilt = false;
+  }
+
+  // n choose k, for n < 64
+  static long long GetBinomial(int n, int k){
+    static struct BinomialTable {
+      long long C[64][64];
+      BinomialTable(){
+	for(int i = 0; i < 64; i++){
+	  C[i][0] = 1;
+	  for(int j = 1; j < 64; j++)
+	    C[i][j] = (j > i) ? 0 : C[i-1][j-1] + (j < i ? C[i-1][j] : 0);
+	}
+      }
+    } table;
+    if(n < 0 || n > 63 || k < 0 || k > n) return 0;
+    return table.C[n][k];
+  }
+
+  long long CombinatoricJigsaw::GetNCombinatorics() const {
+    int Nfree = m_FreeMasks.size();
+    if(m_NChosen >= 0) return GetBinomial(Nfree, m_NChosen);
+    if(Nfree > 62) return numeric_limits<long long>::max();
+    return 1LL << Nfree;
+  }
+
+  long long CombinatoricJigsaw::GetCombinatoric(int k) const {
+    long long c = m_FixedCombinatoric;
+    int Nfree = m_FreeMasks.size();
+    if(m_NChosen >= 0){
+      // k-th choice in colexicographic order: the free inputs
+      // j_r > ... > j_1 with k = C(j_r,r) + ... + C(j_1,1)
+      long long key = k;
+      int r = m_NChosen;
+      for(int j = Nfree-1; j >= 0 && r > 0; j--){
+	long long C = GetBinomial(j, r);
+	if(C > key) continue;
+	c |= m_FreeMasks[j];
+	key -= C;
+	r--;
+      }
+      return c;
+    }
+    if(!m_Constrained) return k;
+    for(int j = 0; j < Nfree; j++)
+      if((k >> j) & 1) c |= m_FreeMasks[j];
+    return c;
+  }
+
+  // merges the softest free input (group) with the one closest
+  // in angle until Nmax are left
+  void CombinatoricJigsaw::MergeFreeInputs(int Nmax){
+    int Nfree = m_FreeMasks.size();
+    if(Nfree <= Nmax) return;
+    int Ninput = m_Inputs.size();
+    vector<TLorentzVector> P(Nfree);
+    for(int j = 0; j < Nfree; j++){
+      P[j].SetPxPyPzE(0.,0.,0.,0.);
+      for(int i = 0; i < Ninput; i++)
+	if((m_FreeMasks[j] >> i) & 1) P[j] += m_Inputs[i]->GetFourVector();
     }
+    while(Nfree > max(1, Nmax)){
+      int soft = 0;
+      for(int j = 1; j < Nfree; j++)
+	if(P[j].Pt() < P[soft].Pt()) soft = j;
+      int near = -1;
+      double angle_min = 0.;
+      for(int j = 0; j < Nfree; j++){
+	if(j == soft) continue;
+	double angle = P[j].Vect().Angle(P[soft].Vect());
+	if(near < 0 || angle < angle_min){
+	  near = j;
+	  angle_min = angle;
+	}
+      }
+      m_FreeMasks[near] |= m_FreeMasks[soft];
+      P[near] += P[soft];
+      m_FreeMasks.erase(m_FreeMasks.begin()+soft);
+      P.erase(P.begin()+soft);
+      Nfree--;
+    }
+    m_Constrained = true;
+    m_Approximate = true;
+  }
 
+  bool CombinatoricJigsaw::ResolveOutputStates(CombinatoricGroup* groupPtr){
     m_Outputs.clear();
     m_NForOutput.clear();
     m_NExclusive.clear();
     int Noutput = m_OutputStatesPtr->GetN();
     for(int i = 0; i < Noutput; i++){
-      CombinatoricState* statePtr = dynamic_cast<CombinatoricState*>(m_OutputStatesPtr->Get(i));
-      if(!statePtr) return false;
-      m_Outputs.push_back(statePtr);
-      RestFrameList* framesPtr = statePtr->GetFrames();
+      State* statePtr = m_OutputStatesPtr->Get(i);
+      if(!statePtr->IsCombinatoricState()) return false;
+      m_Outputs.push_back(static_cast<CombinatoricState*>(statePtr));
+      const RestFrameList* framesPtr = statePtr->GetFrameList();
       int Nf = framesPtr->GetN();
       int NTOT = 0;
       bool exclTOT = true;
@@ -170,6 +559,63 @@ namespace RestFrames {
       m_NForOutput.push_back(NTOT);
       m_NExclusive.push_back(exclTOT);
     }
+    m_OutputsResolved = true;
+    return true;
+  }
+
+  bool CombinatoricJigsaw::InitializeEvent(){
+    m_Solutions.Clear();
+    m_Approximate = false;
+    if(m_MaxSearchTime > 0.) m_SearchDeadline = GetSearchClock()+m_MaxSearchTime;
+    if(!m_Mind) return false;
+    if(!m_ExecuteSplit) SplitExecuteJigsaws();
+
+    if(!m_InputStatePtr || !m_InputStatePtr->IsCombinatoricState()) return false;
+    CombinatoricState* input_statePtr = static_cast<CombinatoricState*>(m_InputStatePtr);
+
+    if(!m_GroupPtr || !m_GroupPtr->IsCombinatoricGroup()) return false;
+    CombinatoricGroup* groupPtr = static_cast<CombinatoricGroup*>(m_GroupPtr);
+
+    m_Inputs.clear();
+    const StateList* elementsPtr = input_statePtr->GetElementList();
+    int Ninput = elementsPtr->GetN();
+    if(Ninput > 63) return false;
+    for(int i = 0; i < Ninput; i++){
+      m_Inputs.push_back(elementsPtr->Get(i));
+    }
+
+    if(!m_OutputsResolved && !ResolveOutputStates(groupPtr)) return false;
+    int Noutput = m_Outputs.size();
+
+    m_FixedCombinatoric = 0;
+    m_FreeMasks.clear();
+    for(int i = 0; i < Ninput; i++){
+      if(Noutput != 2){
+	m_FreeMasks.push_back(1LL << i);
+	continue;
+      }
+      bool in0 = groupPtr->IsAllowedInFrames(m_Inputs[i], m_Outputs[0]->GetFrameList());
+      bool in1 = groupPtr->IsAllowedInFrames(m_Inputs[i], m_Outputs[1]->GetFrameList());
+      if(!in0 && !in1) return false;
+      if(in0 && in1)
+	m_FreeMasks.push_back(1LL << i);
+      else if(in1)
+	m_FixedCombinatoric |= (1LL << i);
+    }
+    m_Constrained = int(m_FreeMasks.size()) < Ninput;
+
+    // with an exclusive multiplicity, the number of free
+    // inputs each output takes is fixed
+    m_NChosen = -1;
+    if(Noutput == 2 && (m_NExclusive[0] || m_NExclusive[1])){
+      int Nfree = m_FreeMasks.size();
+      int Nfixed1 = 0;
+      for(int i = 0; i < Ninput; i++)
+	if((m_FixedCombinatoric >> i) & 1) Nfixed1++;
+      int Nfixed0 = Ninput-Nfree-Nfixed1;
+      if(m_NExclusive[1]) m_NChosen = m_NForOutput[1]-Nfixed1;
+      else                m_NChosen = Nfree-(m_NForOutput[0]-Nfixed0);
+    }
 
     return true;
   }
@@ -7,6 +7,7 @@ namespace RestFrames {
   ///////////////////////////////////////////////
   // CombinatoricState class
   ///////////////////////////////////////////////
+  atomic<unsigned long long> CombinatoricState::m_ElementsEpoch(0);
 
   CombinatoricState::CombinatoricState(int ikey) : 
     State(ikey)
@@ -26,6 +27,10 @@ namespace RestFrames {
 
   void CombinatoricState::Init(){
     m_Type = SCombinatoric;
+    m_ElementsP.SetPxPyPzE(0.,0.,0.,0.);
+    m_ElementsVersion = 0;
+    m_ElementsEpochSeen = m_ElementsEpoch.load();
+    m_ElementsDirty = false;
   }
 
   void CombinatoricState::ClearElements(){
@@ -36,12 +41,22 @@ namespace RestFrames {
     }
     */
     m_Elements.Clear();
+    m_ElementsP.SetPxPyPzE(0.,0.,0.,0.);
+    m_ElementsVersion = 0;
+    m_ElementsEpochSeen = m_ElementsEpoch.load();
+    m_ElementsDirty = false;
   }
 
+  // adds to the sum in the order StateList::GetFourVector does
   void CombinatoricState::AddElement(State* statePtr){
     if(!statePtr) return;
     //m_Elements.Add(statePtr->Copy());
+    int N = m_Elements.GetN();
     m_Elements.Add(statePtr);
+    if(m_Elements.GetN() == N) return;
+    if(m_ElementsDirty) return;
+    m_ElementsP += statePtr->GetFourVector();
+    m_ElementsVersion += statePtr->GetVersion();
   }
 
   void CombinatoricState::AddElement(StateList* statesPtr){
@@ -62,15 +77,69 @@ namespace RestFrames {
     return m_Elements.Contains(statePtr);
   }
 
+  void CombinatoricState::SetElementsChanged(){
+    m_ElementsEpoch++;
+  }
+
   void CombinatoricState::Boost(const TVector3& B){
     m_Elements.Boost(B);
     m_P.Boost(B);
+    InvalidateCache();
+    m_ElementsEpoch++;
+    m_ElementsDirty = true;
+  }
+
+  void CombinatoricState::SaveFourVectors(vector<TLorentzVector>& Ps) const {
+    Ps.push_back(m_P);
+    m_Elements.SaveFourVectors(Ps);
+  }
+
+  int CombinatoricState::RestoreFourVectors(const vector<TLorentzVector>& Ps, int i){
+    m_P = Ps[i];
+    UpdateCache();
+    i = m_Elements.RestoreFourVectors(Ps, i+1);
+    m_ElementsEpoch++;
+    UpdateElementsCache();
+    return i;
+  }
+
+  void CombinatoricState::UpdateElementsCache(){
+    m_ElementsP = m_Elements.GetFourVector();
+    m_ElementsVersion = 0;
+    int N = m_Elements.GetN();
+    for(int i = 0; i < N; i++) m_ElementsVersion += m_Elements.Get(i)->GetVersion();
+    m_ElementsEpochSeen = m_ElementsEpoch.load();
+    m_ElementsDirty = false;
+  }
+
+  const TLorentzVector& CombinatoricState::GetElementsFourVector() const {
+    unsigned long long epoch = m_ElementsEpoch;
+    if(!m_ElementsDirty && m_ElementsEpochSeen == epoch) return m_ElementsP;
+    unsigned long long version = 0;
+    int N = m_Elements.GetN();
+    for(int i = 0; i < N; i++) version += m_Elements.Get(i)->GetVersion();
+    if(m_ElementsDirty || version != m_ElementsVersion){
+      m_ElementsP = m_Elements.GetFourVector();
+      m_ElementsVersion = version;
+      m_ElementsDirty = false;
+    }
+    m_ElementsEpochSeen = epoch;
+    return m_ElementsP;
   }
 
   TLorentzVector CombinatoricState::GetFourVector() const {
-    if(GetNElements() > 0) return m_Elements.GetFourVector();
-    TLorentzVector V(0.,0.,0.,0.);
-    return V;
+    if(GetNElements() <= 0) return TLorentzVector(0.,0.,0.,0.);
+    return GetElementsFourVector();
+  }
+
+  double CombinatoricState::GetMass() const {
+    if(GetNElements() <= 0) return 0.;
+    return GetElementsFourVector().M();
+  }
+
+  double CombinatoricState::GetMomentum() const {
+    if(GetNElements() <= 0) return 0.;
+    return GetElementsFourVector().P();
   }
 
 }
@@ -30,7 +30,7 @@ namespace RestFrames {
     
     int Nchild = GetNChildStates();
     for(int i = 0 ; i < Nchild; i++){
-      InvisibleState* statePtr = dynamic_cast<InvisibleState*>(GetChildState(i));
+      InvisibleState* statePtr = GetChildInvisibleState(i);
       if(statePtr) statePtr->FillInvisibleMassJigsawDependancies(jigsawsPtr);
       StateList* statesPtr = m_DependancyStates[i];
       int N = statesPtr->GetN();
@@ -42,8 +42,8 @@ namespace RestFrames {
   }
 
   double ContraBoostInvariantJigsaw::GetMinimumMass(){
-    double Minv1 = dynamic_cast<InvisibleState*>(m_OutputStatesPtr->Get(0))->GetMinimumMass();
-    double Minv2 = dynamic_cast<InvisibleState*>(m_OutputStatesPtr->Get(1))->GetMinimumMass();
+    double Minv1 = GetChildInvisibleState(0)->GetMinimumMass();
+    double Minv2 = GetChildInvisibleState(1)->GetMinimumMass();
     TLorentzVector Pvis1 = m_DependancyStates[0]->GetFourVector();
     TLorentzVector Pvis2 = m_DependancyStates[1]->GetFourVector();
     double Mvis1 = fabs(Pvis1.M());
@@ -107,9 +107,15 @@ namespace RestFrames {
     return m_Spirit;
   }
 
+  Jigsaw* ContraBoostInvariantJigsaw::NewSearchCopy(StateMap& states) const {
+    ContraBoostInvariantJigsaw* jigsawPtr = new ContraBoostInvariantJigsaw(m_Name, m_Title, m_Key);
+    jigsawPtr->CopySearchStates(*this, states);
+    return jigsawPtr;
+  }
+
   void ContraBoostInvariantJigsaw::CalcCoef(){
-    double Minv1 = dynamic_cast<InvisibleState*>(m_OutputStatesPtr->Get(0))->GetMinimumMass();
-    double Minv2 = dynamic_cast<InvisibleState*>(m_OutputStatesPtr->Get(1))->GetMinimumMass();
+    double Minv1 = GetChildInvisibleState(0)->GetMinimumMass();
+    double Minv2 = GetChildInvisibleState(1)->GetMinimumMass();
     TLorentzVector Pvis1 = m_DependancyStates[0]->GetFourVector();
     TLorentzVector Pvis2 = m_DependancyStates[1]->GetFourVector();
     double m1 = fabs(Pvis1.M());
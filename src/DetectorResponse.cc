@@ -0,0 +1,183 @@
+#include <math.h>
+#include <TRandom3.h>
+#include <TDatime.h>
+#include "RestFrames/DetectorResponse.hh"
+
+using namespace std;
+
+namespace RestFrames {
+
+  int DetectorResponse::m_class_key = 0;
+
+  ///////////////////////////////////////////////
+  // DetectorResponse class methods
+  ///////////////////////////////////////////////
+  DetectorResponse::DetectorResponse(const string& sname, const string& stitle){
+    m_Name = sname;
+    m_Title = stitle;
+    Init();
+  }
+
+  DetectorResponse::~DetectorResponse(){
+    delete m_Random;
+  }
+
+  void DetectorResponse::Init(){
+    m_Version = 0;
+    TDatime *now = new TDatime();
+    int today = now->GetDate();
+    int clock = now->GetTime();
+    delete now;
+    int seed = today+clock+m_class_key;
+    m_class_key++;
+    m_Random = new TRandom3(seed);
+
+    Clear();
+  }
+
+  void DetectorResponse::Clear(){
+    m_Frames.clear();
+    m_EnergyStochastic.clear();
+    m_EnergyConstant.clear();
+    m_EnergyNoise.clear();
+    m_SigmaEta.clear();
+    m_SigmaPhi.clear();
+    m_Efficiency.clear();
+    m_SigmaMET = 0.;
+    m_Version++;
+    // default settings: perfect response
+    AddResponseIndex(nullptr);
+  }
+
+  string DetectorResponse::GetName() const {
+    return m_Name;
+  }
+
+  string DetectorResponse::GetTitle() const {
+    return m_Title;
+  }
+
+  void DetectorResponse::SetSeed(int seed){
+    m_Random->SetSeed(seed);
+  }
+
+  int DetectorResponse::GetResponseIndex(const RestFrame* framePtr) const {
+    int N = m_Frames.size();
+    for(int i = 1; i < N; i++)
+      if(framePtr && framePtr->IsSame(m_Frames[i])) return i;
+    return 0;
+  }
+
+  int DetectorResponse::GetVersion() const {
+    return m_Version;
+  }
+
+  int DetectorResponse::AddResponseIndex(const RestFrame* framePtr){
+    int index = GetResponseIndex(framePtr);
+    if(index > 0 || (!framePtr && m_Frames.size() > 0)) return index;
+    index = m_Frames.size();
+    m_Frames.push_back(framePtr);
+    m_EnergyStochastic.push_back(index > 0 ? -1. : 0.);
+    m_EnergyConstant.push_back(index > 0 ? -1. : 0.);
+    m_EnergyNoise.push_back(index > 0 ? -1. : 0.);
+    m_SigmaEta.push_back(index > 0 ? -1. : 0.);
+    m_SigmaPhi.push_back(index > 0 ? -1. : 0.);
+    m_Efficiency.push_back(index > 0 ? -1. : 1.);
+    m_Version++;
+    return index;
+  }
+
+  double DetectorResponse::GetSetting(const vector<double>& settings, int index) const {
+    return settings[index] < 0. ? settings[0] : settings[index];
+  }
+
+  void DetectorResponse::SetEnergyResolution(double stochastic, double constant, double noise){
+    m_EnergyStochastic[0] = fabs(stochastic);
+    m_EnergyConstant[0] = fabs(constant);
+    m_EnergyNoise[0] = fabs(noise);
+  }
+
+  void DetectorResponse::SetEnergyResolution(const RestFrame& frame, double stochastic,
+					     double constant, double noise){
+    int index = AddResponseIndex(&frame);
+    m_EnergyStochastic[index] = fabs(stochastic);
+    m_EnergyConstant[index] = fabs(constant);
+    m_EnergyNoise[index] = fabs(noise);
+  }
+
+  void DetectorResponse::SetAngularResolution(double sigma_eta, double sigma_phi){
+    m_SigmaEta[0] = fabs(sigma_eta);
+    m_SigmaPhi[0] = fabs(sigma_phi);
+  }
+
+  void DetectorResponse::SetAngularResolution(const RestFrame& frame, double sigma_eta, double sigma_phi){
+    int index = AddResponseIndex(&frame);
+    m_SigmaEta[index] = fabs(sigma_eta);
+    m_SigmaPhi[index] = fabs(sigma_phi);
+  }
+
+  void DetectorResponse::SetEfficiency(double eff){
+    m_Efficiency[0] = min(1.,max(0.,eff));
+  }
+
+  void DetectorResponse::SetEfficiency(const RestFrame& frame, double eff){
+    int index = AddResponseIndex(&frame);
+    m_Efficiency[index] = min(1.,max(0.,eff));
+  }
+
+  void DetectorResponse::SetMissingMomentumResolution(double sigma){
+    m_SigmaMET = fabs(sigma);
+  }
+
+  bool DetectorResponse::SmearObject(int index, TLorentzVector& P){
+    if(index < 0 || index >= int(m_Frames.size())) index = 0;
+
+    double eff = GetSetting(m_Efficiency, index);
+    if(eff < 1.)
+      if(m_Random->Rndm() >= eff) return false;
+
+    double E = P.E();
+    double a = GetSetting(m_EnergyStochastic, index);
+    double b = GetSetting(m_EnergyConstant, index);
+    double c = GetSetting(m_EnergyNoise, index);
+    if(E > 0. && (a > 0. || b > 0. || c > 0.)){
+      double sigma = sqrt(a*a/E + b*b + c*c/(E*E));
+      double scale = 1. + sigma*m_Random->Gaus(0.,1.);
+      if(scale < 0.) scale = 0.;
+      P *= scale;
+    }
+
+    double sigma_eta = GetSetting(m_SigmaEta, index);
+    double sigma_phi = GetSetting(m_SigmaPhi, index);
+    if(P.Pt() > 0. && (sigma_eta > 0. || sigma_phi > 0.)){
+      double eta = P.Eta();
+      double phi = P.Phi();
+      if(sigma_eta > 0.) eta += m_Random->Gaus(0.,sigma_eta);
+      if(sigma_phi > 0.) phi += m_Random->Gaus(0.,sigma_phi);
+      P.SetPtEtaPhiM(P.Pt(), eta, phi, max(0.,P.M()));
+    }
+    return true;
+  }
+
+  void DetectorResponse::SmearEvent(const vector<int>& index, vector<TLorentzVector>& P,
+				    vector<bool>& accepted, TVector3& dMET){
+    int N = P.size();
+    accepted.resize(N);
+    for(int i = 0; i < N; i++){
+      double px = P[i].Px();
+      double py = P[i].Py();
+      accepted[i] = SmearObject(index[i], P[i]);
+      if(accepted[i]){
+	px -= P[i].Px();
+	py -= P[i].Py();
+      }
+      dMET.SetX(dMET.X()+px);
+      dMET.SetY(dMET.Y()+py);
+    }
+    if(m_SigmaMET > 0.){
+      dMET.SetX(dMET.X()+m_Random->Gaus(0.,m_SigmaMET));
+      dMET.SetY(dMET.Y()+m_Random->Gaus(0.,m_SigmaMET));
+    }
+  }
+
+}
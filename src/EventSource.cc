@@ -0,0 +1,315 @@
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "RestFrames/EventSource.hh"
+#include "RestFrames/CombinatoricGroup.hh"
+#include "RestFrames/InvisibleGroup.hh"
+#include "RestFrames/FrameLog.hh"
+
+using namespace std;
+
+namespace RestFrames {
+
+  ///////////////////////////////////////////////
+  // EventSource class methods
+  ///////////////////////////////////////////////
+  EventSource::EventSource(const string& sname, const string& stitle){
+    m_Name = sname;
+    m_Title = stitle;
+    m_CurrentEvent = -1;
+  }
+
+  EventSource::~EventSource(){ }
+
+  string EventSource::GetName() const {
+    return m_Name;
+  }
+
+  string EventSource::GetTitle() const {
+    return m_Title;
+  }
+
+  long EventSource::GetCurrentEvent() const {
+    return m_CurrentEvent;
+  }
+
+  bool EventSource::NextEvent(){
+    if(m_CurrentEvent+1 >= GetNEvents()) return false;
+    return ReadEvent(m_CurrentEvent+1);
+  }
+
+  TLorentzVector EventSource::GetVisibleFourVector(int i) const {
+    TLorentzVector V(0.,0.,0.,0.);
+    const double* P = GetVisibleData(i);
+    if(P) V.SetPxPyPzE(P[0],P[1],P[2],P[3]);
+    return V;
+  }
+
+  bool EventSource::TransferEvent(CombinatoricGroup& group, InvisibleGroup& inv_group) const {
+    return TransferEvent(&group, &inv_group);
+  }
+
+  bool EventSource::TransferEvent(CombinatoricGroup* groupPtr, InvisibleGroup* inv_groupPtr) const {
+    if(m_CurrentEvent < 0) return false;
+    if(groupPtr){
+      int N = GetNVisible();
+      for(int i = 0; i < N; i++){
+	const double* P = GetVisibleData(i);
+	groupPtr->AddLabFrameFourVector(TLorentzVector(P[0],P[1],P[2],P[3]));
+      }
+    }
+    if(inv_groupPtr) inv_groupPtr->SetLabFrameThreeVector(GetMET());
+    return true;
+  }
+
+  ///////////////////////////////////////////////
+  // BinaryEventSource class methods
+  ///////////////////////////////////////////////
+  const char* BinaryEventSource::m_Magic = "RFEVENTS";
+  const unsigned int BinaryEventSource::m_Version = 1;
+
+  BinaryEventSource::BinaryEventSource(const string& sname, const string& stitle) :
+    EventSource(sname, stitle)
+  {
+    m_File = -1;
+    m_Map = nullptr;
+    m_MapSize = 0;
+    m_NEvents = 0;
+    m_Index = nullptr;
+    m_BlockSize = 1024;
+    m_CurrentBlock = -1;
+    m_NVisible = 0;
+    m_METData = nullptr;
+    m_VisibleData = nullptr;
+  }
+
+  BinaryEventSource::~BinaryEventSource(){
+    Close();
+  }
+
+  bool BinaryEventSource::Open(const string& filename){
+    Close();
+
+    m_File = ::open(filename.c_str(), O_RDONLY);
+    if(m_File < 0){
+      RF_LOG(LogError, "unable to open", "BinaryEventSource " + m_Name + ": unable to open " + filename);
+      return false;
+    }
+    struct stat st;
+    if(fstat(m_File, &st) != 0 || st.st_size < 32){
+      RF_LOG(LogError, "not an event file", "BinaryEventSource " + m_Name + ": " + filename + " is not an event file");
+      Close();
+      return false;
+    }
+    m_MapSize = st.st_size;
+    void* map = mmap(nullptr, m_MapSize, PROT_READ, MAP_PRIVATE, m_File, 0);
+    if(map == MAP_FAILED){
+      RF_LOG(LogError, "unable to map", "BinaryEventSource " + m_Name + ": unable to map " + filename);
+      m_MapSize = 0;
+      Close();
+      return false;
+    }
+    m_Map = (char*)map;
+    madvise(m_Map, m_MapSize, MADV_SEQUENTIAL);
+
+    unsigned int version;
+    unsigned long long Nevent, index_offset;
+    memcpy(&version, m_Map+8, sizeof(version));
+    memcpy(&Nevent, m_Map+16, sizeof(Nevent));
+    memcpy(&index_offset, m_Map+24, sizeof(index_offset));
+    // the index, and every event offset in it, must lie within the
+    // file: events between the header and the index, in order
+    bool valid = memcmp(m_Map, m_Magic, 8) == 0 && version == m_Version &&
+      index_offset % 8 == 0 && index_offset >= 32 && index_offset <= m_MapSize &&
+      Nevent <= (m_MapSize-index_offset)/8;
+    if(valid){
+      const unsigned long long* index = (const unsigned long long*)(m_Map+index_offset);
+      unsigned long long previous = 32;
+      for(unsigned long long i = 0; i < Nevent && valid; i++){
+	unsigned long long offset = index[i];
+	valid = offset % 8 == 0 && offset >= previous && offset <= index_offset - 32;
+	previous = offset + 32;
+      }
+    }
+    if(!valid){
+      RF_LOG(LogError, "not a valid event file", "BinaryEventSource " + m_Name + ": " + filename + " is not a valid event file");
+      Close();
+      return false;
+    }
+    m_NEvents = Nevent;
+    m_Index = (const unsigned long long*)(m_Map+index_offset);
+    m_CurrentEvent = -1;
+    m_CurrentBlock = -1;
+    return true;
+  }
+
+  void BinaryEventSource::Close(){
+    if(m_Map) munmap(m_Map, m_MapSize);
+    if(m_File >= 0) ::close(m_File);
+    m_File = -1;
+    m_Map = nullptr;
+    m_MapSize = 0;
+    m_NEvents = 0;
+    m_Index = nullptr;
+    m_CurrentEvent = -1;
+    m_CurrentBlock = -1;
+    m_NVisible = 0;
+    m_METData = nullptr;
+    m_VisibleData = nullptr;
+  }
+
+  bool BinaryEventSource::IsOpen() const {
+    return m_Map != nullptr;
+  }
+
+  void BinaryEventSource::SetBlockSize(long N){
+    if(N > 0) m_BlockSize = N;
+  }
+
+  long BinaryEventSource::GetNEvents() const {
+    return m_NEvents;
+  }
+
+  // Asks the kernel to page in the events of the next block
+  // while the current one is being analyzed
+  void BinaryEventSource::ReadAhead(long block){
+    long first = block*m_BlockSize;
+    if(first >= m_NEvents) return;
+    long last = min(m_NEvents, first+m_BlockSize);
+    size_t begin = m_Index[first];
+    size_t end = last < m_NEvents ? size_t(m_Index[last]) : size_t((const char*)m_Index - m_Map);
+    if(end <= begin) return;
+    size_t page = sysconf(_SC_PAGESIZE);
+    size_t start = begin - begin%page;
+    madvise(m_Map+start, end-start, MADV_WILLNEED);
+  }
+
+  bool BinaryEventSource::ReadEvent(long ievent){
+    if(!m_Map || ievent < 0 || ievent >= m_NEvents) return false;
+
+    long block = ievent/m_BlockSize;
+    if(block != m_CurrentBlock){
+      if(m_CurrentBlock < 0) ReadAhead(block);
+      ReadAhead(block+1);
+      m_CurrentBlock = block;
+    }
+
+    // offsets were checked by Open: the event must also end
+    // before the next one
+    size_t offset = m_Index[ievent];
+    size_t end = ievent+1 < m_NEvents ? size_t(m_Index[ievent+1]) : size_t((const char*)m_Index - m_Map);
+    unsigned int N;
+    memcpy(&N, m_Map+offset, sizeof(N));
+    if(size_t(N) > (end - offset - 32)/32) return false;
+
+    m_NVisible = N;
+    m_METData = (const double*)(m_Map+offset+8);
+    m_VisibleData = (const double*)(m_Map+offset+32);
+    m_CurrentEvent = ievent;
+    return true;
+  }
+
+  int BinaryEventSource::GetNVisible() const {
+    return m_NVisible;
+  }
+
+  const double* BinaryEventSource::GetVisibleData(int i) const {
+    if(i < 0 || i >= m_NVisible) return nullptr;
+    return m_VisibleData+4*i;
+  }
+
+  TVector3 BinaryEventSource::GetMET() const {
+    if(!m_METData) return TVector3(0.,0.,0.);
+    return TVector3(m_METData[0],m_METData[1],m_METData[2]);
+  }
+
+  ///////////////////////////////////////////////
+  // BinaryEventWriter class methods
+  ///////////////////////////////////////////////
+  BinaryEventWriter::BinaryEventWriter(const string& sname, const string& stitle){
+    m_Name = sname;
+    m_Title = stitle;
+    m_File = nullptr;
+    m_Offset = 0;
+  }
+
+  BinaryEventWriter::~BinaryEventWriter(){
+    Close();
+  }
+
+  string BinaryEventWriter::GetName() const {
+    return m_Name;
+  }
+
+  string BinaryEventWriter::GetTitle() const {
+    return m_Title;
+  }
+
+  bool BinaryEventWriter::Open(const string& filename){
+    Close();
+    m_File = fopen(filename.c_str(), "wb");
+    if(!m_File){
+      RF_LOG(LogError, "unable to open", "BinaryEventWriter " + m_Name + ": unable to open " + filename);
+      return false;
+    }
+    m_Index.clear();
+    // header is completed when the file is closed
+    char header[32];
+    memset(header, 0, 32);
+    memcpy(header, BinaryEventSource::m_Magic, 8);
+    memcpy(header+8, &BinaryEventSource::m_Version, sizeof(unsigned int));
+    fwrite(header, 1, 32, m_File);
+    m_Offset = 32;
+    return true;
+  }
+
+  bool BinaryEventWriter::IsOpen() const {
+    return m_File != nullptr;
+  }
+
+  long BinaryEventWriter::GetNEvents() const {
+    return m_Index.size();
+  }
+
+  bool BinaryEventWriter::WriteEvent(const vector<TLorentzVector>& P_visible, const TVector3& MET){
+    if(!m_File) return false;
+    unsigned int N = P_visible.size();
+    m_Buffer.resize(4+4*N);
+    unsigned int head[2] = {N, 0};
+    memcpy(&m_Buffer[0], head, 8);
+    m_Buffer[1] = MET.X();
+    m_Buffer[2] = MET.Y();
+    m_Buffer[3] = MET.Z();
+    for(unsigned int i = 0; i < N; i++){
+      m_Buffer[4+4*i] = P_visible[i].Px();
+      m_Buffer[5+4*i] = P_visible[i].Py();
+      m_Buffer[6+4*i] = P_visible[i].Pz();
+      m_Buffer[7+4*i] = P_visible[i].E();
+    }
+    size_t size = 8*m_Buffer.size();
+    if(fwrite(&m_Buffer[0], 1, size, m_File) != size) return false;
+    m_Index.push_back(m_Offset);
+    m_Offset += size;
+    return true;
+  }
+
+  bool BinaryEventWriter::Close(){
+    if(!m_File) return false;
+    unsigned long long Nevent = m_Index.size();
+    unsigned long long index_offset = m_Offset;
+    bool ok = true;
+    if(Nevent > 0)
+      ok = fwrite(&m_Index[0], sizeof(unsigned long long), Nevent, m_File) == Nevent;
+    fseek(m_File, 16, SEEK_SET);
+    ok = ok && fwrite(&Nevent, sizeof(Nevent), 1, m_File) == 1;
+    ok = ok && fwrite(&index_offset, sizeof(index_offset), 1, m_File) == 1;
+    ok = (fclose(m_File) == 0) && ok;
+    m_File = nullptr;
+    m_Index.clear();
+    m_Offset = 0;
+    return ok;
+  }
+
+}
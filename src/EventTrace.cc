@@ -0,0 +1,403 @@
+#include <cstring>
+#include "RestFrames/EventTrace.hh"
+#include "RestFrames/CombinatoricJigsaw.hh"
+#include "RestFrames/FrameLog.hh"
+
+using namespace std;
+
+namespace RestFrames {
+
+  ///////////////////////////////////////////////
+  // EventTrace class methods
+  ///////////////////////////////////////////////
+  EventTrace::EventTrace(const string& sname, const string& stitle){
+    m_Name = sname;
+    m_Title = stitle;
+    m_MinTime = 0.;
+    m_AnalysisHash = 0;
+    m_File = nullptr;
+    m_HeaderWritten = false;
+    m_WriteError = false;
+    m_NRecorded = 0;
+    m_InEvent = false;
+    m_Current.Number = -1;
+    m_Current.Time = 0.;
+    m_Current.Analyzed = false;
+  }
+
+  EventTrace::~EventTrace(){
+    Close();
+  }
+
+  const char* EventTrace::m_Magic = "RFTRACES";
+  const unsigned int EventTrace::m_Version = 1;
+
+  string EventTrace::GetName() const {
+    return m_Name;
+  }
+
+  string EventTrace::GetTitle() const {
+    return m_Title;
+  }
+
+  void EventTrace::SetMinTime(double min_time){
+    m_MinTime = max(min_time, 0.);
+  }
+
+  double EventTrace::GetMinTime() const {
+    return m_MinTime;
+  }
+
+  bool EventTrace::Open(const string& filename){
+    Close();
+    m_File = fopen(filename.c_str(), "wb");
+    if(!m_File){
+      RF_LOG(LogError, "unable to open", "EventTrace " + m_Name + ": unable to open " + filename);
+      return false;
+    }
+    m_HeaderWritten = false;
+    m_WriteError = false;
+    // the header needs the analysis (see RLabFrame::SetEventTrace)
+    if(!m_JigsawNames.empty() || !m_SourceNames.empty()) WriteHeader();
+    return true;
+  }
+
+  bool EventTrace::Close(){
+    if(!m_File) return false;
+    if(!m_HeaderWritten) WriteHeader();
+    bool ok = !m_WriteError;
+    ok = (fclose(m_File) == 0) && ok;
+    m_File = nullptr;
+    return ok;
+  }
+
+  bool EventTrace::IsOpen() const {
+    return m_File != nullptr;
+  }
+
+  long long EventTrace::GetNRecorded() const {
+    return m_NRecorded;
+  }
+
+  long EventTrace::GetNEvents() const {
+    return m_Events.size();
+  }
+
+  const TraceEvent& EventTrace::GetEvent(long i) const {
+    if(i < 0 || i >= long(m_Events.size())) return m_Current;
+    return m_Events[i];
+  }
+
+  const TraceEvent& EventTrace::GetLastEvent() const {
+    return m_Current;
+  }
+
+  long EventTrace::GetSlowestEvent() const {
+    long slowest = -1;
+    long N = m_Events.size();
+    for(long i = 0; i < N; i++)
+      if(slowest < 0 || m_Events[i].Time > m_Events[slowest].Time) slowest = i;
+    return slowest;
+  }
+
+  unsigned long long EventTrace::GetAnalysisHash() const {
+    return m_AnalysisHash;
+  }
+
+  int EventTrace::GetNJigsaws() const {
+    return m_JigsawNames.size();
+  }
+
+  string EventTrace::GetJigsawName(int i) const {
+    if(i < 0 || i >= int(m_JigsawNames.size())) return "";
+    return m_JigsawNames[i];
+  }
+
+  int EventTrace::GetNSources() const {
+    return m_SourceNames.size();
+  }
+
+  string EventTrace::GetSourceName(int i) const {
+    if(i < 0 || i >= int(m_SourceNames.size())) return "";
+    return m_SourceNames[i];
+  }
+
+  void EventTrace::SetAnalysis(unsigned long long hash, const JigsawList& jigsaws,
+			       const vector<string>& sources){
+    m_AnalysisHash = hash;
+    m_Jigsaws = jigsaws;
+    m_JigsawNames.clear();
+    int Nj = jigsaws.GetN();
+    for(int i = 0; i < Nj; i++) m_JigsawNames.push_back(jigsaws.Get(i)->GetName());
+    m_SourceNames = sources;
+    if(m_File && !m_HeaderWritten) WriteHeader();
+  }
+
+  void EventTrace::StartEvent(){
+    m_Current.Number = m_NRecorded;
+    m_Current.Time = 0.;
+    m_Current.Analyzed = false;
+    m_Current.Sources.clear();
+    m_Current.Inputs.clear();
+    m_Current.Labels.clear();
+    m_Current.Executions.clear();
+    m_Stack.clear();
+    m_Starts.clear();
+    m_InEvent = true;
+    m_EventStart = Clock::now();
+  }
+
+  void EventTrace::AddInput(int source, const TLorentzVector& P, const string& label){
+    if(!m_InEvent) return;
+    m_Current.Sources.push_back(source);
+    m_Current.Inputs.push_back(P);
+    m_Current.Labels.push_back(label);
+  }
+
+  void EventTrace::StopEvent(bool analyzed){
+    if(!m_InEvent) return;
+    m_Current.Time = chrono::duration<double>(Clock::now()-m_EventStart).count();
+    m_Current.Analyzed = analyzed;
+    m_InEvent = false;
+    m_NRecorded++;
+    if(m_Current.Time < m_MinTime) return;
+    if(m_File) WriteEvent(m_Current);
+    else m_Events.push_back(m_Current);
+  }
+
+  void EventTrace::StartJigsaw(const Jigsaw* jigsawPtr){
+    if(!m_InEvent) return;
+    int index = m_Jigsaws.GetIndex(jigsawPtr);
+    int depth = m_Stack.size();
+    int entry = -1;
+    // repeated executions under the same parent share an entry
+    if(depth > 0){
+      int N = m_Current.Executions.size();
+      for(int i = m_Stack.back()+1; i < N; i++){
+	const JigsawExecution& exec = m_Current.Executions[i];
+	if(exec.Depth == depth && exec.Jigsaw == index){
+	  entry = i;
+	  break;
+	}
+      }
+    }
+    if(entry < 0){
+      JigsawExecution exec;
+      exec.Jigsaw = index;
+      exec.Depth = depth;
+      exec.NCalls = 0;
+      exec.NFailures = 0;
+      exec.Time = 0.;
+      exec.NInputs = 0;
+      exec.Approximate = 0;
+      exec.Combinatoric = -1;
+      m_Current.Executions.push_back(exec);
+      entry = m_Current.Executions.size()-1;
+    }
+    m_Stack.push_back(entry);
+    m_Starts.push_back(Clock::now());
+  }
+
+  void EventTrace::StopJigsaw(const Jigsaw* jigsawPtr, bool ok){
+    if(!m_InEvent || m_Stack.empty()) return;
+    JigsawExecution& exec = m_Current.Executions[m_Stack.back()];
+    exec.Time += chrono::duration<double>(Clock::now()-m_Starts.back()).count();
+    exec.NCalls++;
+    if(!ok) exec.NFailures++;
+    if(jigsawPtr->IsCombinatoricJigsaw()){
+      const CombinatoricJigsaw* comb_jigsawPtr = static_cast<const CombinatoricJigsaw*>(jigsawPtr);
+      exec.NInputs = comb_jigsawPtr->GetNInputs();
+      exec.Approximate = comb_jigsawPtr->IsApproximate();
+      exec.Combinatoric = comb_jigsawPtr->GetCurrentCombinatoric();
+    }
+    m_Stack.pop_back();
+    m_Starts.pop_back();
+  }
+
+  namespace {
+    bool WriteString(FILE* file, const string& s){
+      unsigned int N = s.size();
+      if(fwrite(&N, sizeof(N), 1, file) != 1) return false;
+      return fwrite(s.data(), 1, N, file) == N;
+    }
+
+    bool ReadString(FILE* file, string& s){
+      unsigned int N;
+      if(fread(&N, sizeof(N), 1, file) != 1) return false;
+      if(N > (1u << 20)) return false;
+      s.resize(N);
+      return N == 0 || fread(&s[0], 1, N, file) == N;
+    }
+  }
+
+  bool EventTrace::WriteHeader(){
+    unsigned int head[2] = {m_Version, 0};
+    unsigned int N[2] = {(unsigned int)(m_JigsawNames.size()), (unsigned int)(m_SourceNames.size())};
+    bool ok = fwrite(m_Magic, 1, 8, m_File) == 8;
+    ok = ok && fwrite(head, sizeof(unsigned int), 2, m_File) == 2;
+    ok = ok && fwrite(&m_AnalysisHash, sizeof(m_AnalysisHash), 1, m_File) == 1;
+    ok = ok && fwrite(N, sizeof(unsigned int), 2, m_File) == 2;
+    for(unsigned int i = 0; i < N[0]; i++) ok = ok && WriteString(m_File, m_JigsawNames[i]);
+    for(unsigned int i = 0; i < N[1]; i++) ok = ok && WriteString(m_File, m_SourceNames[i]);
+    m_HeaderWritten = true;
+    if(!ok) m_WriteError = true;
+    return ok;
+  }
+
+  bool EventTrace::WriteEvent(const TraceEvent& event){
+    if(!m_HeaderWritten) WriteHeader();
+    unsigned int Nin = event.Inputs.size();
+    unsigned int Nexec = event.Executions.size();
+    unsigned int head[4] = {(unsigned int)(event.Analyzed), Nin, Nexec, 0};
+    bool ok = fwrite(&event.Number, sizeof(event.Number), 1, m_File) == 1;
+    ok = ok && fwrite(&event.Time, sizeof(event.Time), 1, m_File) == 1;
+    ok = ok && fwrite(head, sizeof(unsigned int), 4, m_File) == 4;
+    for(unsigned int i = 0; i < Nin && ok; i++){
+      int source = event.Sources[i];
+      const TLorentzVector& P = event.Inputs[i];
+      double p[4] = {P.Px(), P.Py(), P.Pz(), P.E()};
+      ok = fwrite(&source, sizeof(int), 1, m_File) == 1;
+      ok = ok && WriteString(m_File, event.Labels[i]);
+      ok = ok && fwrite(p, sizeof(double), 4, m_File) == 4;
+    }
+    for(unsigned int i = 0; i < Nexec && ok; i++){
+      const JigsawExecution& exec = event.Executions[i];
+      int ints[4] = {exec.Jigsaw, exec.Depth, exec.NCalls, exec.NFailures};
+      int comb[2] = {exec.NInputs, exec.Approximate};
+      ok = fwrite(ints, sizeof(int), 4, m_File) == 4;
+      ok = ok && fwrite(&exec.Time, sizeof(double), 1, m_File) == 1;
+      ok = ok && fwrite(comb, sizeof(int), 2, m_File) == 2;
+      ok = ok && fwrite(&exec.Combinatoric, sizeof(long long), 1, m_File) == 1;
+    }
+    if(!ok) m_WriteError = true;
+    return ok;
+  }
+
+  bool EventTrace::ReadEvent(FILE* file, TraceEvent& event){
+    unsigned int head[4];
+    bool ok = fread(&event.Time, sizeof(event.Time), 1, file) == 1;
+    ok = ok && fread(head, sizeof(unsigned int), 4, file) == 4;
+    if(!ok) return false;
+    event.Analyzed = head[0];
+    unsigned int Nin = head[1];
+    unsigned int Nexec = head[2];
+    event.Sources.clear();
+    event.Inputs.clear();
+    event.Labels.clear();
+    event.Executions.clear();
+    for(unsigned int i = 0; i < Nin && ok; i++){
+      int source;
+      string label;
+      double p[4];
+      ok = fread(&source, sizeof(int), 1, file) == 1;
+      ok = ok && ReadString(file, label);
+      ok = ok && fread(p, sizeof(double), 4, file) == 4;
+      if(!ok) break;
+      event.Sources.push_back(source);
+      event.Labels.push_back(label);
+      event.Inputs.push_back(TLorentzVector(p[0], p[1], p[2], p[3]));
+    }
+    for(unsigned int i = 0; i < Nexec && ok; i++){
+      JigsawExecution exec;
+      int ints[4];
+      int comb[2];
+      ok = fread(ints, sizeof(int), 4, file) == 4;
+      ok = ok && fread(&exec.Time, sizeof(double), 1, file) == 1;
+      ok = ok && fread(comb, sizeof(int), 2, file) == 2;
+      ok = ok && fread(&exec.Combinatoric, sizeof(long long), 1, file) == 1;
+      if(!ok) break;
+      exec.Jigsaw = ints[0];
+      exec.Depth = ints[1];
+      exec.NCalls = ints[2];
+      exec.NFailures = ints[3];
+      exec.NInputs = comb[0];
+      exec.Approximate = comb[1];
+      event.Executions.push_back(exec);
+    }
+    return ok;
+  }
+
+  bool EventTrace::Read(const string& filename){
+    FILE* file = fopen(filename.c_str(), "rb");
+    if(!file){
+      RF_LOG(LogError, "unable to open", "EventTrace " + m_Name + ": unable to open " + filename);
+      return false;
+    }
+    char magic[8];
+    unsigned int head[2];
+    unsigned int N[2];
+    unsigned long long hash;
+    bool ok = fread(magic, 1, 8, file) == 8;
+    ok = ok && fread(head, sizeof(unsigned int), 2, file) == 2;
+    ok = ok && fread(&hash, sizeof(hash), 1, file) == 1;
+    ok = ok && fread(N, sizeof(unsigned int), 2, file) == 2;
+    if(!ok || memcmp(magic, m_Magic, 8) != 0 || head[0] != m_Version){
+      RF_LOG(LogError, "not an event trace", "EventTrace " + m_Name + ": " + filename + " is not an event trace");
+      fclose(file);
+      return false;
+    }
+    vector<string> jigsaws(N[0]);
+    vector<string> sources(N[1]);
+    for(unsigned int i = 0; i < N[0]; i++) ok = ok && ReadString(file, jigsaws[i]);
+    for(unsigned int i = 0; i < N[1]; i++) ok = ok && ReadString(file, sources[i]);
+    vector<TraceEvent> events;
+    TraceEvent event;
+    // a job stopped while writing leaves the last event
+    // incomplete: the events before it are kept
+    bool truncated = false;
+    while(ok){
+      size_t n = fread(&event.Number, 1, sizeof(event.Number), file);
+      if(n == 0) break;
+      if(n != sizeof(event.Number) || !ReadEvent(file, event)){
+	truncated = true;
+	break;
+      }
+      events.push_back(event);
+    }
+    fclose(file);
+    if(!ok){
+      RF_LOG(LogError, "not a valid event trace", "EventTrace " + m_Name + ": " + filename + " is not a valid event trace");
+      return false;
+    }
+    if(truncated)
+      RF_LOG(LogWarning, "event trace is truncated", "EventTrace " + m_Name + ": " + filename + " is truncated after " +
+		    to_string(events.size()) + " events");
+    m_AnalysisHash = hash;
+    m_Jigsaws.Clear();
+    m_JigsawNames = jigsaws;
+    m_SourceNames = sources;
+    m_Events = events;
+    return true;
+  }
+
+  void EventTrace::Print(const TraceEvent& event) const {
+    char line[256];
+    snprintf(line, sizeof(line), "Event %lld: %.3f ms, %s", event.Number,
+	     1e3*event.Time, event.Analyzed ? "analyzed" : "failed");
+    cout << endl << line << endl;
+    int Nin = event.Inputs.size();
+    for(int i = 0; i < Nin; i++){
+      const TLorentzVector& P = event.Inputs[i];
+      snprintf(line, sizeof(line), "  input %-16s %-8s (%g, %g, %g, %g)",
+	       GetSourceName(event.Sources[i]).c_str(), event.Labels[i].c_str(),
+	       P.Px(), P.Py(), P.Pz(), P.E());
+      cout << line << endl;
+    }
+    int Nexec = event.Executions.size();
+    for(int i = 0; i < Nexec; i++){
+      const JigsawExecution& exec = event.Executions[i];
+      string indent(2*exec.Depth+2, ' ');
+      snprintf(line, sizeof(line), "%s%-24s %8d calls %10.3f ms", indent.c_str(),
+	       GetJigsawName(exec.Jigsaw).c_str(), exec.NCalls, 1e3*exec.Time);
+      cout << line;
+      if(exec.NFailures > 0) cout << ", " << exec.NFailures << " failed";
+      if(exec.Combinatoric >= 0){
+	snprintf(line, sizeof(line), ", %d inputs, assignment %llx%s", exec.NInputs,
+		 exec.Combinatoric, exec.Approximate ? " (approximate)" : "");
+	cout << line;
+      }
+      cout << endl;
+    }
+  }
+
+}
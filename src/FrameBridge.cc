@@ -0,0 +1,289 @@
+#include "RestFrames/FrameBridge.hh"
+#include "RestFrames/VisibleFrame.hh"
+#include "RestFrames/CombinatoricGroup.hh"
+#include "RestFrames/InvisibleGroup.hh"
+#include "RestFrames/DetectorResponse.hh"
+#include "RestFrames/FrameLog.hh"
+
+using namespace std;
+
+namespace RestFrames {
+
+  ///////////////////////////////////////////////
+  // FrameBridge class methods
+  ///////////////////////////////////////////////
+  FrameBridge::FrameBridge(const string& sname, const string& stitle){
+    m_Name = sname;
+    m_Title = stitle;
+    m_Init = false;
+    m_TransverseInvisible = true;
+    m_ResponsePtr = nullptr;
+    m_ResponseVersion = 0;
+  }
+
+  FrameBridge::~FrameBridge(){
+    Clear();
+  }
+
+  void FrameBridge::Clear(){
+    m_Init = false;
+    m_VisibleFrames.clear();
+    m_VisibleRecoFrames.clear();
+    m_VisibleGroups.clear();
+    m_VisibleIndex.clear();
+    m_UniqueFrames.clear();
+    m_UniquePaths.clear();
+    m_ResponseIndex.clear();
+    m_UniqueP.clear();
+    m_UniqueAccepted.clear();
+    m_InvisibleFrames.clear();
+    m_InvisibleGroupIndex.clear();
+    m_InvisiblePaths.clear();
+    m_InvisibleGroups.clear();
+    m_InvisibleSums.clear();
+  }
+
+  string FrameBridge::GetName() const {
+    return m_Name;
+  }
+
+  string FrameBridge::GetTitle() const {
+    return m_Title;
+  }
+
+  bool FrameBridge::AddVisibleFrame(const RestFrame& gen_frame, RestFrame& reco_frame){
+    return AddVisibleFrame(&gen_frame, &reco_frame);
+  }
+
+  bool FrameBridge::AddVisibleFrame(const RestFrame* gen_framePtr, RestFrame* reco_framePtr){
+    if(!gen_framePtr || !reco_framePtr) return false;
+    if(!gen_framePtr->IsGFrame() || !gen_framePtr->IsVisibleFrame()) return false;
+    if(!reco_framePtr->IsRFrame() || !reco_framePtr->IsVisibleFrame()) return false;
+    VisibleFrame* visPtr = dynamic_cast<VisibleFrame*>(reco_framePtr);
+    if(!visPtr) return false;
+    m_VisibleFrames.push_back(gen_framePtr);
+    m_VisibleRecoFrames.push_back(visPtr);
+    m_VisibleGroups.push_back(nullptr);
+    m_Init = false;
+    return true;
+  }
+
+  bool FrameBridge::AddVisibleFrame(const RestFrame& gen_frame, CombinatoricGroup& group){
+    return AddVisibleFrame(&gen_frame, &group);
+  }
+
+  bool FrameBridge::AddVisibleFrame(const RestFrame* gen_framePtr, CombinatoricGroup* groupPtr){
+    if(!gen_framePtr || !groupPtr) return false;
+    if(!gen_framePtr->IsGFrame() || !gen_framePtr->IsVisibleFrame()) return false;
+    m_VisibleFrames.push_back(gen_framePtr);
+    m_VisibleRecoFrames.push_back(nullptr);
+    m_VisibleGroups.push_back(groupPtr);
+    m_Init = false;
+    return true;
+  }
+
+  bool FrameBridge::AddInvisibleFrame(const RestFrame& gen_frame, InvisibleGroup& group){
+    return AddInvisibleFrame(&gen_frame, &group);
+  }
+
+  bool FrameBridge::AddInvisibleFrame(const RestFrame* gen_framePtr, InvisibleGroup* groupPtr){
+    if(!gen_framePtr || !groupPtr) return false;
+    if(!gen_framePtr->IsGFrame() || !gen_framePtr->IsInvisibleFrame()) return false;
+    int index = -1;
+    int Ngroup = m_InvisibleGroups.size();
+    for(int i = 0; i < Ngroup; i++){
+      if(m_InvisibleGroups[i] == groupPtr){
+	index = i;
+	break;
+      }
+    }
+    if(index < 0){
+      index = Ngroup;
+      m_InvisibleGroups.push_back(groupPtr);
+      m_InvisibleSums.push_back(TLorentzVector(0.,0.,0.,0.));
+    }
+    m_InvisibleFrames.push_back(gen_framePtr);
+    m_InvisibleGroupIndex.push_back(index);
+    m_Init = false;
+    return true;
+  }
+
+  void FrameBridge::SetTransverseInvisible(bool transverse){
+    m_TransverseInvisible = transverse;
+  }
+
+  void FrameBridge::SetResponse(DetectorResponse& response){
+    SetResponse(&response);
+  }
+
+  void FrameBridge::SetResponse(DetectorResponse* responsePtr){
+    m_ResponsePtr = responsePtr;
+    m_Init = false;
+  }
+
+  DetectorResponse* FrameBridge::GetResponse() const {
+    return m_ResponsePtr;
+  }
+
+  int FrameBridge::GetNVisibleFrames() const {
+    return m_VisibleFrames.size();
+  }
+
+  int FrameBridge::GetNInvisibleFrames() const {
+    return m_InvisibleFrames.size();
+  }
+
+  // The generator tree topology is fixed, so the chain of frames
+  // between each mapped frame and the lab frame is found once
+  // here rather than with a tree search every event
+  bool FrameBridge::InitializeBridge(){
+    m_Init = false;
+    m_VisibleIndex.clear();
+    m_UniqueFrames.clear();
+    m_UniquePaths.clear();
+    m_ResponseIndex.clear();
+    m_InvisiblePaths.clear();
+
+    int Nvis = m_VisibleFrames.size();
+    for(int i = 0; i < Nvis; i++){
+      int index = -1;
+      int Nunique = m_UniqueFrames.size();
+      for(int u = 0; u < Nunique; u++){
+	if(m_UniqueFrames[u] == m_VisibleFrames[i]){
+	  index = u;
+	  break;
+	}
+      }
+      if(index < 0){
+	index = Nunique;
+	m_UniqueFrames.push_back(m_VisibleFrames[i]);
+	m_UniquePaths.push_back(vector<const RestFrame*>());
+	if(!FillPathToLabFrame(m_VisibleFrames[i], m_UniquePaths[index])) return false;
+      }
+      m_VisibleIndex.push_back(index);
+    }
+    InitializeResponseIndex();
+    m_UniqueP.resize(m_UniqueFrames.size());
+    m_UniqueAccepted.assign(m_UniqueFrames.size(), true);
+
+    int Ninv = m_InvisibleFrames.size();
+    m_InvisiblePaths.resize(Ninv);
+    for(int i = 0; i < Ninv; i++)
+      if(!FillPathToLabFrame(m_InvisibleFrames[i], m_InvisiblePaths[i])) return false;
+
+    m_Init = true;
+    return m_Init;
+  }
+
+  // frames can be given their own settings in the
+  // response after the bridge is initialized
+  void FrameBridge::InitializeResponseIndex(){
+    int Nunique = m_UniqueFrames.size();
+    m_ResponseIndex.assign(Nunique, 0);
+    m_ResponseVersion = m_ResponsePtr ? m_ResponsePtr->GetVersion() : 0;
+    if(!m_ResponsePtr) return;
+    for(int u = 0; u < Nunique; u++)
+      m_ResponseIndex[u] = m_ResponsePtr->GetResponseIndex(m_UniqueFrames[u]);
+  }
+
+  bool FrameBridge::FillPathToLabFrame(const RestFrame* framePtr, vector<const RestFrame*>& path) const {
+    path.clear();
+    const RestFrame* parentPtr = framePtr->GetParentFrame();
+    while(parentPtr){
+      if(parentPtr->IsLabFrame()) return true;
+      path.push_back(parentPtr);
+      parentPtr = parentPtr->GetParentFrame();
+    }
+    RF_LOG(LogError, "frame is not connected to a lab frame", "FrameBridge " + m_Name + ": frame " + framePtr->GetName() +
+		  " is not connected to a lab frame");
+    return false;
+  }
+
+  TLorentzVector FrameBridge::GetLabFrameFourVector(const RestFrame* framePtr,
+						    const vector<const RestFrame*>& path) const {
+    TLorentzVector V = framePtr->GetFourVector(framePtr->GetParentFrame());
+    int Npath = path.size();
+    for(int i = 0; i < Npath; i++) V.Boost(path[i]->GetBoostInParentFrame());
+    return V;
+  }
+
+  bool FrameBridge::IsAccepted(const RestFrame& gen_frame) const {
+    return IsAccepted(&gen_frame);
+  }
+
+  bool FrameBridge::IsAccepted(const RestFrame* gen_framePtr) const {
+    if(!m_Init) return false;
+    int Nunique = m_UniqueFrames.size();
+    for(int u = 0; u < Nunique; u++)
+      if(m_UniqueFrames[u] == gen_framePtr) return m_UniqueAccepted[u];
+    return false;
+  }
+
+  int FrameBridge::GetNLostFrames() const {
+    if(!m_Init) return 0;
+    int Nlost = 0;
+    int Nunique = m_UniqueFrames.size();
+    for(int u = 0; u < Nunique; u++)
+      if(!m_UniqueAccepted[u]) Nlost++;
+    return Nlost;
+  }
+
+  bool FrameBridge::TransferEvent(){
+    if(!m_Init)
+      if(!InitializeBridge()) return false;
+
+    int Nunique = m_UniqueFrames.size();
+    for(int u = 0; u < Nunique; u++)
+      m_UniqueP[u] = GetLabFrameFourVector(m_UniqueFrames[u], m_UniquePaths[u]);
+
+    // all objects in the event are smeared in one pass,
+    // accumulating the change in missing momentum
+    TVector3 dMET(0.,0.,0.);
+    if(m_ResponsePtr && m_ResponsePtr->GetVersion() != m_ResponseVersion)
+      InitializeResponseIndex();
+    if(m_ResponsePtr)
+      m_ResponsePtr->SmearEvent(m_ResponseIndex, m_UniqueP, m_UniqueAccepted, dMET);
+
+    int Nvis = m_VisibleFrames.size();
+    for(int i = 0; i < Nvis; i++){
+      int u = m_VisibleIndex[i];
+      if(m_VisibleRecoFrames[i]){
+	if(m_UniqueAccepted[u])
+	  m_VisibleRecoFrames[i]->SetLabFrameFourVector(m_UniqueP[u]);
+	else
+	  m_VisibleRecoFrames[i]->SetLabFrameFourVector(TLorentzVector(0.,0.,0.,0.));
+      } else {
+	if(m_UniqueAccepted[u]) m_VisibleGroups[i]->AddLabFrameFourVector(m_UniqueP[u]);
+      }
+    }
+
+    int Ngroup = m_InvisibleGroups.size();
+    if(Ngroup <= 0) return true;
+    for(int i = 0; i < Ngroup; i++) m_InvisibleSums[i].SetPxPyPzE(0.,0.,0.,0.);
+    int Ninv = m_InvisibleFrames.size();
+    for(int i = 0; i < Ninv; i++)
+      m_InvisibleSums[m_InvisibleGroupIndex[i]] +=
+	GetLabFrameFourVector(m_InvisibleFrames[i], m_InvisiblePaths[i]);
+    // the change in missing momentum is a property of the event,
+    // so it is shared among the groups in proportion to their
+    // transverse momenta (equally if they have none)
+    double PTsum = 0.;
+    for(int i = 0; i < Ngroup; i++) PTsum += m_InvisibleSums[i].Pt();
+    for(int i = 0; i < Ngroup; i++){
+      if(m_ResponsePtr){
+	double w = PTsum > 0. ? m_InvisibleSums[i].Pt()/PTsum : 1./double(Ngroup);
+	TVector3 MET = m_InvisibleSums[i].Vect() + w*dMET;
+	m_InvisibleSums[i].SetVectM(MET, max(0.,m_InvisibleSums[i].M()));
+      }
+      if(m_TransverseInvisible){
+	TVector3 MET = m_InvisibleSums[i].Vect();
+	MET.SetZ(0.);
+	m_InvisibleGroups[i]->SetLabFrameThreeVector(MET);
+      } else {
+	m_InvisibleGroups[i]->SetLabFrameFourVector(m_InvisibleSums[i]);
+      }
+    }
+    return true;
+  }
+
+}
@@ -0,0 +1,904 @@
+#include <cmath>
+#include <cstdio>
+#include <cctype>
+#include <fstream>
+#include <map>
+#include "RestFrames/FrameLayout.hh"
+
+using namespace std;
+
+namespace RestFrames {
+
+  ///////////////////////////////////////////////
+  // FrameLayout class methods
+  ///////////////////////////////////////////////
+  FrameLayout::FrameLayout(const string& sname, const string& stitle){
+    m_Name = sname;
+    m_Title = stitle;
+    m_Type = PNone;
+    m_Nrow = 0;
+    m_Node_R = 0.;
+    m_SelfAssembling = false;
+    m_GroupPtr = nullptr;
+  }
+
+  FrameLayout::~FrameLayout(){
+    ClearTree();
+  }
+
+  string FrameLayout::GetName() const {
+    return m_Name;
+  }
+
+  string FrameLayout::GetTitle() const {
+    return m_Title;
+  }
+
+  void FrameLayout::ClearTree(){
+    int Ntreenode = m_TreeNodes.size();
+    for(int i = 0; i < Ntreenode; i++){
+      delete m_TreeNodes[i];
+    }
+    m_TreeNodes.clear();
+
+    int Ntreelink = m_TreeLinks.size();
+    for(int i = 0; i < Ntreelink; i++){
+      delete m_TreeLinks[i];
+    }
+    m_TreeLinks.clear();
+
+    int Nleaflink = m_LeafLinks.size();
+    for(int i = 0; i < Nleaflink; i++){
+      delete m_LeafLinks[i];
+    }
+    m_LeafLinks.clear();
+
+    m_Frames.Clear();
+    m_Jigsaws.Clear();
+    m_GroupPtr = nullptr;
+    m_Type = PNone;
+    m_SelfAssembling = false;
+  }
+
+  void FrameLayout::AddFrameTree(const RestFrame& frame){
+    AddFrameTree(&frame);
+  }
+  void FrameLayout::AddFrameTree(const RestFrame* framePtr){
+    if(!framePtr) return;
+    ClearTree();
+    m_Type = PFrame;
+
+    FillFrameTree(framePtr);
+    InitTreeGrid();
+    ConvertNodeCoordinates(&m_TreeNodes);
+  }
+
+  void FrameLayout::AddFrameTree(const RFrame& frame, Jigsaw& jigsaw){
+    AddFrameTree(&frame,&jigsaw);
+  }
+  void FrameLayout::AddFrameTree(const RFrame* framePtr, Jigsaw* jigsawPtr){
+    if(!framePtr) return;
+
+    AddFrameTree(framePtr);
+    AddJigsaw(jigsawPtr);
+  }
+
+  void FrameLayout::AddFrameTree(const RFrame& frame, const JigsawList& jigsaws){
+    AddFrameTree(&frame,&jigsaws);
+  }
+  void FrameLayout::AddFrameTree(const RFrame* framePtr, const JigsawList* jigsawsPtr){
+    if(!framePtr) return;
+    if(!jigsawsPtr) return;
+    AddFrameTree(framePtr);
+
+    int N = jigsawsPtr->GetN();
+    for(int j = 0; j < N; j++) AddJigsaw(jigsawsPtr->Get(j));
+  }
+
+  void FrameLayout::AddJigsaw(Jigsaw& jigsaw){
+    AddJigsaw(&jigsaw);
+  }
+  void FrameLayout::AddJigsaw(Jigsaw* jigsawPtr){
+    if(!jigsawPtr) return;
+
+    RestFrameList* framesPtr = jigsawPtr->GetChildFrames();
+    if(m_Frames.Contains(framesPtr)){
+      if(m_Jigsaws.Add(jigsawPtr)) FillJigsawLink(jigsawPtr);
+    }
+    delete framesPtr;
+  }
+
+  void FrameLayout::AddGroupTree(const Group& group){
+    AddGroupTree(&group);
+  }
+  void FrameLayout::AddGroupTree(const Group* groupPtr){
+    if(!groupPtr) return;
+    ClearTree();
+    m_GroupPtr = groupPtr;
+    m_Type = PGroup;
+
+    FillGroupTree(groupPtr);
+    InitTreeGrid();
+    ConvertNodeCoordinates(&m_TreeNodes);
+  }
+
+  void FrameLayout::InitTreeGrid(){
+    int NcolMAX = 0;
+    for(int irow = 0; irow < m_Nrow; irow++){
+      if(m_Ncol[irow] > NcolMAX) NcolMAX = m_Ncol[irow];
+    }
+    m_Node_R = min(min(0.85/double(2*NcolMAX+1),0.85*0.85/double(2*m_Nrow+1)),0.12);
+    if(m_Type == PGroup) m_Node_R = min(min(0.65/double(2*NcolMAX+1),0.85/double(2*m_Nrow+1)),0.12);
+  }
+
+  void FrameLayout::ConvertNodeCoordinates(vector<FramePlotNode*>* nodesPtr){
+    double xmin = 0.;
+    double xmax = 1.;
+    double ymin = 0.;
+    double ymax = 1.;
+    if(m_Type == PFrame) ymax = 0.8;
+    int Nnode = nodesPtr->size();
+    for(int i = 0; i < Nnode; i++){
+      double new_x = nodesPtr->at(i)->GetX();
+      double new_y = nodesPtr->at(i)->GetY();
+      new_x = xmin + (xmax-xmin)*(new_x+0.5)/double(m_Ncol[int(new_y)]);
+      new_y = ymin + (ymax-ymin)*(1.-(new_y+0.5)/double(m_Nrow));
+      nodesPtr->at(i)->SetX(new_x);
+      nodesPtr->at(i)->SetY(new_y);
+    }
+  }
+
+  void FrameLayout::AddFrame(RestFrame* framePtr){
+    m_Frames.Add(framePtr);
+  }
+
+  void FrameLayout::FillFrameTree(const RestFrame* framePtr){
+    m_Nrow = 0;
+    m_Ncol.clear();
+
+    FramePlotNode* top_nodePtr = new FramePlotNode();
+    top_nodePtr->SetX(0.);
+    top_nodePtr->SetY(0.);
+    top_nodePtr->SetFrame(framePtr);
+    top_nodePtr->SetLabel(framePtr->GetTitle());
+    m_TreeNodes.push_back(top_nodePtr);
+    m_Ncol.push_back(1);
+    FillFrameTreeMap(0, framePtr);
+    m_Nrow = m_Ncol.size();
+  }
+
+  void FrameLayout::FillFrameTreeMap(int irow, const RestFrame* framePtr){
+    if(framePtr->IsDecayFrame() && framePtr->IsRFrame()){
+      const RDecayFrame* rframePtr = dynamic_cast<const RDecayFrame*>(framePtr);
+      if(rframePtr){
+	if(rframePtr->IsSelfAssemblingFrame()){
+	  FillFrameTreeMap(irow, rframePtr);
+	  return;
+	}
+      }
+    }
+    FramePlotNode* frame_nodePtr = m_TreeNodes[m_TreeNodes.size()-1];
+
+    int Nchild = framePtr->GetNChildren();
+    for(int i = 0; i < Nchild; i++){
+      RestFrame* childPtr = framePtr->GetChildFrame(i);
+      if(!childPtr) continue;
+      if(irow+1 >= int(m_Ncol.size())){
+  	m_Ncol.push_back(0);
+      }
+      FramePlotNode* child_nodePtr = new FramePlotNode();
+      child_nodePtr->SetX(m_Ncol[irow+1]);
+      child_nodePtr->SetY(irow+1);
+      child_nodePtr->SetFrame(childPtr);
+      child_nodePtr->SetLabel(childPtr->GetTitle());
+      m_TreeNodes.push_back(child_nodePtr);
+      AddFrame(childPtr);
+      FramePlotLink* linkPtr = new FramePlotLink(frame_nodePtr,child_nodePtr);
+      m_TreeLinks.push_back(linkPtr);
+      m_Ncol[irow+1]++;
+      FillFrameTreeMap(irow+1,childPtr);
+    }
+  }
+
+  void FrameLayout::FillFrameTreeMap(int irow, const RDecayFrame* framePtr){
+    FramePlotNode* frame_nodePtr = m_TreeNodes[m_TreeNodes.size()-1];
+    frame_nodePtr->SetSquare(true);
+    m_SelfAssembling = true;
+
+    int Nchild = framePtr->GetNChildren();
+
+    for(int i = 0; i < Nchild; i++){
+      RestFrame* childPtr = framePtr->GetChildFrame(i);
+      if(!childPtr) continue;
+      bool expand_child = false;
+       int N = -1;
+       bool excl = false;
+      if(childPtr->IsVisibleFrame() && childPtr->IsRFrame()){
+	RVisibleFrame* rvframePtr = dynamic_cast<RVisibleFrame*>(childPtr);
+	if(!rvframePtr) continue;
+	CombinatoricGroup* groupPtr = dynamic_cast<CombinatoricGroup*>(rvframePtr->GetGroup());
+	if(groupPtr){
+	  groupPtr->GetNElementsForFrame(rvframePtr, N, excl);
+	  if( (N >= 2 && excl) || (N >= 1 && !excl) ) expand_child = true;
+	}
+      }
+      if(irow+1 >= int(m_Ncol.size())){
+	m_Ncol.push_back(0);
+      }
+      if(expand_child){
+	for(int j = 0; j < 3; j++){
+	  FramePlotNode* child_nodePtr = new FramePlotNode();
+	  child_nodePtr->SetX(m_Ncol[irow+1]+ double(j-1)*0.08);
+	  child_nodePtr->SetY(irow+1);
+	  child_nodePtr->SetFrame(childPtr);
+	  if(j == 2) child_nodePtr->SetLabel(GetSetTitle(childPtr->GetTitle(),"i"));
+	  m_TreeNodes.push_back(child_nodePtr);
+	  FramePlotLink* linkPtr = new FramePlotLink(frame_nodePtr,child_nodePtr);
+	  m_TreeLinks.push_back(linkPtr);
+	}
+	m_Ncol[irow+1]++;
+	AddFrame(childPtr);
+      } else {
+	FramePlotNode* child_nodePtr = new FramePlotNode();
+	child_nodePtr->SetX(m_Ncol[irow+1]);
+	child_nodePtr->SetY(irow+1);
+	child_nodePtr->SetFrame(childPtr);
+	child_nodePtr->SetLabel(childPtr->GetTitle());
+	m_TreeNodes.push_back(child_nodePtr);
+	AddFrame(childPtr);
+	FramePlotLink* linkPtr = new FramePlotLink(frame_nodePtr,child_nodePtr);
+	m_TreeLinks.push_back(linkPtr);
+	m_Ncol[irow+1]++;
+	FillFrameTreeMap(irow+1,childPtr);
+      }
+    }
+  }
+
+  void FrameLayout::FillGroupTree(const Group* groupPtr){
+    m_Nrow = 0;
+    m_Ncol.clear();
+
+    State* top_statePtr = groupPtr->GetGroupState();
+    if(!top_statePtr) return;
+
+    FramePlotNode* top_nodePtr = new FramePlotNode();
+    top_nodePtr->SetX(0.);
+    top_nodePtr->SetY(0.);
+    top_nodePtr->SetState(top_statePtr);
+    top_nodePtr->SetLabel(GetStateTitle(top_statePtr));
+    m_TreeNodes.push_back(top_nodePtr);
+    m_Ncol.push_back(1);
+    FillGroupTreeMap(0, top_statePtr);
+
+    m_Nrow = m_Ncol.size();
+  }
+
+  void FrameLayout::FillGroupTreeMap(int irow, State* statePtr){
+    Jigsaw* jigsawPtr = statePtr->GetChildJigsaw();
+    if(!jigsawPtr) return;
+
+    FramePlotNode* state_nodePtr = m_TreeNodes[int(m_TreeNodes.size())-1];
+    int Nchild = jigsawPtr->GetNChildStates();
+
+    for(int i = 0; i < Nchild; i++){
+      State* childPtr = jigsawPtr->GetChildState(i);
+      if(!childPtr) continue;
+      if(irow+1 >= int(m_Ncol.size())){
+	m_Ncol.push_back(0);
+      }
+      FramePlotNode *child_nodePtr = new FramePlotNode();
+      child_nodePtr->SetX(m_Ncol[irow+1]);
+      child_nodePtr->SetY(irow+1);
+      child_nodePtr->SetState(childPtr);
+      child_nodePtr->SetLabel(GetStateTitle(childPtr));
+      m_TreeNodes.push_back(child_nodePtr);
+      FramePlotLink* linkPtr = new FramePlotLink(state_nodePtr,child_nodePtr);
+      linkPtr->SetJigsaw(jigsawPtr);
+      linkPtr->SetLabel(jigsawPtr->GetTitle());
+      m_TreeLinks.push_back(linkPtr);
+      m_Ncol[irow+1]++;
+      FillGroupTreeMap(irow+1,childPtr);
+    }
+  }
+
+  void FrameLayout::FillJigsawLink(Jigsaw* jigsawPtr){
+    int Nsplit = jigsawPtr->GetNChildStates();
+    Group *groupPtr = jigsawPtr->GetGroup();
+    if(!groupPtr) return;
+    FramePlotNode* high_old = nullptr;
+    FramePlotNode* high_new = nullptr;
+    vector<RestFrameList*> child_framesPtr;
+    for(int s = 0; s < Nsplit; s++){
+      RestFrameList* framesPtr = jigsawPtr->GetChildFrames(s);
+      int Nnode = m_TreeNodes.size();
+      FramePlotNode* last_nodePtr = nullptr;
+      double high = -1.;
+      for(int n = 0; n < Nnode; n++){
+	FramePlotNode* nodePtr = m_TreeNodes[n];
+	const RestFrame* framePtr = nodePtr->GetFrame();
+	if(framesPtr->Contains(framePtr)){
+	  nodePtr->AddJigsaw(jigsawPtr);
+	  if(groupPtr->ContainsFrame(framePtr) || false){
+	    if(nodePtr->GetY() > high){
+	      high_new = nodePtr;
+	      high = nodePtr->GetY();
+	    }
+	  }
+	  if(last_nodePtr){
+	    if(!last_nodePtr->GetFrame()->IsSame(nodePtr->GetFrame())){
+	      FramePlotLink* linkPtr = new FramePlotLink(last_nodePtr,nodePtr);
+	      linkPtr->SetJigsaw(jigsawPtr);
+	      m_LeafLinks.push_back(linkPtr);
+	    }
+	  }
+	  last_nodePtr = nodePtr;
+	}
+      }
+      delete framesPtr;
+      if(s != 0){
+	FramePlotLink* linkPtr = new FramePlotLink(high_old,high_new);
+	linkPtr->SetWavy(true);
+	linkPtr->SetJigsaw(jigsawPtr);
+	m_LeafLinks.push_back(linkPtr);
+      }
+      high_old = high_new;
+    }
+  }
+
+  string FrameLayout::GetStateTitle(State* statePtr){
+    RestFrameList *framesPtr = statePtr->GetFrames();
+    int Nf = framesPtr->GetN();
+    string title = "";
+    if(Nf > 2) title.append("#splitline{");
+    title.append(framesPtr->Get(0)->GetTitle());
+    for(int f = 1; f < Nf; f++){
+      if(f%((Nf+1)/2) == 0 && Nf > 2) title.append("}{");
+      title.append("+ ");
+      title.append(framesPtr->Get(f)->GetTitle());
+    }
+    if(Nf > 2) title.append("}");
+    delete framesPtr;
+    return title;
+  }
+
+  string FrameLayout::GetSetTitle(const string& set, const string& index){
+    string title = "#left{#left(";
+    title.append(set);
+    title.append("#right)_{");
+    title.append(index);
+    title.append("}#right}");
+    return title;
+  }
+
+  int FrameLayout::GetJigsawTypeIndex(const Jigsaw* jigsawPtr) const {
+    int index = 0;
+    int Nj = m_Jigsaws.GetN();
+    for(int i = 0; i < Nj; i++){
+      const Jigsaw* ptr = m_Jigsaws.Get(i);
+      if(ptr == jigsawPtr) return index;
+      if(ptr->GetType() == jigsawPtr->GetType()) index++;
+    }
+    return index;
+  }
+
+  ///////////////////////////////////////////////
+  // SVG and DOT output
+  // colors follow FramePlot's: frame types in the order
+  // of FrameType, invisible and combinatoric jigsaws in
+  // the order they were added
+  ///////////////////////////////////////////////
+  namespace {
+    const char* svg_Node[4] = {"#000099","#006600","#990000","#333333"};
+    const char* svg_fill_Node[4] = {"#e6e6ff","#e6ffe6","#ffe6e6","#d6d6d6"};
+    const char* svg_Default = "#333333";
+    const char* svg_fill_Default = "#d6d6d6";
+    const char* svg_Leaf[2][4] = {{"#3d9999","#47adad","#52c2c2","#5cd6d6"},
+				  {"#ffb84d","#ffc266","#ffcc80","#ffd699"}};
+
+    string SVGNumber(double x){
+      char s[32];
+      snprintf(s, sizeof(s), "%.2f", x);
+      return s;
+    }
+
+    string Escape(char c){
+      if(c == '&') return "&amp;";
+      if(c == '<') return "&lt;";
+      if(c == '>') return "&gt;";
+      if(c == '"') return "&quot;";
+      return string(1,c);
+    }
+
+    // greek letters and a few symbols, in UTF-8
+    map<string,string> MakeSymbols(){
+      map<string,string> symbols;
+      const char* lower[24] = {"alpha","beta","gamma","delta","epsilon","zeta","eta","theta",
+			       "iota","kappa","lambda","mu","nu","xi","omicron","pi","rho",
+			       "sigma","tau","upsilon","phi","chi","psi","omega"};
+      // lower case from U+03B1 (skipping final sigma), upper case from U+0391
+      for(int i = 0; i < 24; i++){
+	int lo = 0x3b1 + i + (i >= 17 ? 1 : 0);
+	int up = 0x391 + i + (i >= 17 ? 1 : 0);
+	string lname = lower[i];
+	string uname = lname;
+	uname[0] = toupper(uname[0]);
+	char s[3];
+	s[0] = char(0xc0 | (lo >> 6));
+	s[1] = char(0x80 | (lo & 0x3f));
+	s[2] = 0;
+	symbols[lname] = s;
+	s[0] = char(0xc0 | (up >> 6));
+	s[1] = char(0x80 | (up & 0x3f));
+	symbols[uname] = s;
+      }
+      symbols["pm"] = "\xc2\xb1";
+      symbols["mp"] = "\xe2\x88\x93";
+      symbols["times"] = "\xc3\x97";
+      symbols["rightarrow"] = "\xe2\x86\x92";
+      symbols["infty"] = "\xe2\x88\x9e";
+      return symbols;
+    }
+
+    string Symbol(const string& name){
+      static const map<string,string> symbols = MakeSymbols();
+      map<string,string>::const_iterator it = symbols.find(name);
+      if(it == symbols.end()) return "";
+      return it->second;
+    }
+
+    string ConvertLatex(const string& s, size_t& i, bool svg, bool group);
+
+    // a {group}, or a single character or #command
+    string ConvertArgument(const string& s, size_t& i, bool svg){
+      while(i < s.size() && s[i] == ' ') i++;
+      if(i >= s.size()) return "";
+      if(s[i] == '{'){
+	i++;
+	return ConvertLatex(s, i, svg, true);
+      }
+      if(s[i] == '#'){
+	size_t j = i+1;
+	while(j < s.size() && isalpha(s[j])) j++;
+	string token = s.substr(i, max(j, i+2)-i);
+	size_t k = 0;
+	i += token.size();
+	return ConvertLatex(token, k, svg, false);
+      }
+      return Escape(s[i++]);
+    }
+
+    string ConvertLatex(const string& s, size_t& i, bool svg, bool group){
+      string out;
+      while(i < s.size()){
+	char c = s[i];
+	if(c == '}'){
+	  i++;
+	  if(group) return out;
+	  continue;
+	}
+	if(c == '{'){
+	  i++;
+	  out += ConvertLatex(s, i, svg, true);
+	  continue;
+	}
+	if(c == '_' || c == '^'){
+	  i++;
+	  string arg = ConvertArgument(s, i, svg);
+	  if(svg){
+	    out += string("<tspan baseline-shift=\"") + (c == '_' ? "sub" : "super");
+	    out += "\" font-size=\"70%\">" + arg + "</tspan>";
+	  } else {
+	    out += string(c == '_' ? "<SUB>" : "<SUP>") + arg + (c == '_' ? "</SUB>" : "</SUP>");
+	  }
+	  continue;
+	}
+	if(c != '#'){
+	  out += Escape(c);
+	  i++;
+	  continue;
+	}
+	i++;
+	size_t j = i;
+	while(j < s.size() && isalpha(s[j])) j++;
+	string cmd = s.substr(i, j-i);
+	i = j;
+	if(cmd.empty()){
+	  if(i < s.size()) out += Escape(s[i++]);
+	} else if(cmd == "left" || cmd == "right"){
+	  // the delimiter that follows is literal, braces included
+	  if(i < s.size()) out += Escape(s[i++]);
+	} else if(cmd == "splitline"){
+	  out += ConvertArgument(s, i, svg);
+	  out += " ";
+	  out += ConvertArgument(s, i, svg);
+	} else if(cmd == "tilde" || cmd == "bar" || cmd == "hat" || cmd == "vec" || cmd == "dot"){
+	  string arg = ConvertArgument(s, i, svg);
+	  if(cmd == "tilde") arg += "\xcc\x83";
+	  if(cmd == "bar")   arg += "\xcc\x84";
+	  if(cmd == "hat")   arg += "\xcc\x82";
+	  if(cmd == "vec")   arg += "\xe2\x83\x97";
+	  if(cmd == "dot")   arg += "\xcc\x87";
+	  out += arg;
+	} else if(!Symbol(cmd).empty()){
+	  out += Symbol(cmd);
+	} else if(i < s.size() && s[i] == '{'){
+	  // #bf{...}, #it{...} and others: keep the argument
+	  out += ConvertArgument(s, i, svg);
+	} else {
+	  out += cmd;
+	}
+      }
+      return out;
+    }
+  }
+
+  string LatexToSVG(const string& latex){
+    size_t i = 0;
+    return ConvertLatex(latex, i, true, false);
+  }
+
+  string LatexToDOT(const string& latex){
+    size_t i = 0;
+    return ConvertLatex(latex, i, false, false);
+  }
+
+  string FrameLayout::GetSVGColor(const RestFrame* framePtr, bool fill) const {
+    if(!framePtr) return fill ? svg_fill_Default : svg_Default;
+    int type = int(framePtr->GetType());
+    return fill ? svg_fill_Node[type] : svg_Node[type];
+  }
+
+  string FrameLayout::GetSVGColor(const Jigsaw* jigsawPtr) const {
+    if(!jigsawPtr) return svg_Default;
+    int type = jigsawPtr->IsInvisibleJigsaw() ? 0 : 1;
+    return svg_Leaf[type][GetJigsawTypeIndex(jigsawPtr)%4];
+  }
+
+  void FrameLayout::WriteSVGLink(ostream& out, const FramePlotLink* linkPtr, double xpix, double ypix) const {
+    double x0 = linkPtr->GetNode1()->GetX();
+    double y0 = linkPtr->GetNode1()->GetY();
+    double x1 = linkPtr->GetNode2()->GetX();
+    double y1 = linkPtr->GetNode2()->GetY();
+    double scale = min(xpix, ypix);
+
+    string color = svg_Default;
+    string color_fill = "none";
+    double width = int(m_Node_R*70.);
+    bool dashed = false;
+
+    Jigsaw* jigsawPtr = linkPtr->GetJigsaw();
+    if(jigsawPtr){
+      if(linkPtr->DoLabel()){
+	color = svg_Node[jigsawPtr->GetPriority()+2];
+	color_fill = svg_fill_Node[jigsawPtr->GetPriority()+2];
+      } else {
+	int Nj = m_Jigsaws.GetN();
+	int index = m_Jigsaws.GetIndex(jigsawPtr);
+	x0 += (double(index+1)-double(Nj+1)/2.)*m_Node_R*1./max(4.,double(Nj));
+	x1 += (double(index+1)-double(Nj+1)/2.)*m_Node_R*1./max(4.,double(Nj));
+	color = GetSVGColor(jigsawPtr);
+	if(linkPtr->DoWavy()){
+	  dashed = true;
+	  width++;
+	}
+      }
+    }
+    width *= scale/600.;
+
+    string style = " fill=\"none\" stroke=\"" + color + "\" stroke-width=\"" + SVGNumber(width) + "\"";
+    if(dashed) style += " stroke-dasharray=\"" + SVGNumber(3.*width) + "," + SVGNumber(2.*width) + "\"";
+
+    if(fabs(y0-y1) > 1e-10){ // nodes are at different heights - draw line
+      out << "<line x1=\"" << SVGNumber(x0*xpix) << "\" y1=\"" << SVGNumber((1.-y0)*ypix);
+      out << "\" x2=\"" << SVGNumber(x1*xpix) << "\" y2=\"" << SVGNumber((1.-y1)*ypix);
+      out << "\"" << style << "/>" << endl;
+    } else { // nodes are at same height - draw arc, as FramePlot
+      double c = fabs(x0-x1);
+      double h = 1./double(2*m_Nrow);
+      double xc = (x0+x1)/2.;
+      double yc, R, a0 = 0., a1 = M_PI;
+      if(h > c/2.){
+	R = c/2.;
+	if(h > R+m_Node_R) yc = y0+m_Node_R;
+	else yc = y0+h-R;
+      } else {
+	R = h/2. + c*c/(8.*h);
+	yc = y0+0.5/double(m_Nrow)-R;
+	a0 = M_PI/2.-asin(c/(2.*R));
+	a1 = M_PI/2.+asin(c/(2.*R));
+      }
+      out << "<path d=\"M " << SVGNumber((xc+R*cos(a0))*xpix) << " " << SVGNumber((1.-yc-R*sin(a0))*ypix);
+      out << " A " << SVGNumber(R*xpix) << " " << SVGNumber(R*ypix) << " 0 0 0 ";
+      out << SVGNumber((xc+R*cos(a1))*xpix) << " " << SVGNumber((1.-yc-R*sin(a1))*ypix);
+      out << "\"" << style << "/>" << endl;
+    }
+
+    if(linkPtr->DoLabel()){
+      string label = LatexToSVG(linkPtr->GetLabel());
+      double x = x0*xpix;
+      double y = (1.-(y0+y1)/2.)*ypix;
+      double size = min(0.5*m_Node_R*scale, 0.5*fabs(y0-y1)*ypix);
+      double bw = 0.55*size*double(linkPtr->GetLabel().size()) + size;
+      out << "<rect x=\"" << SVGNumber(x-bw/2.) << "\" y=\"" << SVGNumber(y-0.7*size);
+      out << "\" width=\"" << SVGNumber(bw) << "\" height=\"" << SVGNumber(1.4*size);
+      out << "\" fill=\"" << color_fill << "\" stroke=\"" << color << "\" stroke-width=\"2\"/>" << endl;
+      out << "<text x=\"" << SVGNumber(x) << "\" y=\"" << SVGNumber(y) << "\" font-size=\"" << SVGNumber(size);
+      out << "\" fill=\"" << color << "\" font-weight=\"bold\">" << label << "</text>" << endl;
+    }
+  }
+
+  void FrameLayout::WriteSVGNode(ostream& out, const FramePlotNode* nodePtr, bool with_rings,
+				 double xpix, double ypix) const {
+    double x = nodePtr->GetX()*xpix;
+    double y = (1.-nodePtr->GetY())*ypix;
+    double scale = min(xpix, ypix);
+    double R = m_Node_R*scale;
+    bool square = nodePtr->DoSquare();
+    const RestFrame* framePtr = nodePtr->GetFrame();
+    string color = GetSVGColor(framePtr, false);
+    string color_fill = GetSVGColor(framePtr, true);
+    double width = int(m_Node_R*50.)*scale/600.;
+
+    if(with_rings){
+      JigsawList* jigsawsPtr = nodePtr->GetJigsawList();
+      int Njigsaw = jigsawsPtr->GetN();
+      for(int i = 0; i < Njigsaw; i++){
+	double Rring = R*(1.03 + double(Njigsaw-i)*0.08);
+	string ring_color = GetSVGColor(jigsawsPtr->Get(i));
+	if(square){
+	  out << "<rect x=\"" << SVGNumber(x-0.88*Rring) << "\" y=\"" << SVGNumber(y-0.88*Rring);
+	  out << "\" width=\"" << SVGNumber(1.76*Rring) << "\" height=\"" << SVGNumber(1.76*Rring);
+	} else {
+	  out << "<circle cx=\"" << SVGNumber(x) << "\" cy=\"" << SVGNumber(y) << "\" r=\"" << SVGNumber(Rring);
+	}
+	out << "\" fill=\"" << ring_color << "\" stroke=\"" << ring_color << "\"/>" << endl;
+      }
+      return;
+    }
+
+    if(square){
+      out << "<rect x=\"" << SVGNumber(x-0.88*R) << "\" y=\"" << SVGNumber(y-0.88*R);
+      out << "\" width=\"" << SVGNumber(1.76*R) << "\" height=\"" << SVGNumber(1.76*R);
+    } else {
+      out << "<circle cx=\"" << SVGNumber(x) << "\" cy=\"" << SVGNumber(y) << "\" r=\"" << SVGNumber(R);
+    }
+    out << "\" fill=\"" << color_fill << "\" stroke=\"" << color;
+    out << "\" stroke-width=\"" << SVGNumber(width) << "\"/>" << endl;
+
+    if(nodePtr->DoLabel()){
+      // sized to fit the node, as FramePlot does with TLatex
+      int Nchar = max(2, int(nodePtr->GetLabel().size())/2);
+      double size = min(0.9*R, 2.6*R/double(Nchar));
+      out << "<text x=\"" << SVGNumber(x) << "\" y=\"" << SVGNumber(y) << "\" font-size=\"" << SVGNumber(size);
+      out << "\" fill=\"" << color << "\" font-weight=\"bold\">";
+      out << LatexToSVG(nodePtr->GetLabel()) << "</text>" << endl;
+    }
+  }
+
+  void FrameLayout::WriteSVGLegend(ostream& out, double xpix, double ypix) const {
+    double scale = min(xpix, ypix);
+    double size = 0.045*scale;
+    if(m_Type == PGroup){
+      out << "<text x=\"" << SVGNumber(0.01*xpix) << "\" y=\"" << SVGNumber(0.01*ypix+size);
+      out << "\" font-size=\"" << SVGNumber(size) << "\" text-anchor=\"start\" fill=\"" << svg_Default << "\">";
+      out << LatexToSVG(m_GroupPtr->GetTitle()) << "</text>" << endl;
+      return;
+    }
+
+    const char* frame_title[4] = {"Lab State","Decay States","Visible States","Invisible States"};
+    FrameType frame_type[4] = {FLab, FDecay, FVisible, FInvisible};
+    bool has_type[4] = {false, false, false, false};
+    int Nnode = m_TreeNodes.size();
+    for(int n = 0; n < Nnode; n++){
+      const RestFrame* framePtr = m_TreeNodes[n]->GetFrame();
+      if(!framePtr) continue;
+      for(int i = 0; i < 4; i++)
+	if(framePtr->GetType() == frame_type[i]) has_type[i] = true;
+    }
+    double X = 0.045*xpix;
+    double Y = 0.045*ypix;
+    double R = 0.035*scale;
+    for(int i = 0; i < 4; i++){
+      if(!has_type[i]) continue;
+      out << "<circle cx=\"" << SVGNumber(X) << "\" cy=\"" << SVGNumber(Y) << "\" r=\"" << SVGNumber(R);
+      out << "\" fill=\"" << svg_fill_Node[frame_type[i]] << "\" stroke=\"" << svg_Node[frame_type[i]];
+      out << "\" stroke-width=\"2\"/>" << endl;
+      out << "<text x=\"" << SVGNumber(X+1.3*R) << "\" y=\"" << SVGNumber(Y) << "\" font-size=\"" << SVGNumber(size);
+      out << "\" text-anchor=\"start\" fill=\"" << svg_Default << "\">" << frame_title[i] << "</text>" << endl;
+      Y += 2.2*R;
+    }
+    if(m_SelfAssembling){
+      out << "<rect x=\"" << SVGNumber(X-0.88*R) << "\" y=\"" << SVGNumber(Y-0.88*R);
+      out << "\" width=\"" << SVGNumber(1.76*R) << "\" height=\"" << SVGNumber(1.76*R);
+      out << "\" fill=\"" << svg_fill_Node[FDecay] << "\" stroke=\"" << svg_Node[FDecay] << "\" stroke-width=\"2\"/>" << endl;
+      out << "<text x=\"" << SVGNumber(X+1.3*R) << "\" y=\"" << SVGNumber(Y) << "\" font-size=\"" << SVGNumber(size);
+      out << "\" text-anchor=\"start\" fill=\"" << svg_Default << "\">Self Assembling</text>" << endl;
+    }
+
+    int Nj = m_Jigsaws.GetN();
+    X = 0.62*xpix;
+    Y = 0.045*ypix;
+    for(int i = 0; i < Nj; i++){
+      const Jigsaw* jigsawPtr = m_Jigsaws.Get(i);
+      out << "<line x1=\"" << SVGNumber(X-R) << "\" y1=\"" << SVGNumber(Y) << "\" x2=\"" << SVGNumber(X+R);
+      out << "\" y2=\"" << SVGNumber(Y) << "\" stroke=\"" << GetSVGColor(jigsawPtr);
+      out << "\" stroke-width=\"" << SVGNumber(int(m_Node_R*70.)*scale/600.) << "\"/>" << endl;
+      out << "<text x=\"" << SVGNumber(X+1.3*R) << "\" y=\"" << SVGNumber(Y) << "\" font-size=\"" << SVGNumber(size);
+      out << "\" text-anchor=\"start\" fill=\"" << svg_Default << "\">";
+      out << (jigsawPtr->IsInvisibleJigsaw() ? "Invisible Jigsaw" : "Combinatoric Jigsaw") << "</text>" << endl;
+      Y += 2.2*R;
+    }
+  }
+
+  // drawn in the order of FramePlot::DrawFramePlot
+  string FrameLayout::GetSVG(double xpix, double ypix) const {
+    ostringstream out;
+    out << "<svg xmlns=\"http://www.w3.org/2000/svg\" width=\"" << SVGNumber(xpix);
+    out << "\" height=\"" << SVGNumber(ypix) << "\" viewBox=\"0 0 " << SVGNumber(xpix);
+    out << " " << SVGNumber(ypix) << "\">" << endl;
+    out << "<title>";
+    for(size_t i = 0; i < m_Title.size(); i++) out << Escape(m_Title[i]);
+    out << "</title>" << endl;
+    out << "<rect width=\"100%\" height=\"100%\" fill=\"white\"/>" << endl;
+    out << "<g font-family=\"Times New Roman, serif\" text-anchor=\"middle\" dominant-baseline=\"central\">" << endl;
+
+    if(m_Type != PNone){
+      bool do_jigsaws = (m_Type == PFrame && m_Jigsaws.GetN() > 0);
+      int Nlink = m_TreeLinks.size();
+      for(int i = 0; i < Nlink; i++) WriteSVGLink(out, m_TreeLinks[i], xpix, ypix);
+      int Nnode = m_TreeNodes.size();
+      if(do_jigsaws){
+	for(int i = 0; i < Nnode; i++) WriteSVGNode(out, m_TreeNodes[i], true, xpix, ypix);
+	int Nleaf = m_LeafLinks.size();
+	for(int i = 0; i < Nleaf; i++) WriteSVGLink(out, m_LeafLinks[i], xpix, ypix);
+      }
+      for(int i = 0; i < Nnode; i++) WriteSVGNode(out, m_TreeNodes[i], false, xpix, ypix);
+      WriteSVGLegend(out, xpix, ypix);
+    }
+
+    out << "</g>" << endl << "</svg>" << endl;
+    return out.str();
+  }
+
+  string FrameLayout::GetDOT() const {
+    ostringstream out;
+    out << "digraph \"" << m_Name << "\" {" << endl;
+    out << "  label=<" << LatexToDOT(m_Type == PGroup ? m_GroupPtr->GetTitle() : m_Title) << ">;" << endl;
+    out << "  labelloc=t;" << endl;
+    out << "  node [style=filled, fontname=\"Times-Bold\", penwidth=2];" << endl;
+    out << "  edge [arrowhead=none, penwidth=2];" << endl;
+
+    map<const FramePlotNode*,int> index;
+    int Nnode = m_TreeNodes.size();
+    for(int i = 0; i < Nnode; i++){
+      const FramePlotNode* nodePtr = m_TreeNodes[i];
+      index[nodePtr] = i;
+      const RestFrame* framePtr = nodePtr->GetFrame();
+      out << "  n" << i << " [label=<" << (nodePtr->DoLabel() ? LatexToDOT(nodePtr->GetLabel()) : "");
+      out << ">, shape=" << (nodePtr->DoSquare() ? "box" : "circle");
+      out << ", color=\"" << GetSVGColor(framePtr, false) << "\", fillcolor=\"" << GetSVGColor(framePtr, true);
+      out << "\", fontcolor=\"" << GetSVGColor(framePtr, false) << "\"];" << endl;
+    }
+
+    int Nlink = m_TreeLinks.size();
+    for(int i = 0; i < Nlink; i++){
+      const FramePlotLink* linkPtr = m_TreeLinks[i];
+      out << "  n" << index[linkPtr->GetNode1()] << " -> n" << index[linkPtr->GetNode2()];
+      Jigsaw* jigsawPtr = linkPtr->GetJigsaw();
+      if(linkPtr->DoLabel() && jigsawPtr){
+	out << " [label=<" << LatexToDOT(linkPtr->GetLabel()) << ">, color=\"";
+	out << svg_Node[jigsawPtr->GetPriority()+2] << "\", fontcolor=\"";
+	out << svg_Node[jigsawPtr->GetPriority()+2] << "\"]";
+      }
+      out << ";" << endl;
+    }
+
+    // jigsaw links do not affect the ranking of the tree
+    int Nleaf = m_LeafLinks.size();
+    for(int i = 0; i < Nleaf; i++){
+      const FramePlotLink* linkPtr = m_LeafLinks[i];
+      out << "  n" << index[linkPtr->GetNode1()] << " -> n" << index[linkPtr->GetNode2()];
+      out << " [color=\"" << GetSVGColor(linkPtr->GetJigsaw()) << "\", constraint=false";
+      if(linkPtr->DoWavy()) out << ", style=dashed";
+      out << "];" << endl;
+    }
+
+    // one rank per row of the grid
+    for(int irow = 0; irow < m_Nrow; irow++){
+      out << "  { rank=same;";
+      for(int i = 0; i < Nnode; i++){
+	double y = 1.-(m_TreeNodes[i]->GetY()/(m_Type == PFrame ? 0.8 : 1.));
+	if(int(y*double(m_Nrow)) == irow) out << " n" << i << ";";
+      }
+      out << " }" << endl;
+    }
+    out << "}" << endl;
+    return out.str();
+  }
+
+  bool FrameLayout::WriteSVG(const string& filename, double xpix, double ypix) const {
+    ofstream file(filename.c_str());
+    if(!file.is_open()) return false;
+    file << GetSVG(xpix, ypix);
+    file.close();
+    return !file.fail();
+  }
+
+  bool FrameLayout::WriteDOT(const string& filename) const {
+    ofstream file(filename.c_str());
+    if(!file.is_open()) return false;
+    file << GetDOT();
+    file.close();
+    return !file.fail();
+  }
+
+  ///////////////////////////////////////////////
+  // FramePlotNode class methods
+  ///////////////////////////////////////////////
+  FramePlotNode::FramePlotNode(){
+    Init();
+  }
+
+  FramePlotNode::~FramePlotNode(){
+    if(m_JigsawsPtr) delete m_JigsawsPtr;
+  }
+
+  void FramePlotNode::Init(){
+    m_X = 0;
+    m_Y = 0;
+    m_Label = "";
+    m_DoLabel = false;
+    m_DoSquare = false;
+    m_FramePtr = nullptr;
+    m_StatePtr = nullptr;
+    m_JigsawsPtr = new JigsawList();
+  }
+
+  void FramePlotNode::SetX(double x){ m_X = x; }
+  void FramePlotNode::SetY(double y){ m_Y = y; }
+  void FramePlotNode::SetLabel(const string& label){ m_Label = label; m_DoLabel = true; }
+  void FramePlotNode::SetSquare(bool square){ m_DoSquare = square; }
+  void FramePlotNode::SetFrame(const RestFrame* framePtr){ m_FramePtr = framePtr; }
+  void FramePlotNode::SetState(State* statePtr){ m_StatePtr = statePtr; }
+  void FramePlotNode::AddJigsaw(Jigsaw* jigsawPtr){ m_JigsawsPtr->Add(jigsawPtr); }
+
+  double FramePlotNode::GetX() const { return m_X; }
+  double FramePlotNode::GetY() const { return m_Y; }
+  string FramePlotNode::GetLabel() const { return m_Label; }
+  const RestFrame* FramePlotNode::GetFrame() const { return m_FramePtr; }
+  State* FramePlotNode::GetState() const { return m_StatePtr; }
+  bool FramePlotNode::DoLabel() const { return m_DoLabel; }
+  bool FramePlotNode::DoSquare() const { return m_DoSquare; }
+  int FramePlotNode::GetNJigsaws() const { return m_JigsawsPtr->GetN(); }
+  JigsawList* FramePlotNode::GetJigsawList() const { return m_JigsawsPtr; }
+
+  ///////////////////////////////////////////////
+  // FramePlotLink class methods
+  ///////////////////////////////////////////////
+  FramePlotLink::FramePlotLink(FramePlotNode* Node1Ptr, FramePlotNode* Node2Ptr){
+    m_Node1Ptr = Node1Ptr;
+    m_Node2Ptr = Node2Ptr;
+    Init();
+  }
+
+  FramePlotLink::~FramePlotLink(){ }
+
+  void FramePlotLink::Init(){
+    m_Wavy = false;
+    m_DoLabel = false;
+    m_Label = "";
+    m_JigsawPtr = nullptr;
+  }
+
+  void FramePlotLink::SetWavy(bool wavy){ m_Wavy = wavy; }
+  void FramePlotLink::SetLabel(const string& label){ m_Label = label; m_DoLabel = true; }
+  void FramePlotLink::SetJigsaw(Jigsaw* jigsawPtr){ m_JigsawPtr = jigsawPtr; }
+
+  FramePlotNode* FramePlotLink::GetNode1() const { return m_Node1Ptr; }
+  FramePlotNode* FramePlotLink::GetNode2() const { return m_Node2Ptr; }
+  bool FramePlotLink::DoWavy() const { return m_Wavy; }
+  string FramePlotLink::GetLabel() const { return m_Label; }
+  bool FramePlotLink::DoLabel() const { return m_DoLabel; }
+  Jigsaw* FramePlotLink::GetJigsaw() const { return m_JigsawPtr; }
+
+}
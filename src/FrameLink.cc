@@ -7,25 +7,35 @@ namespace RestFrames {
   ///////////////////////////////////////////////
   // FrameLink class methods
   ///////////////////////////////////////////////
+  atomic<unsigned long long> FrameLink::m_class_version(0);
+
   FrameLink::FrameLink(){
     m_parent_framePtr = nullptr;
     m_child_framePtr = nullptr;
+    m_class_version++;
   }
   FrameLink::~FrameLink(){
-  
+    m_class_version++;
+  }
+
+  unsigned long long FrameLink::GetTreeVersion(){
+    return m_class_version;
   }
 
   void FrameLink::Clear(){
+    m_class_version++;
     m_parent_framePtr = nullptr;
     if(m_child_framePtr) m_child_framePtr->SetParentLink(nullptr);
     m_B.SetXYZ(0.,0.,0.);
   }
 
   void FrameLink::SetParentFrame(RestFrame* framePtr){
+    m_class_version++;
     m_parent_framePtr = framePtr;
   }
 
   void FrameLink::SetChildFrame(RestFrame* framePtr){
+    m_class_version++;
     m_child_framePtr = framePtr;
   }
 
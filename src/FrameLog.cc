@@ -1,82 +1,235 @@
-#include <sstream>
+#include <cstdio>
+#include <vector>
+#include <mutex>
+#include "RestFrames/RestFrames_config.h"
 #include "RestFrames/FrameLog.hh"
 
 using namespace std;
 
 namespace RestFrames {
 
-  bool FrameLog::m_print = true;
+  atomic<int> FrameLog::m_level(LogWarning);
+  atomic<int> FrameLog::m_max_repeats(10);
+  atomic<bool> FrameLog::m_print(true);
+  bool FrameLog::m_color = true;
   ostream* FrameLog::m_default_ostr = &cerr;
+  atomic<long long> FrameLog::m_counts[LogNone];
+
+  // sites in the order first logged from, guarded (with the
+  // output, color and stream) by g_LogMutex
+  static mutex g_LogMutex;
+  static vector<FrameLog::Site*>& LogSites(){
+    static vector<FrameLog::Site*> sites;
+    return sites;
+  }
+
+  static const char* LogTypeName(LogType type){
+    switch(type){
+    case LogDebug:   return "Debug";
+    case LogInfo:    return "Info";
+    case LogWarning: return "Warning";
+    case LogError:   return "Error";
+    default:         return "";
+    }
+  }
+
+  ///////////////////////////////////////////////
+  // FrameLog::Site class methods
+  ///////////////////////////////////////////////
+  FrameLog::Site::Site(LogType type, const char* message) :
+    m_Type(type), m_Message(message), m_N(0)
+  {
+    lock_guard<mutex> lock(g_LogMutex);
+    LogSites().push_back(this);
+  }
 
   ///////////////////////////////////////////////
   // FrameLog class methods
   ///////////////////////////////////////////////
   FrameLog::FrameLog(const string& message, bool error){
     m_error = error;
-    ErrorMessage();
-    AddMessage(message);
-    PrintMessage();
-  }  
+    m_message = message;
+    Log(m_error ? LogError : LogWarning, message);
+  }
 
   FrameLog::FrameLog(const string& message, RestFrame* frame_ptr, bool error){
     m_error = error;
-    ErrorMessage();
-    FrameMessage(frame_ptr);
-    AddMessage(message);
-    PrintMessage();
-  }  
+    m_message = frame_ptr ? "From RestFrame " + frame_ptr->GetName() + " => " + message : message;
+    Log(m_error ? LogError : LogWarning, message, frame_ptr);
+  }
 
   FrameLog::FrameLog(const string& message, Jigsaw* jigsaw_ptr, bool error){
     m_error = error;
-    ErrorMessage();
-    JigsawMessage(jigsaw_ptr);
-    AddMessage(message);
-    PrintMessage();
-  }  
+    m_message = jigsaw_ptr ? "From Jigsaw " + jigsaw_ptr->GetName() + " => " + message : message;
+    Log(m_error ? LogError : LogWarning, message, jigsaw_ptr);
+  }
 
   FrameLog::FrameLog(const string& message, Group* group_ptr, bool error){
     m_error = error;
-    ErrorMessage();
-    GroupMessage(group_ptr);
-    AddMessage(message);
-    PrintMessage();
-  }  
-  
-  void FrameLog::ErrorMessage(){
-    if(m_error)
-      m_message = "\x1b[31m RestFrames::Error: \x1b[0m";
-    else
-      m_message = "\x1b[35m RestFrames::Warning: \x1b[0m";
-  }
-
-  void FrameLog::AddMessage(const string& message){
-    m_message += "\x1b[37m";
-    m_message += message; 
-    m_message += "\x1b[0m";
-  }
-
-  void FrameLog::PrintMessage(){
-    if (m_print && m_default_ostr){
-      ostringstream oss;
-      oss << m_message << endl;
-      *m_default_ostr << oss.str();
-      m_default_ostr->flush();     
+    m_message = group_ptr ? "From Group " + group_ptr->GetName() + " => " + message : message;
+    Log(m_error ? LogError : LogWarning, message, group_ptr);
+  }
+
+  void FrameLog::Log(LogType type, const string& message){
+    if(Count(type)) Print(type, "", message, 0);
+  }
+
+  void FrameLog::Log(LogType type, const string& message, const RestFrame* frame_ptr){
+    if(Count(type)) Print(type, frame_ptr ? "RestFrame " + frame_ptr->GetName() : "", message, 0);
+  }
+
+  void FrameLog::Log(LogType type, const string& message, const Jigsaw* jigsaw_ptr){
+    if(Count(type)) Print(type, jigsaw_ptr ? "Jigsaw " + jigsaw_ptr->GetName() : "", message, 0);
+  }
+
+  void FrameLog::Log(LogType type, const string& message, const Group* group_ptr){
+    if(Count(type)) Print(type, group_ptr ? "Group " + group_ptr->GetName() : "", message, 0);
+  }
+
+  void FrameLog::Log(const Site& site, long long N, const string& text){
+    Print(site.m_Type, "", text.empty() ? string(site.m_Message) : text, N);
+  }
+
+  void FrameLog::Log(const Site& site, long long N, const RestFrame* frame_ptr, const string& text){
+    Print(site.m_Type, frame_ptr ? "RestFrame " + frame_ptr->GetName() : "",
+	  text.empty() ? string(site.m_Message) : text, N);
+  }
+
+  void FrameLog::Log(const Site& site, long long N, const Jigsaw* jigsaw_ptr, const string& text){
+    Print(site.m_Type, jigsaw_ptr ? "Jigsaw " + jigsaw_ptr->GetName() : "",
+	  text.empty() ? string(site.m_Message) : text, N);
+  }
+
+  void FrameLog::Log(const Site& site, long long N, const Group* group_ptr, const string& text){
+    Print(site.m_Type, group_ptr ? "Group " + group_ptr->GetName() : "",
+	  text.empty() ? string(site.m_Message) : text, N);
+  }
+
+  void FrameLog::SetLevel(LogType type){
+    m_level = type;
+  }
+
+  LogType FrameLog::GetLevel(){
+    return LogType(m_level.load());
+  }
+
+  void FrameLog::SetMaxRepeats(int N){
+    m_max_repeats = N;
+  }
+
+  void FrameLog::SetColor(bool color){
+    lock_guard<mutex> lock(g_LogMutex);
+    m_color = color;
+  }
+
+  void FrameLog::SetPrint(bool print){
+    m_print = print;
+  }
+
+  void FrameLog::SetOutputStream(ostream* ostr){
+    lock_guard<mutex> lock(g_LogMutex);
+    m_default_ostr = ostr;
+  }
+
+  // counting is lock-free, so that filtered messages cost no
+  // more than an atomic increment and are never built
+  bool FrameLog::Count(LogType type){
+    if(type < LogDebug || type >= LogNone) return false;
+    m_counts[type].fetch_add(1, memory_order_relaxed);
+    return m_print && IsPrinted(type);
+  }
+
+  long long FrameLog::Count(Site& site){
+    bool printed = Count(site.m_Type);
+    long long N = site.m_N.fetch_add(1, memory_order_relaxed) + 1;
+    if(!printed) return 0;
+    int max_repeats = m_max_repeats;
+    return (max_repeats <= 0 || N <= max_repeats) ? N : 0;
+  }
+
+  // prints the message as one write to the output stream; N is
+  // the count of a site's message (0 if not from a site)
+  void FrameLog::Print(LogType type, const string& source, const string& message, long long N){
+    lock_guard<mutex> lock(g_LogMutex);
+    if(!m_default_ostr) return;
+    string line = Prefix(type);
+    if(!source.empty()){
+      if(m_color) line += "From\x1b[36m " + source + "\x1b[0m => ";
+      else        line += "From " + source + " => ";
     }
+    if(m_color) line += "\x1b[37m" + message + "\x1b[0m";
+    else        line += message;
+    if(N > 0 && N == m_max_repeats)
+      line += " (repeated, further messages only counted)";
+    line += '\n';
+    m_default_ostr->write(line.c_str(), line.size());
   }
 
-  void FrameLog::FrameMessage(RestFrame* frame_ptr){
-    if(frame_ptr) 
-	m_message += "From\x1b[36m RestFrame " + frame_ptr->GetName() + "\x1b[0m => ";
+  string FrameLog::Prefix(LogType type){
+    string prefix = " RestFrames::";
+    prefix += LogTypeName(type);
+    prefix += ": ";
+    if(!m_color) return prefix;
+    switch(type){
+    case LogError:   return "\x1b[31m" + prefix + "\x1b[0m";
+    case LogWarning: return "\x1b[35m" + prefix + "\x1b[0m";
+    default:         return "\x1b[36m" + prefix + "\x1b[0m";
+    }
+  }
+
+  long long FrameLog::GetCount(LogType type){
+    if(type < LogDebug || type >= LogNone) return 0;
+    return m_counts[type].load(memory_order_relaxed);
+  }
+
+  // messages from each site, then those logged without a site
+  void FrameLog::PrintSummary(){
+    lock_guard<mutex> lock(g_LogMutex);
+    if(!m_default_ostr) return;
+    ostream& ostr = *m_default_ostr;
+    const vector<Site*>& sites = LogSites();
+    long long Nsited[LogNone] = { 0 };
+    int Nsite = sites.size();
+    int Nlogged = 0;
+    for(int i = 0; i < Nsite; i++){
+      Nsited[sites[i]->m_Type] += sites[i]->GetCount();
+      if(sites[i]->GetCount() > 0) Nlogged++;
+    }
+    ostr << endl << "RestFrames messages from " << Nlogged << " sites" << endl;
+    char line[64];
+    for(int i = 0; i < Nsite; i++){
+      long long N = sites[i]->GetCount();
+      if(N <= 0) continue;
+      snprintf(line, sizeof(line), "  %12lld  %-8s ", N, LogTypeName(sites[i]->m_Type));
+      ostr << line << sites[i]->m_Message << endl;
+    }
+    for(int t = LogDebug; t < LogNone; t++){
+      long long N = GetCount(LogType(t)) - Nsited[t];
+      if(N <= 0) continue;
+      snprintf(line, sizeof(line), "  %12lld  %-8s ", N, LogTypeName(LogType(t)));
+      ostr << line << "(other messages)" << endl;
+    }
   }
 
-  void FrameLog::JigsawMessage(Jigsaw* jigsaw_ptr){
-    if(jigsaw_ptr) 
-	m_message += "From\x1b[36m Jigsaw " + jigsaw_ptr->GetName() + "\x1b[0m => ";
+  void FrameLog::ClearCounts(){
+    lock_guard<mutex> lock(g_LogMutex);
+    for(int t = LogDebug; t < LogNone; t++) m_counts[t] = 0;
+    const vector<Site*>& sites = LogSites();
+    int Nsite = sites.size();
+    for(int i = 0; i < Nsite; i++) sites[i]->m_N = 0;
   }
 
-  void FrameLog::GroupMessage(Group* group_ptr){
-    if(group_ptr) 
-	m_message += "From\x1b[36m Group " + group_ptr->GetName() + "\x1b[0m => ";
+  void FrameLog::PrintBanner(){
+    printf("\n" "\x1b[36m");
+    printf(PACKAGE_NAME);
+    printf(" v");
+    printf(PACKAGE_VERSION);
+    printf(" -- Developed by Christopher Rogan (crogan@cern.ch)\n");
+    printf("                     ");
+    printf("Copyright (c) 2014-2015, Christopher Rogan\n");
+    printf("                     ");
+    printf("http://RestFrames.com\n");
+    printf("\x1b[0m" "\n");
   }
 
 }
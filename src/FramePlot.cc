@@ -13,50 +13,18 @@ namespace RestFrames {
   // FramePlot class methods
   // class which can plot RestFrame trees
   ///////////////////////////////////////////////
-  FramePlot::FramePlot(const string& sname, const string& stitle){
-    m_Type = PNone;
-    m_Name = sname;
-    m_Title = stitle;
-    m_GroupPtr = nullptr;
+  FramePlot::FramePlot(const string& sname, const string& stitle)
+    : FrameLayout(sname, stitle)
+  {
     m_CanvasPtr = nullptr;
+    m_NInvJigsaw = 0;
+    m_NCombJigsaw = 0;
   }
   
   FramePlot::~FramePlot(){
-    ClearTree();
     ClearCanvas();
   }
 
-  void FramePlot::ClearTree(){
-    int Ntreenode = m_TreeNodes.size();
-    for(int i = 0; i < Ntreenode; i++){
-      delete m_TreeNodes[i];
-    }
-    m_TreeNodes.clear();
-    
-    int Ntreelink = m_TreeLinks.size();
-    for(int i = 0; i < Ntreelink; i++){
-      delete m_TreeLinks[i];
-    }
-    m_TreeLinks.clear();
-    
-    int Nleaflink = m_LeafLinks.size();
-    for(int i = 0; i < Nleaflink; i++){
-      delete m_LeafLinks[i];
-    }
-    m_LeafLinks.clear();
-
-    m_Frames.Clear();
-    m_Jigsaws.Clear();
-    m_GroupPtr = nullptr;
-    m_Type = PNone;
-    m_NInvJigsaw = 0;
-    m_NCombJigsaw = 0;
-    m_SelfAssembling = false;
-    m_JigsawColorMap.clear();
-    m_FrameColorMap.clear();
-    m_FrameColorFillMap.clear();
-  }
-
   void FramePlot::ClearCanvas(){
      if(m_CanvasPtr){
        delete m_CanvasPtr;
@@ -89,9 +57,41 @@ namespace RestFrames {
     return canvasPtr;
   }
 
+  // colors of the frame types in the tree, and of the
+  // jigsaws in the order they were added
+  void FramePlot::InitColors(){
+    m_FrameColorMap.clear();
+    m_FrameColorFillMap.clear();
+    m_JigsawColorMap.clear();
+    m_NInvJigsaw = 0;
+    m_NCombJigsaw = 0;
+
+    int Nnode = m_TreeNodes.size();
+    for(int i = 0; i < Nnode; i++){
+      const RestFrame* framePtr = m_TreeNodes[i]->GetFrame();
+      if(!framePtr) continue;
+      m_FrameColorMap[framePtr->GetType()] = color_Node[int(framePtr->GetType())];
+      m_FrameColorFillMap[framePtr->GetType()] = color_fill_Node[int(framePtr->GetType())];
+    }
+
+    int Nj = m_Jigsaws.GetN();
+    for(int i = 0; i < Nj; i++){
+      Jigsaw* jigsawPtr = m_Jigsaws.Get(i);
+      if(jigsawPtr->IsInvisibleJigsaw()){
+	m_JigsawColorMap[jigsawPtr] = color_Leaf[0]+m_NInvJigsaw;
+	m_NInvJigsaw++;
+      }
+      if(jigsawPtr->IsCombinatoricJigsaw()){
+	m_JigsawColorMap[jigsawPtr] = color_Leaf[1]+m_NCombJigsaw;
+	m_NCombJigsaw++;
+      }
+    }
+  }
+
   void FramePlot::DrawFramePlot(){
     if(m_Type == PNone) return;
     SetCanvas();
+    InitColors();
 
     if(m_Type == PFrame){
       bool do_jigsaws = (m_Jigsaws.GetN() > 0);
@@ -112,313 +112,6 @@ namespace RestFrames {
     m_CanvasPtr->Draw();
   }
 
-  void FramePlot::AddFrameTree(const RestFrame& frame){
-    AddFrameTree(&frame);
-  }
-  void FramePlot::AddFrameTree(const RestFrame* framePtr){
-    if(!framePtr) return;
-    ClearTree();
-    m_Type = PFrame;
-
-    FillFrameTree(framePtr);
-    InitTreeGrid();
-    ConvertNodeCoordinates(&m_TreeNodes);
-  }
-
-  void FramePlot::AddFrameTree(const RFrame& frame, Jigsaw& jigsaw){
-    AddFrameTree(&frame,&jigsaw);
-  }
-  void FramePlot::AddFrameTree(const RFrame* framePtr, Jigsaw* jigsawPtr){
-    if(!framePtr) return;
-   
-    AddFrameTree(framePtr);
-    AddJigsaw(jigsawPtr);
-  }
-
-  void FramePlot::AddFrameTree(const RFrame& frame, const JigsawList& jigsaws){
-    AddFrameTree(&frame,&jigsaws);
-  }
-  void FramePlot::AddFrameTree(const RFrame* framePtr, const JigsawList* jigsawsPtr){
-    if(!framePtr) return;
-    if(!jigsawsPtr) return;
-    AddFrameTree(framePtr);
-
-    int N = jigsawsPtr->GetN();
-    for(int j = 0; j < N; j++) AddJigsaw(jigsawsPtr->Get(j));
-  }
-
-  void FramePlot::AddJigsaw(Jigsaw& jigsaw){
-    AddJigsaw(&jigsaw);
-  }
-  void FramePlot::AddJigsaw(Jigsaw* jigsawPtr){
-    if(!jigsawPtr) return;
-    
-    RestFrameList* framesPtr = jigsawPtr->GetChildFrames();
-    if(m_Frames.Contains(framesPtr)){
-      if(m_Jigsaws.Add(jigsawPtr)){
-	FillJigsawLink(jigsawPtr);
-	if(jigsawPtr->IsInvisibleJigsaw()){
-	  m_JigsawColorMap[jigsawPtr] = color_Leaf[0]+m_NInvJigsaw;
-	  m_NInvJigsaw++;
-	}
-	if(jigsawPtr->IsCombinatoricJigsaw()){
-	  m_JigsawColorMap[jigsawPtr] = color_Leaf[1]+m_NCombJigsaw;
-	  m_NCombJigsaw++;
-	}
-      }
-    }
-    delete framesPtr;
-  }
-
-  void FramePlot::AddGroupTree(const Group& group){
-    AddGroupTree(&group);
-  }
-  void FramePlot::AddGroupTree(const Group* groupPtr){
-    if(!groupPtr) return;
-    ClearTree();
-    m_GroupPtr = groupPtr;
-    m_Type = PGroup;
-
-    FillGroupTree(groupPtr);
-    InitTreeGrid();
-    ConvertNodeCoordinates(&m_TreeNodes);
-  }
-
-  void FramePlot::InitTreeGrid(){
-    int NcolMAX = 0;
-    for(int irow = 0; irow < m_Nrow; irow++){
-      if(m_Ncol[irow] > NcolMAX) NcolMAX = m_Ncol[irow];
-    }
-    m_Node_R = min(min(0.85/double(2*NcolMAX+1),0.85*0.85/double(2*m_Nrow+1)),0.12);
-    if(m_Type == PGroup) m_Node_R = min(min(0.65/double(2*NcolMAX+1),0.85/double(2*m_Nrow+1)),0.12);
-  }
-
-  void FramePlot::ConvertNodeCoordinates(vector<FramePlotNode*>* nodesPtr){
-    double xmin = 0.;
-    double xmax = 1.;
-    double ymin = 0.;
-    double ymax = 1.;
-    if(m_Type == PFrame) ymax = 0.8;
-    int Nnode = nodesPtr->size();
-    for(int i = 0; i < Nnode; i++){
-      double new_x = nodesPtr->at(i)->GetX();
-      double new_y = nodesPtr->at(i)->GetY();
-      new_x = xmin + (xmax-xmin)*(new_x+0.5)/double(m_Ncol[int(new_y)]);
-      new_y = ymin + (ymax-ymin)*(1.-(new_y+0.5)/double(m_Nrow));
-      nodesPtr->at(i)->SetX(new_x);
-      nodesPtr->at(i)->SetY(new_y);
-    }
-  }
-   
-  void FramePlot::AddFrame(RestFrame* framePtr){
-    m_Frames.Add(framePtr);
-    if(m_FrameColorMap[framePtr->GetType()] <= 0){
-      m_FrameColorMap[framePtr->GetType()] = color_Node[int(framePtr->GetType())];
-      m_FrameColorFillMap[framePtr->GetType()] = color_fill_Node[int(framePtr->GetType())];
-    }
-  }
-
-  void FramePlot::AddFrame(const RestFrame* framePtr){
-    if(m_FrameColorMap[framePtr->GetType()] <= 0){
-      m_FrameColorMap[framePtr->GetType()] = color_Node[int(framePtr->GetType())];
-      m_FrameColorFillMap[framePtr->GetType()] = color_fill_Node[int(framePtr->GetType())];
-    }
-  }
-
-  void FramePlot::FillFrameTree(const RestFrame* framePtr){
-    m_Nrow = 0;
-    m_Ncol.clear();
-
-    FramePlotNode* top_nodePtr = new FramePlotNode();
-    top_nodePtr->SetX(0.);
-    top_nodePtr->SetY(0.);
-    top_nodePtr->SetFrame(framePtr);
-    top_nodePtr->SetLabel(framePtr->GetTitle());
-    m_TreeNodes.push_back(top_nodePtr);
-    AddFrame(framePtr);
-    m_Ncol.push_back(1);
-    FillFrameTreeMap(0, framePtr);
-    m_Nrow = m_Ncol.size();
-  }
-
-  void FramePlot::FillFrameTreeMap(int irow, const RestFrame* framePtr){
-    if(framePtr->IsDecayFrame() && framePtr->IsRFrame()){
-      const RDecayFrame* rframePtr = dynamic_cast<const RDecayFrame*>(framePtr);
-      if(rframePtr){
-	if(rframePtr->IsSelfAssemblingFrame()){
-	  FillFrameTreeMap(irow, rframePtr);
-	  return;
-	}
-      }
-    }
-    FramePlotNode* frame_nodePtr = m_TreeNodes[m_TreeNodes.size()-1];
-
-    int Nchild = framePtr->GetNChildren();
-    for(int i = 0; i < Nchild; i++){
-      RestFrame* childPtr = framePtr->GetChildFrame(i);
-      if(!childPtr) continue;
-      if(irow+1 >= int(m_Ncol.size())){
-  	m_Ncol.push_back(0);
-      }
-      FramePlotNode* child_nodePtr = new FramePlotNode();
-      child_nodePtr->SetX(m_Ncol[irow+1]);
-      child_nodePtr->SetY(irow+1);
-      child_nodePtr->SetFrame(childPtr);
-      child_nodePtr->SetLabel(childPtr->GetTitle());
-      m_TreeNodes.push_back(child_nodePtr);
-      AddFrame(childPtr);
-      FramePlotLink* linkPtr = new FramePlotLink(frame_nodePtr,child_nodePtr);
-      m_TreeLinks.push_back(linkPtr);
-      m_Ncol[irow+1]++;
-      FillFrameTreeMap(irow+1,childPtr);
-    }
-  }
-
-  void FramePlot::FillFrameTreeMap(int irow, const RDecayFrame* framePtr){
-    FramePlotNode* frame_nodePtr = m_TreeNodes[m_TreeNodes.size()-1];
-    frame_nodePtr->SetSquare(true);
-    m_SelfAssembling = true;
-
-    int Nchild = framePtr->GetNChildren();
- 
-    for(int i = 0; i < Nchild; i++){
-      RestFrame* childPtr = framePtr->GetChildFrame(i);
-      if(!childPtr) continue;
-      bool expand_child = false;
-       int N = -1;
-       bool excl = false;
-      if(childPtr->IsVisibleFrame() && childPtr->IsRFrame()){
-	RVisibleFrame* rvframePtr = dynamic_cast<RVisibleFrame*>(childPtr);
-	if(!rvframePtr) continue;
-	CombinatoricGroup* groupPtr = dynamic_cast<CombinatoricGroup*>(rvframePtr->GetGroup());
-	if(groupPtr){
-	  groupPtr->GetNElementsForFrame(rvframePtr, N, excl);
-	  if( (N >= 2 && excl) || (N >= 1 && !excl) ) expand_child = true;
-	}
-      }
-      if(irow+1 >= int(m_Ncol.size())){
-	m_Ncol.push_back(0);
-      }
-      if(expand_child){
-	for(int j = 0; j < 3; j++){
-	  FramePlotNode* child_nodePtr = new FramePlotNode();
-	  child_nodePtr->SetX(m_Ncol[irow+1]+ double(j-1)*0.08);
-	  child_nodePtr->SetY(irow+1);
-	  child_nodePtr->SetFrame(childPtr);
-	  if(j == 2) child_nodePtr->SetLabel(GetSetTitle(childPtr->GetTitle(),"i"));
-	  m_TreeNodes.push_back(child_nodePtr);
-	  FramePlotLink* linkPtr = new FramePlotLink(frame_nodePtr,child_nodePtr);
-	  m_TreeLinks.push_back(linkPtr);
-	}
-	m_Ncol[irow+1]++;
-	AddFrame(childPtr);
-      } else {
-	FramePlotNode* child_nodePtr = new FramePlotNode();
-	child_nodePtr->SetX(m_Ncol[irow+1]);
-	child_nodePtr->SetY(irow+1);
-	child_nodePtr->SetFrame(childPtr);
-	child_nodePtr->SetLabel(childPtr->GetTitle());
-	m_TreeNodes.push_back(child_nodePtr);
-	AddFrame(childPtr);
-	FramePlotLink* linkPtr = new FramePlotLink(frame_nodePtr,child_nodePtr);
-	m_TreeLinks.push_back(linkPtr);
-	m_Ncol[irow+1]++;
-	FillFrameTreeMap(irow+1,childPtr);
-      }
-    }
-  }
-
-  void FramePlot::FillGroupTree(const Group* groupPtr){
-    m_Nrow = 0;
-    m_Ncol.clear();
-  
-    State* top_statePtr = groupPtr->GetGroupState();
-    if(!top_statePtr) return;
-
-    FramePlotNode* top_nodePtr = new FramePlotNode();
-    top_nodePtr->SetX(0.);
-    top_nodePtr->SetY(0.);
-    top_nodePtr->SetState(top_statePtr);
-    top_nodePtr->SetLabel(GetStateTitle(top_statePtr));
-    m_TreeNodes.push_back(top_nodePtr);
-    m_Ncol.push_back(1);
-    FillGroupTreeMap(0, top_statePtr);
-
-    m_Nrow = m_Ncol.size();
-  }
-
-  void FramePlot::FillGroupTreeMap(int irow, State* statePtr){
-    Jigsaw* jigsawPtr = statePtr->GetChildJigsaw();
-    if(!jigsawPtr) return;
-
-    FramePlotNode* state_nodePtr = m_TreeNodes[int(m_TreeNodes.size())-1];
-    int Nchild = jigsawPtr->GetNChildStates();
-
-    for(int i = 0; i < Nchild; i++){
-      State* childPtr = jigsawPtr->GetChildState(i);
-      if(!childPtr) continue;
-      if(irow+1 >= int(m_Ncol.size())){
-	m_Ncol.push_back(0);
-      }
-      FramePlotNode *child_nodePtr = new FramePlotNode();
-      child_nodePtr->SetX(m_Ncol[irow+1]);
-      child_nodePtr->SetY(irow+1);
-      child_nodePtr->SetState(childPtr);
-      child_nodePtr->SetLabel(GetStateTitle(childPtr));
-      m_TreeNodes.push_back(child_nodePtr);
-      FramePlotLink* linkPtr = new FramePlotLink(state_nodePtr,child_nodePtr);
-      linkPtr->SetJigsaw(jigsawPtr);
-      linkPtr->SetLabel(jigsawPtr->GetTitle());
-      m_TreeLinks.push_back(linkPtr);
-      m_Ncol[irow+1]++;
-      FillGroupTreeMap(irow+1,childPtr);
-    }
-  }
-
-  void FramePlot::FillJigsawLink(Jigsaw* jigsawPtr){
-    int Nsplit = jigsawPtr->GetNChildStates();
-    Group *groupPtr = jigsawPtr->GetGroup();
-    if(!groupPtr) return;
-    FramePlotNode* high_old = nullptr;
-    FramePlotNode* high_new = nullptr;
-    vector<RestFrameList*> child_framesPtr;
-    for(int s = 0; s < Nsplit; s++){
-      RestFrameList* framesPtr = jigsawPtr->GetChildFrames(s);
-      int Nnode = m_TreeNodes.size();
-      FramePlotNode* last_nodePtr = nullptr;
-      double high = -1.;
-      for(int n = 0; n < Nnode; n++){
-	FramePlotNode* nodePtr = m_TreeNodes[n];
-	const RestFrame* framePtr = nodePtr->GetFrame();
-	if(framesPtr->Contains(framePtr)){
-	  nodePtr->AddJigsaw(jigsawPtr);
-	  if(groupPtr->ContainsFrame(framePtr) || false){
-	    if(nodePtr->GetY() > high){
-	      high_new = nodePtr;
-	      high = nodePtr->GetY();
-	    }
-	  }
-	  if(last_nodePtr){
-	    if(!last_nodePtr->GetFrame()->IsSame(nodePtr->GetFrame())){
-	      FramePlotLink* linkPtr = new FramePlotLink(last_nodePtr,nodePtr);
-	      linkPtr->SetJigsaw(jigsawPtr);
-	      m_LeafLinks.push_back(linkPtr);
-	    }
-	  }
-	  last_nodePtr = nodePtr;
-	}
-      }
-      delete framesPtr;
-      if(s != 0){
-	FramePlotLink* linkPtr = new FramePlotLink(high_old,high_new);
-	linkPtr->SetWavy(true);
-	linkPtr->SetJigsaw(jigsawPtr);
-	m_LeafLinks.push_back(linkPtr);
-      }
-      high_old = high_new;
-    }
-  }
-
   void FramePlot::DrawTreeNodes(bool with_rings){
     int Nnode = m_TreeNodes.size();
     for(int i = 0; i < Nnode; i++){
@@ -617,31 +310,6 @@ namespace RestFrames {
     }
   }
 
-  string FramePlot::GetStateTitle(State* statePtr){
-    RestFrameList *framesPtr = statePtr->GetFrames();
-    int Nf = framesPtr->GetN();
-    string title = "";
-    if(Nf > 2) title.append("#splitline{");
-    title.append(framesPtr->Get(0)->GetTitle());
-    for(int f = 1; f < Nf; f++){
-      if(f%((Nf+1)/2) == 0 && Nf > 2) title.append("}{");
-      title.append("+ ");
-      title.append(framesPtr->Get(f)->GetTitle());
-    }
-    if(Nf > 2) title.append("}");
-    delete framesPtr;
-    return title;
-  }
-
-  string FramePlot::GetSetTitle(const string& set, const string& index){
-    string title = "#left{#left(";
-    title.append(set);
-    title.append("#right)_{");
-    title.append(index);
-    title.append("}#right}");
-    return title;
-  }
-
   void FramePlot::DrawFrameTypeLegend(){
     vector<string> frame_title;
     frame_title.push_back("Lab State");
@@ -750,73 +418,4 @@ namespace RestFrames {
     m_Objects.push_back(lat);
   }
   
-  ///////////////////////////////////////////////
-  // FramePlotNode class methods
-  ///////////////////////////////////////////////
-  FramePlotNode::FramePlotNode(){ 
-    Init();
-  }
-  
-  FramePlotNode::~FramePlotNode(){ 
-    if(m_JigsawsPtr) delete m_JigsawsPtr;
-  }
-
-  void FramePlotNode::Init(){
-    m_X = 0;
-    m_Y = 0;
-    m_Label = "";
-    m_DoLabel = false;
-    m_DoSquare = false;
-    m_FramePtr = nullptr;
-    m_StatePtr = nullptr;
-    m_JigsawsPtr = new JigsawList();
-  }
-    
-  void FramePlotNode::SetX(double x){ m_X = x; }
-  void FramePlotNode::SetY(double y){ m_Y = y; }
-  void FramePlotNode::SetLabel(const string& label){ m_Label = label; m_DoLabel = true; }
-  void FramePlotNode::SetSquare(bool square){ m_DoSquare = square; }
-  void FramePlotNode::SetFrame(const RestFrame* framePtr){ m_FramePtr = framePtr; }
-  void FramePlotNode::SetState(State* statePtr){ m_StatePtr = statePtr; }
-  void FramePlotNode::AddJigsaw(Jigsaw* jigsawPtr){ m_JigsawsPtr->Add(jigsawPtr); }
-  
-  double FramePlotNode::GetX() const { return m_X; }
-  double FramePlotNode::GetY() const { return m_Y; }
-  string FramePlotNode::GetLabel() const { return m_Label; }
-  const RestFrame* FramePlotNode::GetFrame() const { return m_FramePtr; }
-  State* FramePlotNode::GetState() const { return m_StatePtr; }
-  bool FramePlotNode::DoLabel() const { return m_DoLabel; }
-  bool FramePlotNode::DoSquare() const { return m_DoSquare; }
-  int FramePlotNode::GetNJigsaws() const { return m_JigsawsPtr->GetN(); }
-  JigsawList* FramePlotNode::GetJigsawList() const { return m_JigsawsPtr; }
-
-  ///////////////////////////////////////////////
-  // FramePlotLink class methods
-  ///////////////////////////////////////////////
-  FramePlotLink::FramePlotLink(FramePlotNode* Node1Ptr, FramePlotNode* Node2Ptr){
-    m_Node1Ptr = Node1Ptr;
-    m_Node2Ptr = Node2Ptr;
-    Init();
-  }
-  
-  FramePlotLink::~FramePlotLink(){ }
-
-  void FramePlotLink::Init(){ 
-    m_Wavy = false; 
-    m_DoLabel = false; 
-    m_Label = ""; 
-    m_JigsawPtr = nullptr;
-  }
-
-  void FramePlotLink::SetWavy(bool wavy){ m_Wavy = wavy; }
-  void FramePlotLink::SetLabel(const string& label){ m_Label = label; m_DoLabel = true; }
-  void FramePlotLink::SetJigsaw(Jigsaw* jigsawPtr){ m_JigsawPtr = jigsawPtr; }
-  
-  FramePlotNode* FramePlotLink::GetNode1() const { return m_Node1Ptr; }
-  FramePlotNode* FramePlotLink::GetNode2() const { return m_Node2Ptr; }
-  bool FramePlotLink::DoWavy() const { return m_Wavy; }
-  string FramePlotLink::GetLabel() const { return m_Label; }
-  bool FramePlotLink::DoLabel() const { return m_DoLabel; }
-  Jigsaw* FramePlotLink::GetJigsaw() const { return m_JigsawPtr; }
-
 }
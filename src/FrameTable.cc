@@ -0,0 +1,116 @@
+#include "RestFrames/FrameTable.hh"
+#include "RestFrames/FrameLink.hh"
+
+using namespace std;
+
+namespace RestFrames {
+
+  ///////////////////////////////////////////////
+  // FrameTable class methods
+  ///////////////////////////////////////////////
+  FrameTable::FrameTable(){
+    m_Filled = false;
+    m_Version = 0;
+  }
+
+  FrameTable::~FrameTable(){
+    Clear();
+  }
+
+  // vectors keep their capacity, so refilling
+  // the same tree each event does not allocate
+  void FrameTable::Clear(){
+    m_Filled = false;
+    int N = m_Frames.size();
+    for(int i = 0; i < N; i++){
+      if(!m_Frames[i]) continue;
+      m_Frames[i]->m_TablePtr = nullptr;
+      m_Frames[i]->m_TableIndex = -1;
+    }
+    m_Frames.clear();
+    m_Parent.clear();
+    m_Depth.clear();
+    m_Links.clear();
+  }
+
+  // self-assembling frames change the tree each
+  // event, and their tables are refilled each event
+  void FrameTable::Fill(RestFrame* labPtr){
+    Clear();
+    if(!labPtr) return;
+    m_Version = FrameLink::GetTreeVersion();
+    FillRecursive(labPtr, nullptr, -1, 0);
+    m_Filled = true;
+  }
+
+  void FrameTable::FillRecursive(RestFrame* framePtr, FrameLink* linkPtr, int parent, int depth){
+    // a frame is in one table at a time
+    if(framePtr->m_TablePtr && framePtr->m_TablePtr != this)
+      framePtr->m_TablePtr->RemoveFrame(framePtr);
+    framePtr->m_TablePtr = this;
+    framePtr->m_TableIndex = m_Frames.size();
+    m_Frames.push_back(framePtr);
+    m_Parent.push_back(parent);
+    m_Depth.push_back(depth);
+    m_Links.push_back(linkPtr);
+
+    int i = framePtr->m_TableIndex;
+    int Nc = framePtr->GetNChildren();
+    for(int c = 0; c < Nc; c++)
+      FillRecursive(framePtr->GetChildFrame(c), framePtr->m_ChildLinks[c], i, depth+1);
+  }
+
+  // the tree has changed, so boosts are found
+  // without the table until it is filled again
+  void FrameTable::RemoveFrame(RestFrame* framePtr){
+    int i = GetIndex(framePtr);
+    if(i < 0) return;
+    m_Frames[i] = nullptr;
+    m_Filled = false;
+    framePtr->m_TablePtr = nullptr;
+    framePtr->m_TableIndex = -1;
+  }
+
+  bool FrameTable::IsFilled() const {
+    return m_Filled && m_Version == FrameLink::GetTreeVersion();
+  }
+
+  int FrameTable::GetNFrames() const {
+    return m_Frames.size();
+  }
+
+  RestFrame* FrameTable::GetFrame(int i) const {
+    if(i < 0 || i >= GetNFrames()) return nullptr;
+    return m_Frames[i];
+  }
+
+  int FrameTable::GetIndex(const RestFrame* framePtr) const {
+    if(!framePtr || framePtr->m_TablePtr != this) return -1;
+    int i = framePtr->m_TableIndex;
+    if(i < 0 || i >= GetNFrames() || m_Frames[i] != framePtr) return -1;
+    return i;
+  }
+
+  // up from i to the common ancestor, then down to j,
+  // in the same order as RestFrame::FindPathToFrame
+  void FrameTable::Boost(TLorentzVector& V, int i, int j) const {
+    if(i == j) return;
+    int a = i;
+    int b = j;
+    while(m_Depth[b] > m_Depth[a]) b = m_Parent[b];
+    while(m_Depth[a] > m_Depth[b]) a = m_Parent[a];
+    while(a != b){
+      a = m_Parent[a];
+      b = m_Parent[b];
+    }
+    for(int k = i; k != a; k = m_Parent[k]) V.Boost(m_Links[k]->GetBoostVector());
+    BoostDown(V, j, a);
+  }
+
+  void FrameTable::BoostDown(TLorentzVector& V, int j, int top) const {
+    if(j == top) return;
+    BoostDown(V, m_Parent[j], top);
+    V.Boost(-m_Links[j]->GetBoostVector());
+  }
+
+}
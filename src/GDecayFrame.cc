@@ -31,6 +31,12 @@ namespace RestFrames {
     m_ChildGamma = -1.;
     m_CosDecayAngle = -2.;
     m_DeltaPhiDecayPlane = -2.;
+    m_Pcm = -1.;
+    m_PcmMass = -1.;
+    for(int i = 0; i < 2; i++){
+      m_MassChildMass[i] = -1.;
+      m_PcmChildMass[i] = -1.;
+    }
   }
 
   bool GDecayFrame::IsSoundBody() const{
@@ -81,7 +87,6 @@ namespace RestFrames {
 
   void GDecayFrame::ResetFrame(){
     m_Spirit = false;
-    if(m_ChildP > 0. || m_ChildGamma >= 1.) m_MassSet = false;
     ResetDecayAngles();
   }
 
@@ -91,13 +96,17 @@ namespace RestFrames {
   }
 
   double GDecayFrame::GetMass() const{
-    if(m_MassSet) return m_Mass;
+    if(m_MassSet && m_ChildP < 0. && m_ChildGamma < 1.) return m_Mass;
 
     int Nchild = GetNChildren();
     if(Nchild != 2) return -1.;
     double m[2];
     for(int i = 0; i < 2; i++) m[i] = GetChildFrame(i)->GetMass();
-    double Mass;
+    // with the child momentum or gamma fixed, the mass 
+    // only needs recalculating if the child masses change
+    if(m_MassSet && m[0] == m_MassChildMass[0] && m[1] == m_MassChildMass[1]) 
+      return m_Mass;
+    double Mass = -1.;
     if(m_ChildP >= 0.){
       Mass = 0.;
       for(int i = 0; i < 2; i++) 
@@ -109,6 +118,7 @@ namespace RestFrames {
     }
     m_Mass = Mass;
     m_MassSet = true;
+    for(int i = 0; i < 2; i++) m_MassChildMass[i] = m[i];
     return m_Mass;
   }
 
@@ -116,6 +126,19 @@ namespace RestFrames {
     if(!m_Body) return false;
     int Nchild = GetNChildren();
 
+    // two-body decays skip the general N-body bookkeeping
+    if(Nchild == 2){
+      double m0 = max(0.,GetChildFrame(0)->GetMass());
+      double m1 = max(0.,GetChildFrame(1)->GetMass());
+      double Mass = GetMass();
+      if(Mass <= m0+m1) return false;
+
+      GenerateTwoBody(Mass, m0, m1,
+		      m_ParentLinkPtr->GetBoostVector(),
+		      GetParentFrame()->GetDecayPlaneNormalVector());
+      return true;
+    }
+
     vector<double> ChildMasses;
     double ChildMassTOT = 0.;
     for(int i = 0; i < Nchild; i++){
@@ -138,6 +161,37 @@ namespace RestFrames {
     return true;
   }
 
+  double GDecayFrame::GetTwoBodyMomentum(double M, double m0, double m1){
+    if(M != m_PcmMass || m0 != m_PcmChildMass[0] || m1 != m_PcmChildMass[1]){
+      m_Pcm = sqrt((M*M-m0*m0-m1*m1)*(M*M-m0*m0-m1*m1)-4.*m0*m0*m1*m1)/2./M;
+      m_PcmMass = M;
+      m_PcmChildMass[0] = m0;
+      m_PcmChildMass[1] = m1;
+    }
+    return m_Pcm;
+  }
+
+  void GDecayFrame::GenerateTwoBody(double M, double m0, double m1,
+				    const TVector3& axis_par, const TVector3& axis_perp)
+  {
+    TVector3 n_par = axis_par.Unit();
+    TVector3 n_perp = axis_perp.Unit();
+
+    TVector3 V_c = GetTwoBodyMomentum(M, m0, m1)*n_par;
+    if(m_CosDecayAngle < -1.) m_CosDecayAngle = 1.-2.*GetRandom();
+    if(m_DeltaPhiDecayPlane < 0.) m_DeltaPhiDecayPlane = 2.*acos(-1.)*GetRandom();
+
+    V_c.Rotate(-acos(m_CosDecayAngle),n_perp);
+    V_c.Rotate(-m_DeltaPhiDecayPlane,n_par);
+    ResetDecayAngles();
+
+    TLorentzVector P_child;
+    P_child.SetVectM(V_c, m0);
+    SetChild(0, P_child);
+    P_child.SetVectM(-V_c, m1);
+    SetChild(1, P_child);
+  }
+
   double GDecayFrame::GenerateTwoBodyRecursive(double M,const vector<double>& M_c,
 					       const TVector3& axis_par, const TVector3& axis_perp,
 					       vector<TLorentzVector>& P_c)
@@ -61,6 +61,7 @@ namespace RestFrames {
 	return false;
       }
     }
+    SumDescendantFourVectors();
 
     m_Spirit = true;
     return m_Spirit;
@@ -68,13 +69,25 @@ namespace RestFrames {
 
   void GFrame::SetChildren(const vector<TLorentzVector>& P_children){
     int N = P_children.size();
-    for(int i = 0; i < N; i++){
-      TLorentzVector P = P_children[i];
-      TVector3 B_child = P.BoostVector();
+    for(int i = 0; i < N; i++) SetChild(i, P_children[i]);
+  }
+
+  void GFrame::SetChild(int i, const TLorentzVector& P_child){
+    TVector3 B_child = P_child.BoostVector();
+
+    m_ChildLinks[i]->SetBoostVector(B_child);
+    GetChildGFrame(i)->SetFourVector(P_child,this);
+  }
 
-      m_ChildLinks[i]->SetBoostVector(B_child);
-      dynamic_cast<GFrame*>(GetChildFrame(i))->SetFourVector(P,this);
+  GFrame* GFrame::GetChildGFrame(int i){
+    RestFrame* childPtr = GetChildFrame(i);
+    if(int(m_ChildGFrames.size()) <= i) m_ChildGFrames.resize(i+1, nullptr);
+    GFrame* framePtr = m_ChildGFrames[i];
+    if(!framePtr || static_cast<RestFrame*>(framePtr) != childPtr){
+      framePtr = dynamic_cast<GFrame*>(childPtr);
+      m_ChildGFrames[i] = framePtr;
     }
+    return framePtr;
   }
 
   double GFrame::GetRandom(){
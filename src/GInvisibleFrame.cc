@@ -33,6 +33,10 @@ namespace RestFrames {
     if(val >= 0.) m_Mass = val;
   }
 
+  double GInvisibleFrame::GetMass() const {
+    return m_Mass;
+  }
+
   void GInvisibleFrame::ResetFrame(){ }
 
   bool GInvisibleFrame::GenerateFrame(){ 
@@ -92,6 +92,7 @@ namespace RestFrames {
     m_Spirit = false;
 
     if(!AnalyzeEventRecursive()) return false;
+    if(!m_FrameTable.IsFilled()) m_FrameTable.Fill(this);
     m_Spirit = true;
     return m_Spirit;
   }
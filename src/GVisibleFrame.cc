@@ -33,6 +33,10 @@ namespace RestFrames {
     if(val >= 0.) m_Mass = val;
   }
 
+  double GVisibleFrame::GetMass() const {
+    return m_Mass;
+  }
+
   void GVisibleFrame::ResetFrame(){ }
 
   bool GVisibleFrame::GenerateFrame(){ 
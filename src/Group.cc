@@ -1,3 +1,4 @@
+#include <algorithm>
 #include "RestFrames/Group.hh"
 
 using namespace std;
@@ -60,6 +61,8 @@ namespace RestFrames {
     m_JigsawsPtr->Clear();
     m_StatesToSplitPtr->Clear();
     m_JigsawsToUsePtr->Clear(); 
+    m_FrameStates.clear();
+    m_FrameJigsaws.clear();
   }
 
   int Group::GenKey(){
@@ -111,19 +114,16 @@ namespace RestFrames {
     return m_JigsawsPtr->Copy();
   }
 
+  JigsawList* Group::GetJigsawsToUse() const {
+    return m_JigsawsToUsePtr->Copy();
+  }
+
   State* Group::GetGroupState() const {
     return m_GroupStatePtr;
   }
 
   bool Group::InitializeAnalysis(){
-    m_StatesPtr->Clear();
-    m_StatesToSplitPtr->Clear();
-    if(m_GroupStatePtr) delete m_GroupStatePtr;
-
-    m_GroupStatePtr = InitializeGroupState();
-    m_GroupStatePtr->AddFrame(&m_Frames);
-    m_StatesPtr->Add(m_GroupStatePtr);
-    m_StatesToSplitPtr->Add(m_GroupStatePtr);
+    InitializeStates();
  
     m_Body = false;
     m_Mind = false;
@@ -134,11 +134,77 @@ namespace RestFrames {
     return true;
   }
 
+  bool Group::InitializeAnalysis(const JigsawList* split_jigsawsPtr){
+    if(!split_jigsawsPtr) return InitializeAnalysis();
+    InitializeStates();
+
+    m_Body = false;
+    m_Mind = false;
+    int Nsplit = split_jigsawsPtr->GetN();
+    int isplit = 0;
+    while(m_StatesToSplitPtr->GetN() > 0){
+      State* statePtr = m_StatesToSplitPtr->Get(0);
+      Jigsaw* jigsawPtr = split_jigsawsPtr->Get(isplit);
+      if(jigsawPtr && m_JigsawsToUsePtr->Contains(jigsawPtr) &&
+	 jigsawPtr->CanSplit(statePtr)){
+	InitializeJigsaw(jigsawPtr);
+	if(!m_JigsawsPtr->Contains(jigsawPtr)) return false;
+	m_JigsawsToUsePtr->Remove(jigsawPtr);
+	isplit++;
+	continue;
+      }
+      if(statePtr->GetNFrames() != 1) return false;
+      m_StatesToSplitPtr->Remove(statePtr);
+    }
+    if(isplit != Nsplit) return false;
+    m_Body = true;
+    m_Mind = true;
+
+    return true;
+  }
+
   State* Group::InitializeGroupState(){
     return new State();
   }
 
+  void Group::InitializeStates(){
+    m_StatesPtr->Clear();
+    m_StatesToSplitPtr->Clear();
+    m_FrameStates.clear();
+    if(m_GroupStatePtr) delete m_GroupStatePtr;
+
+    m_GroupStatePtr = InitializeGroupState();
+    m_GroupStatePtr->AddFrame(&m_Frames);
+    AddState(m_GroupStatePtr);
+    m_StatesToSplitPtr->Add(m_GroupStatePtr);
+  }
+
+  void Group::AddState(State* statePtr){
+    if(!statePtr) return;
+    int index = m_StatesPtr->GetN();
+    m_StatesPtr->Add(statePtr);
+    if(m_StatesPtr->GetN() == index) return;
+    const RestFrameList* framesPtr = statePtr->GetFrameList();
+    int Nf = framesPtr->GetN();
+    if(Nf == 0) m_FrameStates[-1].push_back(index);
+    for(int f = 0; f < Nf; f++)
+      m_FrameStates[framesPtr->Get(f)->GetKey()].push_back(index);
+  }
+
   bool Group::InitializeJigsaws(){
+    // a jigsaw can only split a state if its outputs hold
+    // the state's frames, so it is indexed by those frames
+    m_FrameJigsaws.clear();
+    int Nj = m_JigsawsToUsePtr->GetN();
+    for(int j = 0; j < Nj; j++){
+      Jigsaw* jigsawPtr = m_JigsawsToUsePtr->Get(j);
+      RestFrameList* framesPtr = jigsawPtr->GetOutputFrames();
+      int Nf = framesPtr->GetN();
+      for(int f = 0; f < Nf; f++)
+	m_FrameJigsaws[framesPtr->Get(f)->GetKey()].push_back(jigsawPtr);
+      delete framesPtr;
+    }
+
     while(m_StatesToSplitPtr->GetN() > 0){
       State* statePtr = m_StatesToSplitPtr->Get(0);
       if(!SplitState(statePtr)){
@@ -150,10 +216,17 @@ namespace RestFrames {
   }
 
   bool Group::SplitState(const State* statePtr){
-    int N = m_JigsawsToUsePtr->GetN();
+    if(statePtr->GetNFrames() == 0) return false;
+    unordered_map<int, vector<Jigsaw*> >::const_iterator it =
+      m_FrameJigsaws.find(statePtr->GetFrameList()->Get(0)->GetKey());
+    if(it == m_FrameJigsaws.end()) return false;
+    // candidates are in the order of m_JigsawsToUsePtr
+    const vector<Jigsaw*>& jigsaws = it->second;
+    int N = jigsaws.size();
     Jigsaw *jigsawForSplitPtr = nullptr;
     for(int i = 0; i < N; i++){
-      Jigsaw *jigsawPtr = m_JigsawsToUsePtr->Get(i);
+      Jigsaw *jigsawPtr = jigsaws[i];
+      if(!m_JigsawsToUsePtr->Contains(jigsawPtr)) continue;
       if(jigsawPtr->CanSplit(statePtr)){
 	if(!jigsawForSplitPtr) jigsawForSplitPtr = jigsawPtr;
 	if(jigsawPtr->GetPriority() < jigsawForSplitPtr->GetPriority()) jigsawForSplitPtr = jigsawPtr;
@@ -173,7 +246,10 @@ namespace RestFrames {
     StateList* statesPtr = jigsawPtr->InitializeOutputStates(statePtr);
     m_StatesToSplitPtr->Remove(statePtr);
     m_StatesToSplitPtr->Add(statesPtr);
-    m_StatesPtr->Add(statesPtr);
+    if(statesPtr){
+      int N = statesPtr->GetN();
+      for(int i = 0; i < N; i++) AddState(statesPtr->Get(i));
+    }
     m_JigsawsPtr->Add(jigsawPtr);
     if(statesPtr) delete statesPtr;
     return;
@@ -181,11 +257,14 @@ namespace RestFrames {
 
   State* Group::GetState(const RestFrame* framePtr) const{
     if(!framePtr) return nullptr;
-    int Ns = m_StatesPtr->GetN();
-    for(int i = Ns-1; i >= 0; i--){
-      State* statePtr = m_StatesPtr->Get(i);
-      if(statePtr->IsFrame(framePtr)){
-	return statePtr;
+    unordered_map<int, vector<int> >::const_iterator it = m_FrameStates.find(framePtr->GetKey());
+    if(it != m_FrameStates.end()){
+      const vector<int>& states = it->second;
+      for(int i = int(states.size())-1; i >= 0; i--){
+	State* statePtr = m_StatesPtr->Get(states[i]);
+	if(statePtr->IsFrame(framePtr)){
+	  return statePtr;
+	}
       }
     }
     m_Mind = false;
@@ -199,46 +278,53 @@ namespace RestFrames {
     }
     if(!framesPtr) return false;
 
+    // only states holding one of the frames can be contained
+    // in them (other than empty ones, which are indexed by -1)
+    vector<int> candidates;
+    int Nf = framesPtr->GetN();
+    for(int f = -1; f < Nf; f++){
+      int key = f < 0 ? -1 : framesPtr->Get(f)->GetKey();
+      unordered_map<int, vector<int> >::const_iterator it = m_FrameStates.find(key);
+      if(it != m_FrameStates.end())
+	candidates.insert(candidates.end(), it->second.begin(), it->second.end());
+    }
+    sort(candidates.begin(), candidates.end());
+    candidates.erase(unique(candidates.begin(), candidates.end()), candidates.end());
+
     statesPtr = new StateList();
-    int Ns = m_StatesPtr->GetN();
-    for(int i = 0; i < Ns; i++){
-      State* istatePtr = m_StatesPtr->Get(i);
-      RestFrameList* iframesPtr = istatePtr->GetFrames();
+    int Ns = candidates.size();
+    for(int c = 0; c < Ns; c++){
+      State* istatePtr = m_StatesPtr->Get(candidates[c]);
+      const RestFrameList* iframesPtr = istatePtr->GetFrameList();
       if(framesPtr->Contains(iframesPtr)){
 	int Nsol = statesPtr->GetN();
 	bool isnew = true;
 	for(int j = 0; j < Nsol; j++){
 	  State* jstatePtr = statesPtr->Get(j);
-	  RestFrameList* jframesPtr = jstatePtr->GetFrames();
+	  const RestFrameList* jframesPtr = jstatePtr->GetFrameList();
 	  if(iframesPtr->Contains(jframesPtr)){
 	    statesPtr->Remove(jstatePtr);
-	    delete jframesPtr;
 	    break;
 	  }
 	  if(jframesPtr->Contains(iframesPtr)){
 	    isnew = false;
-	    delete jframesPtr;
 	    break;
 	  }
-	  delete jframesPtr;
 	}
 	if(isnew) statesPtr->Add(istatePtr);
       }
-      delete iframesPtr;
     }
-    RestFrameList* match_framesPtr = new RestFrameList();
+    RestFrameList match_frames;
     Ns = statesPtr->GetN();
     for(int i = 0; i < Ns; i++){
-      match_framesPtr->Add(statesPtr->Get(i)->GetFrames());
+      match_frames.Add(statesPtr->Get(i)->GetFrameList());
     }
-    if(!framesPtr->IsSame(match_framesPtr)){
-      delete match_framesPtr;
+    if(!framesPtr->IsSame(&match_frames)){
       delete statesPtr;
       statesPtr = nullptr;
       m_Mind = false;
       return false;
     }
-    delete match_framesPtr;
     return true;
   }
 
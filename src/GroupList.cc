@@ -61,8 +61,8 @@ namespace RestFrames {
 
   GroupList* GroupList::Copy() const {
     GroupList* groupsPtr = new GroupList();
-    int N = GetN();
-    for(int i = 0; i < N; i++) groupsPtr->Add(m_Groups[i]);
+    // entries are already unique
+    groupsPtr->m_Groups = m_Groups;
     return groupsPtr;
   }
 
@@ -73,12 +73,18 @@ namespace RestFrames {
     return new InvisibleState();
   }
 
+  InvisibleState* InvisibleJigsaw::GetChildInvisibleState(int i) const {
+    State* statePtr = GetChildState(i);
+    if(!statePtr || !statePtr->IsInvisibleState()) return nullptr;
+    return static_cast<InvisibleState*>(statePtr);
+  }
+
   double InvisibleJigsaw::GetMinimumMass(){
     if(!m_Mind) return 0.;
     int N = GetNChildStates();
     double M = 0.;
     for(int i = 0; i < N; i++){
-      InvisibleState* statePtr = dynamic_cast<InvisibleState*>(GetChildState(i));
+      InvisibleState* statePtr = GetChildInvisibleState(i);
       if(!statePtr) return 0.;
       M += statePtr->GetMinimumMass();
     }
@@ -91,31 +97,38 @@ namespace RestFrames {
    
     int Nchild = GetNChildStates();
     for(int i = 0; i < Nchild; i++){
-      InvisibleState* statePtr = dynamic_cast<InvisibleState*>(GetChildState(i));
+      InvisibleState* statePtr = GetChildInvisibleState(i);
       if(statePtr) statePtr->FillInvisibleMassJigsawDependancies(jigsawsPtr);
     }
   }
 
+  void InvisibleJigsaw::FillReadJigsaws(JigsawList* jigsawsPtr){
+    if(!jigsawsPtr) return;
+    Jigsaw::FillReadJigsaws(jigsawsPtr);
+    JigsawList jigsaws;
+    FillInvisibleMassJigsawDependancies(&jigsaws);
+    jigsawsPtr->Add(&jigsaws);
+  }
+
   bool InvisibleJigsaw::InitializeDependancyJigsaws(){
     if(!m_Mind) return false;
     m_DependancyJigsawsPtr->Clear();
 
-    JigsawList* jigsawsPtr = new JigsawList();
-    FillStateJigsawDependancies(jigsawsPtr);
-    jigsawsPtr->Remove(this);
-    m_DependancyJigsawsPtr->Add(jigsawsPtr);
+    JigsawList jigsaws;
+    FillStateJigsawDependancies(&jigsaws);
+    jigsaws.Remove(this);
+    m_DependancyJigsawsPtr->Add(&jigsaws);
 
-    jigsawsPtr->Clear();
-    FillInvisibleMassJigsawDependancies(jigsawsPtr);
-    jigsawsPtr->Remove(this);
-    m_DependancyJigsawsPtr->Add(jigsawsPtr);
+    jigsaws.Clear();
+    FillInvisibleMassJigsawDependancies(&jigsaws);
+    jigsaws.Remove(this);
+    m_DependancyJigsawsPtr->Add(&jigsaws);
 
-    jigsawsPtr->Clear();
-    FillGroupJigsawDependancies(jigsawsPtr);
-    jigsawsPtr->Remove(this);
-    m_DependancyJigsawsPtr->Add(jigsawsPtr);
+    jigsaws.Clear();
+    FillGroupJigsawDependancies(&jigsaws);
+    jigsaws.Remove(this);
+    m_DependancyJigsawsPtr->Add(&jigsaws);
 
-    delete jigsawsPtr;
     return m_Mind;
   }
 
@@ -124,12 +137,12 @@ namespace RestFrames {
     if(chain_jigsawPtr->Contains(this)) return true;
 
     // Add group dependancy jigsaws first
-    JigsawList* group_jigsawsPtr = new JigsawList();
-    FillGroupJigsawDependancies(group_jigsawsPtr);
-    group_jigsawsPtr->Remove(this);
-    int Ngroup = group_jigsawsPtr->GetN();
+    JigsawList group_jigsaws;
+    FillGroupJigsawDependancies(&group_jigsaws);
+    group_jigsaws.Remove(this);
+    int Ngroup = group_jigsaws.GetN();
     for(int i = Ngroup-1; i >= 0; i--){
-      Jigsaw* jigsawPtr = group_jigsawsPtr->Get(i);
+      Jigsaw* jigsawPtr = group_jigsaws.Get(i);
       if(!chain_jigsawPtr->Contains(jigsawPtr)){
 	if(!jigsawPtr->InitializeJigsawExecutionList(chain_jigsawPtr)){
 	  m_Mind = false;
@@ -30,7 +30,7 @@ namespace RestFrames {
     if(!m_Mind || !m_GroupPtr) return m_Spirit;
 
     TLorentzVector inv_P = m_InputStatePtr->GetFourVector();
-    double M = dynamic_cast<InvisibleState*>(m_OutputStatesPtr->Get(0))->GetMinimumMass();
+    double M = GetChildInvisibleState(0)->GetMinimumMass();
 
     inv_P.SetVectM(inv_P.Vect(),M);
     m_OutputStatesPtr->Get(0)->SetFourVector(inv_P);
@@ -39,4 +39,10 @@ namespace RestFrames {
     return m_Spirit;
   }
 
+  Jigsaw* InvisibleMassJigsaw::NewSearchCopy(StateMap& states) const {
+    InvisibleMassJigsaw* jigsawPtr = new InvisibleMassJigsaw(m_Name, m_Title, m_Key);
+    jigsawPtr->CopySearchStates(*this, states);
+    return jigsawPtr;
+  }
+
 }
@@ -52,4 +52,10 @@ namespace RestFrames {
     return m_Spirit;
   }
 
+  Jigsaw* InvisibleRapidityJigsaw::NewSearchCopy(StateMap& states) const {
+    InvisibleRapidityJigsaw* jigsawPtr = new InvisibleRapidityJigsaw(m_Name, m_Title, m_Key);
+    jigsawPtr->CopySearchStates(*this, states);
+    return jigsawPtr;
+  }
+
 }
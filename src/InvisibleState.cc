@@ -22,21 +22,28 @@ namespace RestFrames {
 
   void InvisibleState::Init(){
     m_Type = SInvisible;
+    m_InvisibleFramePtr = nullptr;
+  }
+
+  void InvisibleState::AddFrame(RestFrame* framePtr){
+    State::AddFrame(framePtr);
+    if(GetNFrames() == 1)
+      m_InvisibleFramePtr = dynamic_cast<RInvisibleFrame*>(m_Frames.Get(0));
   }
 
   double InvisibleState::GetMinimumMass(){
-    InvisibleJigsaw* jigsawPtr = dynamic_cast<InvisibleJigsaw*>(m_ChildJigsawPtr);
-    if(jigsawPtr) return jigsawPtr->GetMinimumMass();
-    if(GetNFrames() == 1){
-      RInvisibleFrame* framePtr = dynamic_cast<RInvisibleFrame*>(m_Frames.Get(0));
-      if(framePtr) return framePtr->GetMinimumMass();
-    }
+    if(m_ChildJigsawPtr && m_ChildJigsawPtr->IsInvisibleJigsaw())
+      return static_cast<InvisibleJigsaw*>(m_ChildJigsawPtr)->GetMinimumMass();
+    // the frame list may have been cleared and refilled
+    if(GetNFrames() == 1 && m_InvisibleFramePtr &&
+       static_cast<RestFrame*>(m_InvisibleFramePtr) == m_Frames.Get(0))
+      return m_InvisibleFramePtr->GetMinimumMass();
     return 0.;
   }
 
   void InvisibleState::FillInvisibleMassJigsawDependancies(JigsawList* jigsawsPtr){
-    InvisibleJigsaw* jigsawPtr = dynamic_cast<InvisibleJigsaw*>(m_ChildJigsawPtr);
-    if(jigsawPtr) jigsawPtr->FillInvisibleMassJigsawDependancies(jigsawsPtr);
+    if(m_ChildJigsawPtr && m_ChildJigsawPtr->IsInvisibleJigsaw())
+      static_cast<InvisibleJigsaw*>(m_ChildJigsawPtr)->FillInvisibleMassJigsawDependancies(jigsawsPtr);
   }
 
 }
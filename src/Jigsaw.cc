@@ -1,4 +1,5 @@
 #include "RestFrames/Jigsaw.hh"
+#include "RestFrames/EventTrace.hh"
 
 using namespace std;
 
@@ -35,6 +36,7 @@ namespace RestFrames {
     m_Priority = 0.;
     m_GroupPtr = nullptr;
     m_InputStatePtr = nullptr;
+    m_TracePtr = nullptr;
     m_DependancyJigsawsPtr = new JigsawList();
     m_OutputStatesPtr = new StateList();
   }
@@ -104,6 +106,66 @@ namespace RestFrames {
     return m_Type == JCombinatoric;
   }
 
+  bool Jigsaw::Execute(){
+    if(!m_TracePtr) return AnalyzeEvent();
+    m_TracePtr->StartJigsaw(this);
+    bool ok = AnalyzeEvent();
+    m_TracePtr->StopJigsaw(this, ok);
+    return ok;
+  }
+
+  void Jigsaw::SetEventTrace(EventTrace* tracePtr){
+    m_TracePtr = tracePtr;
+  }
+
+  Jigsaw* Jigsaw::NewSearchCopy(StateMap& states) const {
+    return nullptr;
+  }
+
+  State* Jigsaw::GetSearchState(const StateMap& states, State* statePtr){
+    StateMap::const_iterator it = states.find(statePtr);
+    if(it == states.end()) return statePtr;
+    return it->second;
+  }
+
+  // the copy owns its output states and lists, and shares
+  // the states that are not copied
+  void Jigsaw::CopySearchStates(const Jigsaw& jigsaw, StateMap& states){
+    m_Body = jigsaw.m_Body;
+    m_Mind = jigsaw.m_Mind;
+    m_Priority = jigsaw.m_Priority;
+    m_GroupPtr = jigsaw.m_GroupPtr;
+    m_InputStatePtr = GetSearchState(states, jigsaw.m_InputStatePtr);
+
+    int Nof = jigsaw.m_OutputFrames.size();
+    for(int i = 0; i < Nof; i++) m_OutputFrames.push_back(jigsaw.m_OutputFrames[i]->Copy());
+    int Ndf = jigsaw.m_DependancyFrames.size();
+    for(int i = 0; i < Ndf; i++) m_DependancyFrames.push_back(jigsaw.m_DependancyFrames[i]->Copy());
+
+    int Nos = jigsaw.m_OutputStatesPtr->GetN();
+    for(int i = 0; i < Nos; i++){
+      State* outputPtr = jigsaw.m_OutputStatesPtr->Get(i);
+      State* statePtr = NewOutputState();
+      const RestFrameList* framesPtr = outputPtr->GetFrameList();
+      int Nf = framesPtr->GetN();
+      for(int f = 0; f < Nf; f++) statePtr->AddFrame(framesPtr->Get(f));
+      statePtr->SetParentJigsaw(this);
+      statePtr->SetChildJigsaw(outputPtr->GetChildJigsaw());
+      statePtr->SetFourVector(outputPtr->GetFourVector());
+      m_OutputStatesPtr->Add(statePtr);
+      states[outputPtr] = statePtr;
+    }
+
+    int Nds = jigsaw.m_DependancyStates.size();
+    for(int d = 0; d < Nds; d++){
+      StateList* statesPtr = new StateList();
+      int N = jigsaw.m_DependancyStates[d]->GetN();
+      for(int i = 0; i < N; i++)
+	statesPtr->Add(GetSearchState(states, jigsaw.m_DependancyStates[d]->Get(i)));
+      m_DependancyStates.push_back(statesPtr);
+    }
+  }
+
   void Jigsaw::SetGroup(Group* groupPtr){
     m_GroupPtr = groupPtr;
   }
@@ -115,7 +177,18 @@ namespace RestFrames {
   bool Jigsaw::CanSplit(const RestFrameList* framesPtr){
     if(!framesPtr) return false;
 
+    // the outputs cannot cover framesPtr if any is larger
+    // or if they are smaller in total
     int NoF = m_OutputFrames.size();
+    int Nf = framesPtr->GetN();
+    int Nsum = 0;
+    for(int i = 0; i < NoF; i++){
+      int N = m_OutputFrames[i]->GetN();
+      if(N > Nf) return false;
+      Nsum += N;
+    }
+    if(Nsum < Nf) return false;
+
     RestFrameList frames;
     for(int i = 0; i < NoF; i++){
       frames.Add(m_OutputFrames[i]);
@@ -125,10 +198,7 @@ namespace RestFrames {
 
   bool Jigsaw::CanSplit(const State* statePtr){
     if(!statePtr) return false;
-    RestFrameList* framesPtr = statePtr->GetFrames();
-    bool ret = CanSplit(framesPtr);
-    delete framesPtr;
-    return ret;
+    return CanSplit(statePtr->GetFrameList());
   }
 
   State* Jigsaw::NewOutputState(){
@@ -169,10 +239,10 @@ namespace RestFrames {
       Ngroup = 0;
     }
     int Ndep = m_DependancyFrames.size();
+    vector<RestFrameList> group_frames(Ngroup);
     for(int d = 0; d < Ndep; d++){
       m_DependancyStates.push_back(new StateList());
-      vector<RestFrameList*>* group_framesPtr = new vector<RestFrameList*>;
-      for(int i = 0; i < Ngroup; i++) group_framesPtr->push_back(new RestFrameList());
+      for(int g = 0; g < Ngroup; g++) group_frames[g].Clear();
       RestFrameList* framesPtr = m_DependancyFrames[d];
       int Nf = framesPtr->GetN();
       for(int f = 0; f < Nf; f++){
@@ -180,7 +250,7 @@ namespace RestFrames {
 	bool no_group = true;
 	for(int g = 0; g < Ngroup; g++){
 	  if(groupsPtr->Get(g)->ContainsFrame(framePtr)){
-	    group_framesPtr->at(g)->Add(framePtr);
+	    group_frames[g].Add(framePtr);
 	    no_group = false;
 	    break;
 	  }
@@ -193,14 +263,12 @@ namespace RestFrames {
       }
       for(int g = 0; g < Ngroup; g++){
 	StateList* group_statesPtr = nullptr;
-	if(group_framesPtr->at(g)->GetN() > 0){
-	  if(!groupsPtr->Get(g)->GetState(group_framesPtr->at(g),group_statesPtr)) m_Mind = false;
+	if(group_frames[g].GetN() > 0){
+	  if(!groupsPtr->Get(g)->GetState(&group_frames[g],group_statesPtr)) m_Mind = false;
 	  m_DependancyStates[d]->Add(group_statesPtr);
 	  delete group_statesPtr;
 	}
-	delete group_framesPtr->at(g);
       }
-      delete group_framesPtr;
     }
     return m_Mind;
   } 
@@ -209,17 +277,16 @@ namespace RestFrames {
     if(!m_Mind) return false;
     m_DependancyJigsawsPtr->Clear();
 
-    JigsawList* jigsawsPtr = new JigsawList();
-    FillStateJigsawDependancies(jigsawsPtr);
-    jigsawsPtr->Remove(this);
-    m_DependancyJigsawsPtr->Add(jigsawsPtr);
+    JigsawList jigsaws;
+    FillStateJigsawDependancies(&jigsaws);
+    jigsaws.Remove(this);
+    m_DependancyJigsawsPtr->Add(&jigsaws);
 
-    jigsawsPtr->Clear();
-    FillGroupJigsawDependancies(jigsawsPtr);
-    jigsawsPtr->Remove(this);
-    m_DependancyJigsawsPtr->Add(jigsawsPtr);
+    jigsaws.Clear();
+    FillGroupJigsawDependancies(&jigsaws);
+    jigsaws.Remove(this);
+    m_DependancyJigsawsPtr->Add(&jigsaws);
 
-    delete jigsawsPtr;
     return m_Mind;
   }
 
@@ -250,6 +317,18 @@ namespace RestFrames {
     }
   }
 
+  // each Fill stops at jigsaws already in its list,
+  // so each starts from an empty one
+  void Jigsaw::FillReadJigsaws(JigsawList* jigsawsPtr){
+    if(!jigsawsPtr) return;
+    JigsawList jigsaws;
+    FillStateJigsawDependancies(&jigsaws);
+    jigsawsPtr->Add(&jigsaws);
+    jigsaws.Clear();
+    FillGroupJigsawDependancies(&jigsaws);
+    jigsawsPtr->Add(&jigsaws);
+  }
+
   void Jigsaw::AddOutputFrame(RestFrame* framePtr, int i){
     if(!framePtr) return;
     if(!m_GroupPtr) return;
@@ -300,6 +379,10 @@ namespace RestFrames {
   }
 
 
+  double Jigsaw::GetExecutionCost() const {
+    return 1.;
+  }
+
   int Jigsaw::GetNChildStates() const {
     return m_OutputFrames.size();
   }
@@ -326,4 +409,20 @@ namespace RestFrames {
     return child_framesPtr;
   }
 
+  RestFrameList* Jigsaw::GetOutputFrames() const {
+    RestFrameList* framesPtr = new RestFrameList();
+    int N = m_OutputFrames.size();
+    for(int i = 0; i < N; i++) framesPtr->Add(m_OutputFrames[i]);
+    return framesPtr;
+  }
+
+  int Jigsaw::GetNDependancyFrames() const {
+    return m_DependancyFrames.size();
+  }
+
+  RestFrameList* Jigsaw::GetDependancyFrames(int i) const {
+    if(i < 0 || i >= GetNDependancyFrames()) return nullptr;
+    return m_DependancyFrames[i]->Copy();
+  }
+
 }
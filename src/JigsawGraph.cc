@@ -0,0 +1,289 @@
+#include <map>
+#include <algorithm>
+#include "RestFrames/JigsawGraph.hh"
+#include "RestFrames/CombinatoricJigsaw.hh"
+
+using namespace std;
+
+namespace RestFrames {
+
+  ///////////////////////////////////////////////
+  // JigsawGraph class methods
+  ///////////////////////////////////////////////
+  JigsawGraph::JigsawGraph(){ }
+
+  JigsawGraph::~JigsawGraph(){
+    Clear();
+  }
+
+  void JigsawGraph::Clear(){
+    m_Jigsaws.clear();
+    m_Dependancies.clear();
+    m_Level.clear();
+    m_Levels.clear();
+  }
+
+  bool JigsawGraph::Build(const JigsawList* chainPtr){
+    Clear();
+    if(!chainPtr) return false;
+    int N = chainPtr->GetN();
+    map<int,int> index_of;
+    for(int i = 0; i < N; i++){
+      m_Jigsaws.push_back(chainPtr->Get(i));
+      index_of[m_Jigsaws[i]->GetKey()] = i;
+    }
+
+    // the states of the graph are the outputs of each jigsaw k:
+    // writers[k] and readers[k] list the jigsaws that write or
+    // read them, and writes[i] and reads[i] the states jigsaw i
+    // writes or reads. A combinatoric jigsaw also writes the outputs
+    // of the jigsaws it executes for each hypothesis, and reads
+    // whatever they read
+    vector<vector<int> > writers(N);
+    vector<vector<int> > readers(N);
+    vector<vector<int> > writes(N);
+    vector<vector<int> > reads(N);
+
+    // the states each jigsaw reads when executed
+    vector<vector<int> > read_states(N);
+    for(int k = 0; k < N; k++){
+      JigsawList read_jigsaws;
+      m_Jigsaws[k]->FillReadJigsaws(&read_jigsaws);
+      int Nr = read_jigsaws.GetN();
+      for(int r = 0; r < Nr; r++){
+	map<int,int>::const_iterator it = index_of.find(read_jigsaws.Get(r)->GetKey());
+	if(it != index_of.end()) read_states[k].push_back(it->second);
+      }
+    }
+
+    vector<int> mark(N, -1);
+    vector<int> owned;
+    for(int i = 0; i < N; i++){
+      owned.assign(1, i);
+      if(m_Jigsaws[i]->IsCombinatoricJigsaw()){
+	JigsawList* executePtr = static_cast<CombinatoricJigsaw*>(m_Jigsaws[i])->GetExecuteJigsaws();
+	int Ne = executePtr->GetN();
+	for(int e = 0; e < Ne; e++){
+	  map<int,int>::const_iterator it = index_of.find(executePtr->Get(e)->GetKey());
+	  if(it == index_of.end()){
+	    delete executePtr;
+	    return false;
+	  }
+	  if(it->second != i) owned.push_back(it->second);
+	}
+	delete executePtr;
+      }
+      int No = owned.size();
+      for(int o = 0; o < No; o++){
+	int k = owned[o];
+	writers[k].push_back(i);
+	writes[i].push_back(k);
+
+	int Nr = read_states[k].size();
+	for(int r = 0; r < Nr; r++){
+	  int state = read_states[k][r];
+	  if(mark[state] == i) continue;
+	  mark[state] = i;
+	  readers[state].push_back(i);
+	  reads[i].push_back(state);
+	}
+      }
+    }
+
+    // jigsaw i depends on each earlier jigsaw that writes a state
+    // it reads or writes, or reads a state it writes
+    m_Dependancies.resize(N);
+    m_Level.assign(N, 0);
+    mark.assign(N, -1);
+    int Nlevel = 0;
+    for(int i = 0; i < N; i++){
+      vector<int>& deps = m_Dependancies[i];
+      for(int pass = 0; pass < 3; pass++){
+	const vector<int>& states = pass == 1 ? reads[i] : writes[i];
+	int Ns = states.size();
+	for(int s = 0; s < Ns; s++){
+	  const vector<int>& others = pass == 2 ? readers[states[s]] : writers[states[s]];
+	  int No = others.size();
+	  for(int o = 0; o < No; o++){
+	    int j = others[o];
+	    if(j >= i || mark[j] == i) continue;
+	    mark[j] = i;
+	    deps.push_back(j);
+	    m_Level[i] = max(m_Level[i], m_Level[j]+1);
+	  }
+	}
+      }
+      sort(deps.begin(), deps.end());
+      Nlevel = max(Nlevel, m_Level[i]+1);
+    }
+    m_Levels.resize(Nlevel);
+    for(int i = 0; i < N; i++) m_Levels[m_Level[i]].push_back(i);
+    return true;
+  }
+
+  int JigsawGraph::GetNJigsaws() const {
+    return m_Jigsaws.size();
+  }
+
+  Jigsaw* JigsawGraph::GetJigsaw(int i) const {
+    if(i < 0 || i >= GetNJigsaws()) return nullptr;
+    return m_Jigsaws[i];
+  }
+
+  int JigsawGraph::GetIndex(const Jigsaw* jigsawPtr) const {
+    int N = GetNJigsaws();
+    for(int i = 0; i < N; i++)
+      if(m_Jigsaws[i]->IsSame(jigsawPtr)) return i;
+    return -1;
+  }
+
+  int JigsawGraph::GetNDependancies(int i) const {
+    if(i < 0 || i >= GetNJigsaws()) return 0;
+    return m_Dependancies[i].size();
+  }
+
+  int JigsawGraph::GetDependancy(int i, int d) const {
+    if(d < 0 || d >= GetNDependancies(i)) return -1;
+    return m_Dependancies[i][d];
+  }
+
+  int JigsawGraph::GetNLevels() const {
+    return m_Levels.size();
+  }
+
+  int JigsawGraph::GetLevel(int i) const {
+    if(i < 0 || i >= GetNJigsaws()) return -1;
+    return m_Level[i];
+  }
+
+  const vector<int>& JigsawGraph::GetLevelJigsaws(int level) const {
+    static const vector<int> empty;
+    if(level < 0 || level >= GetNLevels()) return empty;
+    return m_Levels[level];
+  }
+
+  ///////////////////////////////////////////////
+  // JigsawExecutor class methods
+  ///////////////////////////////////////////////
+  JigsawExecutor::JigsawExecutor(int Nthread){
+    m_NThreads = max(1, Nthread);
+    m_CostThreshold = 1000.;
+    m_TaskPtr = nullptr;
+    m_NTasks = 0;
+    m_NextTask = 0;
+    m_NPending = 0;
+    m_Failed = false;
+    m_Stop = false;
+    for(int i = 1; i < m_NThreads; i++)
+      m_Workers.push_back(thread(&JigsawExecutor::WorkerLoop, this));
+  }
+
+  JigsawExecutor::~JigsawExecutor(){
+    {
+      lock_guard<mutex> lock(m_Mutex);
+      m_Stop = true;
+      m_TaskCondition.notify_all();
+    }
+    int N = m_Workers.size();
+    for(int i = 0; i < N; i++) m_Workers[i].join();
+  }
+
+  int JigsawExecutor::GetNThreads() const {
+    return m_NThreads;
+  }
+
+  void JigsawExecutor::SetCostThreshold(double cost){
+    m_CostThreshold = cost;
+  }
+
+  double JigsawExecutor::GetCostThreshold() const {
+    return m_CostThreshold;
+  }
+
+  bool JigsawExecutor::Execute(const JigsawGraph& graph){
+    int Nlevel = graph.GetNLevels();
+    for(int l = 0; l < Nlevel; l++){
+      const vector<int>& level = graph.GetLevelJigsaws(l);
+      m_Inline.clear();
+      m_Staged.clear();
+      int N = level.size();
+      for(int i = 0; i < N; i++){
+	Jigsaw* jigsawPtr = graph.GetJigsaw(level[i]);
+	if(m_NThreads > 1 && jigsawPtr->GetExecutionCost() >= m_CostThreshold)
+	  m_Staged.push_back(jigsawPtr);
+	else
+	  m_Inline.push_back(jigsawPtr);
+      }
+      // a single expensive jigsaw gains nothing from a hand-off
+      if(m_Staged.size() == 1){
+	m_Inline.push_back(m_Staged[0]);
+	m_Staged.clear();
+      }
+
+      unique_lock<mutex> lock(m_Mutex);
+      m_Tasks.swap(m_Staged);
+      m_NTasks = m_Tasks.size();
+      m_NextTask = 0;
+      m_NPending = m_NTasks;
+      m_Failed = false;
+      if(m_NPending > 0) m_TaskCondition.notify_all();
+      lock.unlock();
+
+      bool ok = true;
+      int Ninline = m_Inline.size();
+      for(int i = 0; i < Ninline; i++)
+	if(!m_Inline[i]->AnalyzeEvent()) ok = false;
+
+      lock.lock();
+      RunTasks(lock);
+      while(m_NPending > 0) m_DoneCondition.wait(lock);
+      if(m_Failed) ok = false;
+      m_Tasks.clear();
+      m_NTasks = 0;
+      lock.unlock();
+      if(!ok) return false;
+    }
+    return true;
+  }
+
+  bool JigsawExecutor::Run(int Ntask, const function<bool(int)>& task){
+    if(Ntask <= 0) return true;
+    unique_lock<mutex> lock(m_Mutex);
+    m_TaskPtr = &task;
+    m_NTasks = Ntask;
+    m_NextTask = 0;
+    m_NPending = Ntask;
+    m_Failed = false;
+    if(m_NThreads > 1 && Ntask > 1) m_TaskCondition.notify_all();
+    RunTasks(lock);
+    while(m_NPending > 0) m_DoneCondition.wait(lock);
+    bool ok = !m_Failed;
+    m_TaskPtr = nullptr;
+    m_NTasks = 0;
+    return ok;
+  }
+
+  // takes tasks of the current level until none are left
+  void JigsawExecutor::RunTasks(unique_lock<mutex>& lock){
+    while(m_NextTask < m_NTasks){
+      int i = m_NextTask;
+      m_NextTask++;
+      lock.unlock();
+      bool ok = m_TaskPtr ? (*m_TaskPtr)(i) : m_Tasks[i]->AnalyzeEvent();
+      lock.lock();
+      if(!ok) m_Failed = true;
+      m_NPending--;
+      if(m_NPending == 0) m_DoneCondition.notify_all();
+    }
+  }
+
+  void JigsawExecutor::WorkerLoop(){
+    unique_lock<mutex> lock(m_Mutex);
+    while(true){
+      while(!m_Stop && m_NextTask >= m_NTasks) m_TaskCondition.wait(lock);
+      if(m_Stop) break;
+      RunTasks(lock);
+    }
+  }
+
+}
@@ -1,3 +1,4 @@
+#include <algorithm>
 #include "RestFrames/JigsawList.hh"
 
 using namespace std;
@@ -13,8 +14,18 @@ namespace RestFrames {
     Clear();
   }
 
+  void JigsawList::AddKey(int key){
+    m_Keys.insert(lower_bound(m_Keys.begin(), m_Keys.end(), key), key);
+  }
+
+  void JigsawList::RemoveKey(int key){
+    vector<int>::iterator it = lower_bound(m_Keys.begin(), m_Keys.end(), key);
+    if(it != m_Keys.end() && *it == key) m_Keys.erase(it);
+  }
+
   void JigsawList::Clear(){
     m_Jigsaws.clear();
+    m_Keys.clear();
   }
 
   Jigsaw* JigsawList::Get(int i) const { 
@@ -27,10 +38,9 @@ namespace RestFrames {
   }
   bool JigsawList::Add(Jigsaw* jigsawPtr){
     if(!jigsawPtr) return false;
-    int N = GetN();
-    for(int i = 0; i < N; i++)
-      if(jigsawPtr->IsSame(m_Jigsaws[i])) return false;
+    if(Contains(jigsawPtr)) return false;
     m_Jigsaws.push_back(jigsawPtr);
+    AddKey(jigsawPtr->GetKey());
     return true;
   }
 
@@ -45,11 +55,12 @@ namespace RestFrames {
   }
 
   void JigsawList::Remove(const Jigsaw* jigsawPtr){
-    if(!jigsawPtr) return;
+    if(!Contains(jigsawPtr)) return;
     int N = GetN();
     for(int i = 0; i < N; i++){
       if(jigsawPtr->GetKey() == m_Jigsaws[i]->GetKey()){
 	m_Jigsaws.erase(m_Jigsaws.begin()+i);
+	RemoveKey(jigsawPtr->GetKey());
 	return;
       }
     }
@@ -62,11 +73,8 @@ namespace RestFrames {
   }
 
   bool JigsawList::Contains(const Jigsaw *jigsawPtr) const {
-    int N = GetN();
-    for(int i = 0; i < N; i++){
-      if(jigsawPtr->GetKey() == m_Jigsaws[i]->GetKey()) return true;
-    }
-    return false;
+    if(!jigsawPtr) return false;
+    return binary_search(m_Keys.begin(), m_Keys.end(), jigsawPtr->GetKey());
   }
 
   int JigsawList::GetIndex(const Jigsaw* jigsawPtr) const {
@@ -79,8 +87,9 @@ namespace RestFrames {
 
   JigsawList* JigsawList::Copy() const {
     JigsawList* jigsawsPtr = new JigsawList();
-    int N = GetN();
-    for(int i = 0; i < N; i++) jigsawsPtr->Add(m_Jigsaws[i]);
+    // entries are already unique
+    jigsawsPtr->m_Jigsaws = m_Jigsaws;
+    jigsawsPtr->m_Keys = m_Keys;
     return jigsawsPtr;
   }
 
@@ -2,6 +2,7 @@
 #include "RestFrames/LabFrame.hh"
 #include "RestFrames/VisibleFrame.hh"
 #include "RestFrames/RestFrameList.hh"
+#include "RestFrames/FrameLog.hh"
 
 using namespace std;
 
@@ -46,23 +47,20 @@ namespace RestFrames {
   bool LabFrame::InitializeTree() const {
     vector<int>* KEYS = new vector<int>;
     if(IsCircularTree(KEYS)){
-      cout << endl << "Consistent Topology Failure: ";
-      cout << "Tree is circular in construction" << endl;
+      RF_LOG(LogError, "Consistent Topology Failure: Tree is circular in construction", this);
       KEYS->clear();
       return false;
     }
     KEYS->clear();
  
     if(!IsConsistentAnaTree(m_Ana)){
-      cout << endl << "Consistent Topology Failure: ";
-      cout << "Tree contains mixture of node types (Reco, Gen)" << endl;
+      RF_LOG(LogError, "Consistent Topology Failure: Tree contains mixture of node types (Reco, Gen)", this);
       KEYS->clear();
       return false;
     }
 
     if(!IsSoundBodyRecursive()){
-      cout << endl << "Consistent Topology Failure: ";
-      cout << "UnSound frame in tree" << endl;
+      RF_LOG(LogError, "Consistent Topology Failure: UnSound frame in tree", this);
       return false;
     }
     
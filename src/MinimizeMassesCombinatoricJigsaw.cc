@@ -8,12 +8,12 @@ namespace RestFrames {
   // MinimizeMassesCombinatoricJigsaw class methods
   ///////////////////////////////////////////////
   MinimizeMassesCombinatoricJigsaw::MinimizeMassesCombinatoricJigsaw(const string& sname, const string& stitle) : 
-    CombinatoricJigsaw(sname, stitle)
+    ObjectiveCombinatoricJigsaw<MaximizeMomentumObjective>(sname, stitle)
   {
     Init();
   }
   MinimizeMassesCombinatoricJigsaw::MinimizeMassesCombinatoricJigsaw(const string& sname, const string& stitle, int ikey) : 
-    CombinatoricJigsaw(sname, stitle, ikey)
+    ObjectiveCombinatoricJigsaw<MaximizeMomentumObjective>(sname, stitle, ikey)
   {
     Init();
   }
@@ -40,7 +40,6 @@ namespace RestFrames {
     if(int(m_Inputs.size()) < m_NForOutput[0]+m_NForOutput[1]) return false;
 
     int Ninput = m_Inputs.size();
-    int Ndeps = m_DependancyStates.size();
     vector<TLorentzVector> inputs;
     for(int i = 0; i < Ninput; i++) inputs.push_back(m_Inputs[i]->GetFourVector());
 
@@ -48,6 +47,9 @@ namespace RestFrames {
       (m_NForOutput[1] == 1) && 
       !m_NExclusive[0] && 
       !m_NExclusive[1] &&
+      !m_Constrained &&
+      (m_Solutions.GetNMax() == 1) &&
+      !UseLocalSearch() &&
       (int(m_DependancyStates.size()) <= 0);
     
     //////////////////////////////////////
@@ -110,87 +112,24 @@ namespace RestFrames {
 	int ihem = int(inputs[i].Vect().Dot(nRef) > 0.);
 	m_Outputs[ihem]->AddElement(m_Inputs[i]);
       }
-      if(m_Outputs[1]->GetFourVector().M() > m_Outputs[0]->GetFourVector().M()){
+      if(m_Outputs[1]->GetMass() > m_Outputs[0]->GetMass()){
 	vector<StateList*> flip;
 	for(int i = 0; i < 2; i++) flip.push_back(m_Outputs[i]->GetElements());
 	for(int i = 0; i < 2; i++) m_Outputs[i]->ClearElements();
 	for(int i = 0; i < 2; i++) m_Outputs[i]->AddElement(flip[!i]);
 	for(int i = 0; i < 2; i++) delete flip[i];
       }
+      m_Solutions.Add(-val_max, GetCurrentCombinatoric());
+      m_Solutions.Sort();
+      // Execute depedancy Jigsaws
+      ExecuteDependancyJigsaws();
     } 
     //////////////////////////////////////
     // NlogN 2^N brute force 
     //////////////////////////////////////
     if(!DO_HEM){
-      if(m_NExclusive[0] && m_NExclusive[1])
-	if(Ninput != m_NForOutput[0]+m_NForOutput[1]) return false;
-      if(Ninput < m_NForOutput[0]+m_NForOutput[1]) return false;
-      
-      int N_comb = 1;
-      for(int i = 0; i < Ninput; i++) N_comb *= 2;
-      
-      int c_max = -1;
-      double val_max = -1; 
-      // Loop through combinatorics
-      for(int c = 0; c < N_comb; c++){
-	int key = c;
-	int Nhem[2];
-	TLorentzVector hem[2];
-	for(int i = 0; i < 2; i++){
-	  Nhem[i] = 0;
-	  m_Outputs[i]->ClearElements();
-	  hem[i].SetPxPyPzE(0.,0.,0.,0.);
-	} 
-	// set output states for combinatoric;
-	for(int i = 0; i < Ninput; i++){
-	  int ihem = key%2;
-	  key /= 2;
-	  Nhem[ihem]++;
-	  hem[ihem] += inputs[i];
-	  m_Outputs[ihem]->AddElement(m_Inputs[i]);
-	}
-	// check validity of combinatoric
-	bool valid = true;
-	for(int i = 0; i < 2; i++){
-	  if(m_NExclusive[i]){
-	    if(Nhem[i] != m_NForOutput[i]) valid = false;
-	  } else {
-	    if(Nhem[i] < m_NForOutput[i]) valid = false;
-	  }
-	}
-	if(!valid) continue;
-	// Execute depedancy Jigsaws
-	ExecuteDependancyJigsaws();
-	// Evaluate metric for this cominatoric
-	for(int i = 0; i < Ndeps;  i++){
-	  hem[i] += m_DependancyStates[i]->GetFourVector();
-	  // Nhem[i] += m_DependancyStates[i]->GetN();
-	}
-	TVector3 boost = (hem[0]+hem[1]).BoostVector();
-	hem[0].Boost(-boost);
-	hem[1].Boost(-boost);
-	double val = hem[0].P()+hem[1].P();
-	if(Nhem[0] == 0 || Nhem[1] == 0){
-	  val = 0.; // cout << "zero in Nhem " << val << endl;
-	}
-	if(val >= val_max){
-	  val_max = val;
-	  c_max = c;
-	}
-      }
-      if(c_max < 0) return false;
-     
-      // Set outputs to best combinatoric
-      for(int i = 0; i < 2; i++) m_Outputs[i]->ClearElements();
-      int key = c_max;
-      for(int i = 0; i < Ninput; i++){
-	int ihem = key%2;
-	key /= 2;
-	m_Outputs[ihem]->AddElement(m_Inputs[i]);
-      }
+      if(!AnalyzeCombinatorics()) return false;
     }
-    // Execute depedancy Jigsaws
-    ExecuteDependancyJigsaws();
 
     m_Spirit = true;
     return m_Spirit;
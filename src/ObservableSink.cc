@@ -0,0 +1,309 @@
+#include <cstring>
+#include <RZip.h>
+#include "RestFrames/ObservableSink.hh"
+#include "RestFrames/FrameLog.hh"
+
+using namespace std;
+
+namespace RestFrames {
+
+  double EvaluateObservable(ObservableType type, const RestFrame& frame){
+    switch(type){
+    case OMass:                  return frame.GetMass();
+    case OCosDecayAngle:         return frame.GetCosDecayAngle();
+    case ODeltaPhiDecayAngle:    return frame.GetDeltaPhiDecayAngle();
+    case ODeltaPhiBoostVisible:  return frame.GetDeltaPhiBoostVisible();
+    case ODeltaPhiDecayVisible:  return frame.GetDeltaPhiDecayVisible();
+    case ODeltaPhiVisible:       return frame.GetDeltaPhiVisible();
+    case OVisibleShape:          return frame.GetVisibleShape();
+    case OScalarVisibleMomentum: return frame.GetScalarVisibleMomentum();
+    default:                     return 0.;
+    }
+  }
+
+  ///////////////////////////////////////////////
+  // ObservableSink class methods
+  ///////////////////////////////////////////////
+  ObservableSink::ObservableSink(const string& sname, const string& stitle){
+    m_Name = sname;
+    m_Title = stitle;
+    m_ChunkSize = 4096;
+    m_CompressionLevel = 0;
+    m_Background = false;
+    m_SinglePrecision = false;
+    m_NRows = 0;
+    m_File = nullptr;
+    m_WriteError = false;
+    m_BufferRows[0] = 0;
+    m_BufferRows[1] = 0;
+    m_Active = 0;
+    m_Pending = -1;
+    m_Stop = false;
+  }
+
+  ObservableSink::~ObservableSink(){
+    Close();
+  }
+
+  string ObservableSink::GetName() const {
+    return m_Name;
+  }
+
+  string ObservableSink::GetTitle() const {
+    return m_Title;
+  }
+
+  int ObservableSink::AddObservable(const string& name){
+    if(m_File) return -1;
+    m_Names.push_back(name);
+    m_Types.push_back(OValue);
+    m_Frames.push_back(nullptr);
+    m_Values.push_back(0.);
+    return m_Names.size()-1;
+  }
+
+  int ObservableSink::AddObservable(const string& name, ObservableType type, const RestFrame& frame){
+    if(type == OValue) return AddObservable(name);
+    int index = AddObservable(name);
+    if(index < 0) return index;
+    m_Types[index] = type;
+    m_Frames[index] = &frame;
+    return index;
+  }
+
+  int ObservableSink::AddMass(const string& name, const RestFrame& frame){
+    return AddObservable(name, OMass, frame);
+  }
+
+  int ObservableSink::AddCosDecayAngle(const string& name, const RestFrame& frame){
+    return AddObservable(name, OCosDecayAngle, frame);
+  }
+
+  int ObservableSink::AddVisibleShape(const string& name, const RestFrame& frame){
+    return AddObservable(name, OVisibleShape, frame);
+  }
+
+  int ObservableSink::GetNObservables() const {
+    return m_Names.size();
+  }
+
+  void ObservableSink::SetChunkSize(int N){
+    if(m_File) return;
+    // compressed buffers are limited to 2^24-1 bytes
+    if(N > 0) m_ChunkSize = min(N, 0xffffff/8);
+  }
+
+  void ObservableSink::SetCompressionLevel(int level){
+    if(m_File) return;
+    m_CompressionLevel = max(0, min(9, level));
+  }
+
+  void ObservableSink::SetBackgroundWriting(bool background){
+    if(m_File) return;
+    m_Background = background;
+  }
+
+  void ObservableSink::SetSinglePrecision(bool single){
+    if(m_File) return;
+    m_SinglePrecision = single;
+  }
+
+  bool ObservableSink::Open(const string& filename){
+    if(m_File) return false;
+    int Ncol = m_Names.size();
+    if(Ncol <= 0) return false;
+
+    InitializeAngles();
+
+    m_File = fopen(filename.c_str(), "wb");
+    if(!m_File){
+      RF_LOG(LogError, "unable to open", "ObservableSink " + m_Name + ": unable to open " + filename);
+      return false;
+    }
+    unsigned int head[2] = {m_SinglePrecision ? 2u : 1u, (unsigned int)Ncol};
+    fwrite("RFCOLUMN", 1, 8, m_File);
+    fwrite(head, sizeof(unsigned int), 2, m_File);
+    for(int i = 0; i < Ncol; i++){
+      unsigned int len = m_Names[i].size();
+      fwrite(&len, sizeof(len), 1, m_File);
+      fwrite(m_Names[i].c_str(), 1, len, m_File);
+    }
+
+    for(int b = 0; b < 2; b++){
+      m_Buffer[b].assign(Ncol*m_ChunkSize, 0.);
+      m_BufferRows[b] = 0;
+    }
+    m_Active = 0;
+    m_NRows = 0;
+    m_WriteError = false;
+    m_Pending = -1;
+    m_Stop = false;
+    if(m_Background) m_Writer = thread(&ObservableSink::WriterLoop, this);
+    return true;
+  }
+
+  bool ObservableSink::IsOpen() const {
+    return m_File != nullptr;
+  }
+
+  long ObservableSink::GetNRows() const {
+    return m_NRows;
+  }
+
+  void ObservableSink::SetValue(int index, double val){
+    if(index < 0 || index >= int(m_Values.size())) return;
+    m_Values[index] = val;
+  }
+
+  bool ObservableSink::IsAngle(ObservableType type) const {
+    return type == OCosDecayAngle || type == ODeltaPhiDecayAngle ||
+      type == ODeltaPhiBoostVisible || type == ODeltaPhiDecayVisible ||
+      type == ODeltaPhiVisible;
+  }
+
+  void ObservableSink::InitializeAngles(){
+    m_AngleFrames.clear();
+    int Ncol = m_Names.size();
+    m_AngleIndex.assign(Ncol, -1);
+    for(int i = 0; i < Ncol; i++){
+      if(!IsAngle(m_Types[i]) || m_AngleIndex[i] >= 0) continue;
+      vector<int> columns(1, i);
+      for(int j = i+1; j < Ncol; j++)
+	if(IsAngle(m_Types[j]) && m_Frames[j] == m_Frames[i]) columns.push_back(j);
+      if(columns.size() < 2) continue;
+      int N = columns.size();
+      for(int c = 0; c < N; c++) m_AngleIndex[columns[c]] = m_AngleFrames.size();
+      m_AngleFrames.push_back(m_Frames[i]);
+    }
+    m_Angles.resize(m_AngleFrames.size());
+  }
+
+  double ObservableSink::Evaluate(int index) const {
+    const RestFrame* framePtr = m_Frames[index];
+    int iangle = m_AngleIndex[index];
+    if(iangle >= 0){
+      const DecayAngles& angles = m_Angles[iangle];
+      switch(m_Types[index]){
+      case OCosDecayAngle:         return angles.CosDecayAngle;
+      case ODeltaPhiDecayAngle:    return angles.DeltaPhiDecayAngle;
+      case ODeltaPhiBoostVisible:  return angles.DeltaPhiBoostVisible;
+      case ODeltaPhiDecayVisible:  return angles.DeltaPhiDecayVisible;
+      case ODeltaPhiVisible:       return angles.DeltaPhiVisible;
+      default:                     break;
+      }
+    }
+    if(!framePtr) return m_Values[index];
+    return EvaluateObservable(m_Types[index], *framePtr);
+  }
+
+  bool ObservableSink::Fill(){
+    if(!m_File) return false;
+    int Ncol = m_Names.size();
+    int row = m_BufferRows[m_Active];
+    double* buffer = &m_Buffer[m_Active][0];
+    int Nangle = m_AngleFrames.size();
+    for(int i = 0; i < Nangle; i++)
+      m_Angles[i] = m_AngleFrames[i]->GetDecayAngles();
+    for(int i = 0; i < Ncol; i++)
+      buffer[i*m_ChunkSize+row] = Evaluate(i);
+    m_BufferRows[m_Active]++;
+    m_NRows++;
+    if(m_BufferRows[m_Active] >= m_ChunkSize) SubmitBuffer();
+    return !m_WriteError;
+  }
+
+  // Hands the filled buffer over for writing and continues
+  // in the other one, which the writer has finished with
+  void ObservableSink::SubmitBuffer(){
+    if(!m_Background){
+      WriteBuffer(m_Active);
+      m_BufferRows[m_Active] = 0;
+      return;
+    }
+    unique_lock<mutex> lock(m_Mutex);
+    while(m_Pending >= 0) m_Condition.wait(lock);
+    m_Pending = m_Active;
+    m_Active = 1-m_Active;
+    m_BufferRows[m_Active] = 0;
+    m_Condition.notify_all();
+  }
+
+  void ObservableSink::WriterLoop(){
+    unique_lock<mutex> lock(m_Mutex);
+    while(true){
+      while(m_Pending < 0 && !m_Stop) m_Condition.wait(lock);
+      if(m_Pending < 0) break;
+      int ibuf = m_Pending;
+      lock.unlock();
+      WriteBuffer(ibuf);
+      lock.lock();
+      m_Pending = -1;
+      m_Condition.notify_all();
+    }
+  }
+
+  void ObservableSink::WriteBuffer(int ibuf){
+    unsigned int head[2] = {(unsigned int)m_BufferRows[ibuf], 0};
+    bool ok = fwrite(head, sizeof(unsigned int), 2, m_File) == 2;
+    if(head[0] == 0){
+      if(!ok) m_WriteError = true;
+      return;
+    }
+
+    int Ncol = m_Names.size();
+    int Nrow = head[0];
+    unsigned int value_size = m_SinglePrecision ? sizeof(float) : sizeof(double);
+    int nbytes = value_size*Nrow;
+    for(int i = 0; i < Ncol; i++){
+      char* data = (char*)&m_Buffer[ibuf][i*m_ChunkSize];
+      if(m_SinglePrecision){
+	m_Narrowed.resize(Nrow);
+	for(int r = 0; r < Nrow; r++) m_Narrowed[r] = m_Buffer[ibuf][i*m_ChunkSize+r];
+	data = (char*)&m_Narrowed[0];
+      }
+      unsigned long long size = nbytes;
+      unsigned int compressed[2] = {0, value_size};
+      if(m_CompressionLevel > 0){
+	m_Compressed.resize(nbytes);
+	int srcsize = nbytes;
+	int tgtsize = nbytes;
+	int irep = 0;
+	R__zip(m_CompressionLevel, &srcsize, data, &tgtsize, &m_Compressed[0], &irep);
+	// stored uncompressed when compression does not help
+	if(irep > 0 && irep < nbytes){
+	  data = &m_Compressed[0];
+	  size = irep;
+	  compressed[0] = 1;
+	}
+      }
+      ok = ok && fwrite(&size, sizeof(size), 1, m_File) == 1;
+      ok = ok && fwrite(compressed, sizeof(unsigned int), 2, m_File) == 2;
+      ok = ok && fwrite(data, 1, size, m_File) == size;
+    }
+    if(!ok) m_WriteError = true;
+  }
+
+  bool ObservableSink::Close(){
+    if(!m_File) return false;
+    if(m_BufferRows[m_Active] > 0) SubmitBuffer();
+    if(m_Writer.joinable()){
+      {
+	lock_guard<mutex> lock(m_Mutex);
+	m_Stop = true;
+	m_Condition.notify_all();
+      }
+      m_Writer.join();
+    }
+    // terminating empty chunk
+    m_BufferRows[m_Active] = 0;
+    WriteBuffer(m_Active);
+    bool ok = (fclose(m_File) == 0) && !m_WriteError;
+    m_File = nullptr;
+    for(int b = 0; b < 2; b++){
+      m_Buffer[b].clear();
+      m_BufferRows[b] = 0;
+    }
+    return ok;
+  }
+
+}
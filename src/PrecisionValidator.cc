@@ -0,0 +1,153 @@
+#include <cmath>
+#include <cstdio>
+#include "RestFrames/PrecisionValidator.hh"
+
+using namespace std;
+
+namespace RestFrames {
+
+  ///////////////////////////////////////////////
+  // PrecisionValidator class methods
+  ///////////////////////////////////////////////
+  PrecisionValidator::PrecisionValidator(const string& sname, const string& stitle){
+    m_Name = sname;
+    m_Title = stitle;
+    m_Tolerance = 1e-3;
+    m_NEvents = 0;
+  }
+
+  PrecisionValidator::~PrecisionValidator(){
+
+  }
+
+  string PrecisionValidator::GetName() const {
+    return m_Name;
+  }
+
+  string PrecisionValidator::GetTitle() const {
+    return m_Title;
+  }
+
+  int PrecisionValidator::AddObservable(const string& name){
+    if(m_NEvents > 0) return -1;
+    m_Names.push_back(name);
+    m_Types.push_back(OValue);
+    m_Frames.push_back(nullptr);
+    m_SingleFrames.push_back(nullptr);
+    m_Values.push_back(0.);
+    m_SingleValues.push_back(0.);
+    m_SumDifference.push_back(0.);
+    m_MaxDifference.push_back(0.);
+    m_NFailures.push_back(0);
+    return m_Names.size()-1;
+  }
+
+  int PrecisionValidator::AddObservable(const string& name, ObservableType type,
+					const RestFrame& frame, const RestFrame& single_frame){
+    if(type == OValue) return AddObservable(name);
+    int index = AddObservable(name);
+    if(index < 0) return index;
+    m_Types[index] = type;
+    m_Frames[index] = &frame;
+    m_SingleFrames[index] = &single_frame;
+    return index;
+  }
+
+  int PrecisionValidator::AddMass(const string& name, const RestFrame& frame, const RestFrame& single_frame){
+    return AddObservable(name, OMass, frame, single_frame);
+  }
+
+  int PrecisionValidator::GetNObservables() const {
+    return m_Names.size();
+  }
+
+  void PrecisionValidator::SetTolerance(double tolerance){
+    if(tolerance > 0.) m_Tolerance = tolerance;
+  }
+
+  double PrecisionValidator::GetTolerance() const {
+    return m_Tolerance;
+  }
+
+  bool PrecisionValidator::IsIndex(int index) const {
+    return index >= 0 && index < int(m_Names.size());
+  }
+
+  void PrecisionValidator::SetValues(int index, double val, double single_val){
+    if(!IsIndex(index)) return;
+    m_Values[index] = val;
+    m_SingleValues[index] = single_val;
+  }
+
+  void PrecisionValidator::Fill(){
+    int N = m_Names.size();
+    for(int i = 0; i < N; i++){
+      double val = m_Values[i];
+      double single_val = m_SingleValues[i];
+      if(m_Frames[i]){
+	val = EvaluateObservable(m_Types[i], *m_Frames[i]);
+	single_val = EvaluateObservable(m_Types[i], *m_SingleFrames[i]);
+      }
+      bool finite = std::isfinite(val);
+      if(finite != bool(std::isfinite(single_val))){
+	m_NFailures[i]++;
+	continue;
+      }
+      if(!finite) continue;
+      double diff = fabs(single_val-val)/max(fabs(val), 1.);
+      m_SumDifference[i] += diff;
+      m_MaxDifference[i] = max(m_MaxDifference[i], diff);
+      if(diff > m_Tolerance) m_NFailures[i]++;
+    }
+    m_NEvents++;
+  }
+
+  void PrecisionValidator::Clear(){
+    m_NEvents = 0;
+    int N = m_Names.size();
+    for(int i = 0; i < N; i++){
+      m_SumDifference[i] = 0.;
+      m_MaxDifference[i] = 0.;
+      m_NFailures[i] = 0;
+    }
+  }
+
+  long PrecisionValidator::GetNEvents() const {
+    return m_NEvents;
+  }
+
+  double PrecisionValidator::GetMeanDifference(int index) const {
+    if(!IsIndex(index) || m_NEvents <= 0) return 0.;
+    return m_SumDifference[index]/double(m_NEvents);
+  }
+
+  double PrecisionValidator::GetMaxDifference(int index) const {
+    if(!IsIndex(index)) return 0.;
+    return m_MaxDifference[index];
+  }
+
+  long PrecisionValidator::GetNFailures(int index) const {
+    if(!IsIndex(index)) return 0;
+    return m_NFailures[index];
+  }
+
+  bool PrecisionValidator::IsValid() const {
+    int N = m_Names.size();
+    for(int i = 0; i < N; i++)
+      if(m_NFailures[i] > 0) return false;
+    return true;
+  }
+
+  void PrecisionValidator::Print() const {
+    cout << endl << "PrecisionValidator " << m_Name.c_str() << ": ";
+    cout << m_NEvents << " events, tolerance " << m_Tolerance << endl;
+    int N = m_Names.size();
+    for(int i = 0; i < N; i++){
+      char line[256];
+      snprintf(line, sizeof(line), "  %-24s mean %10.3e  max %10.3e  failures %ld",
+	       m_Names[i].c_str(), GetMeanDifference(i), GetMaxDifference(i), m_NFailures[i]);
+      cout << line << endl;
+    }
+  }
+
+}
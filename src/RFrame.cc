@@ -1,4 +1,5 @@
 #include "RestFrames/RFrame.hh"
+#include "RestFrames/FrameLog.hh"
 
 using namespace std;
 
@@ -26,6 +27,7 @@ namespace RestFrames {
   void RFrame::Init(){
     m_Ana = FReco;
     m_GroupPtr = nullptr;
+    m_ImmutableStates = false;
   }
 
   void RFrame::ClearRFrame(){
@@ -38,6 +40,18 @@ namespace RestFrames {
       delete m_ChildStates[i];
     }
     m_ChildStates.clear();
+    m_ChildRFrames.clear();
+  }
+
+  bool RFrame::ResolveChildRFrames(){
+    m_ChildRFrames.clear();
+    int Nchild = GetNChildren();
+    for(int i = 0; i < Nchild; i++){
+      RFrame* childPtr = dynamic_cast<RFrame*>(GetChildFrame(i));
+      if(!childPtr) return false;
+      m_ChildRFrames.push_back(childPtr);
+    }
+    return true;
   }
   
   void RFrame::SetGroup(Group* groupPtr){
@@ -124,12 +138,12 @@ namespace RestFrames {
     ClearStates();
     m_Mind = false;
     if(!m_Body){
-      cout << endl << "Initialize Analysis Failure: ";
-      cout << "UnSound frame " << m_Name.c_str() << " in tree" << endl;
+      RF_LOG(LogError, "Initialize Analysis Failure: UnSound frame in tree", this);
       return false;
     }
     if(!InitializeNoGroupStates(statesPtr)) return false;
     if(!InitializeGroupStates(groupsPtr)) return false;
+    if(!ResolveChildRFrames()) return false;
     
     m_Mind = true;
     return true;
@@ -141,14 +155,21 @@ namespace RestFrames {
     int Nchild = GetNChildren();
     bool child_mind = true;
     for(int i = 0; i < Nchild; i++){
-      RFrame *childPtr = dynamic_cast<RFrame*>(GetChildFrame(i));
-      if(!childPtr) return false;
+      RFrame *childPtr = m_ChildRFrames[i];
       if(!childPtr->InitializeStatesRecursive(statesPtr,groupsPtr)) child_mind = false;;
     }
     m_Mind = child_mind;
     return m_Mind;
   }
 
+  void RFrame::SetImmutableStates(bool immutable){
+    m_ImmutableStates = immutable;
+  }
+
+  bool RFrame::GetImmutableStates() const {
+    return m_ImmutableStates;
+  }
+
   void RFrame::ClearEventRecursive(){ 
     m_Spirit = false;
     if(!m_Body || !m_Mind) return;
@@ -161,12 +182,13 @@ namespace RestFrames {
   bool RFrame::AnalyzeEventRecursive(){
     m_Spirit = false;
     if(!m_Mind){
-      cout << endl << "Analyze Event Failure: ";
-      cout << "UnSound frame " << m_Name.c_str() << " in tree" << endl;
+      RF_LOG(LogError, "Analyze Event Failure: UnSound frame in tree", this);
       return false;
     }
     TLorentzVector Ptot(0,0,0,0);
     int Nchild = GetNChildren();
+    if(int(m_ChildRFrames.size()) != Nchild && !ResolveChildRFrames())
+      return false;
     bool child_spirit = true;
     for(int i = 0; i < Nchild; i++){
       TLorentzVector P = m_ChildStates[i]->GetFourVector();
@@ -174,19 +196,27 @@ namespace RestFrames {
       m_ChildLinks[i]->SetBoostVector(B_child);
       Ptot += P;
 
-      RFrame *childPtr = dynamic_cast<RFrame*>(GetChildFrame(i));
+      RFrame *childPtr = m_ChildRFrames[i];
       childPtr->SetFourVector(P,this);
-      if(!childPtr->IsVisibleFrame() && !childPtr->IsInvisibleFrame()){ 
+      bool boost = !childPtr->IsVisibleFrame() && !childPtr->IsInvisibleFrame();
+      if(boost && m_ImmutableStates){
+	m_SavedFourVectors.clear();
+	m_ChildStates[i]->SaveFourVectors(m_SavedFourVectors);
+      }
+      if(boost){ 
 	B_child *= -1.;
 	m_ChildStates[i]->Boost(B_child);
       }
       if(!childPtr->AnalyzeEventRecursive()) child_spirit = false;
-      if(!childPtr->IsVisibleFrame() && !childPtr->IsInvisibleFrame()){ 
+      if(boost && m_ImmutableStates){
+	m_ChildStates[i]->RestoreFourVectors(m_SavedFourVectors, 0);
+      } else if(boost){ 
 	B_child *= -1.;
 	m_ChildStates[i]->Boost(B_child);
       }
     }
     if(m_Type == FLab) SetFourVector(Ptot,this);
+    SumDescendantFourVectors();
     m_Spirit = child_spirit;
     return m_Spirit;
   }
@@ -1,4 +1,9 @@
+#include <cstring>
 #include "RestFrames/RLabFrame.hh"
+#include "RestFrames/CombinatoricJigsaw.hh"
+#include "RestFrames/InvisibleGroup.hh"
+#include "RestFrames/CombinatoricGroup.hh"
+#include "RestFrames/FrameLog.hh"
 
 using namespace std;
 
@@ -25,10 +30,17 @@ namespace RestFrames {
 
   RLabFrame::~RLabFrame(){
     ClearStates();
+    if(m_ExecutorPtr) delete m_ExecutorPtr;
   }
 
+  const char* RLabFrame::m_AnalysisMagic = "RFANALYS";
+  const unsigned int RLabFrame::m_AnalysisVersion = 1;
+
   void RLabFrame::Init(){
-  
+    m_AnalysisHash = 0;
+    m_ExecutorPtr = nullptr;
+    m_TracePtr = nullptr;
+    m_GraphBuilt = false;
   }
 
   void RLabFrame::ClearStates(){
@@ -37,6 +49,7 @@ namespace RestFrames {
       delete m_LabStates.Get(i);
     }
     m_LabStates.Clear();
+    m_LabStateFrames.clear();
   }
   
   bool RLabFrame::InitializeLabGroups(){
@@ -68,6 +81,7 @@ namespace RestFrames {
 	State* statePtr = new State();
 	statePtr->AddFrame(framesPtr->Get(f));
 	m_LabStates.Add(statePtr);
+	m_LabStateFrames.push_back(dynamic_cast<VisibleFrame*>(framesPtr->Get(f)));
       }
     }
     delete framesPtr;
@@ -89,10 +103,8 @@ namespace RestFrames {
     return true;
   }
 
-  bool RLabFrame::InitializeLabJigsaws(){
-     m_LabJigsaws.Clear();
+  bool RLabFrame::InitializeLabDependancyStates(){
     int Ng = m_LabGroups.GetN();
-    // Initialize Dependancy States in jigsaws
     for(int g = 0; g < Ng; g++){
       Group* groupPtr = m_LabGroups.Get(g);
       JigsawList* jigsawsPtr = groupPtr->GetJigsaws();
@@ -106,7 +118,15 @@ namespace RestFrames {
       }
       delete jigsawsPtr;
     }
+    return true;
+  }
+
+  bool RLabFrame::InitializeLabJigsaws(){
+    m_LabJigsaws.Clear();
+    // Initialize Dependancy States in jigsaws
+    if(!InitializeLabDependancyStates()) return false;
     // Initialize Dependancy Jigsaw lists in jigsaws
+    int Ng = m_LabGroups.GetN();
     for(int g = 0; g < Ng; g++){
       Group* groupPtr = m_LabGroups.Get(g);
       JigsawList* jigsawsPtr = groupPtr->GetJigsaws();
@@ -122,26 +142,25 @@ namespace RestFrames {
       delete jigsawsPtr;
     }
     // Initialize Jigsaw execution list
-    JigsawList* chain_jigsawsPtr = new JigsawList();
+    JigsawList chain_jigsaws;
     int Nj = m_LabJigsaws.GetN();
     for(int i = 0; i < Nj; i++){
       Jigsaw* jigsawPtr = m_LabJigsaws.Get(i);
-      if(!jigsawPtr->InitializeJigsawExecutionList(chain_jigsawsPtr)){
+      if(!jigsawPtr->InitializeJigsawExecutionList(&chain_jigsaws)){
 	m_LabJigsaws.Clear();
-	delete chain_jigsawsPtr;
 	return false;
       }
     }  
     
-    m_LabJigsaws.Clear();
-    m_LabJigsaws.Add(chain_jigsawsPtr);
-    delete chain_jigsawsPtr;
+    m_LabJigsaws = chain_jigsaws;
 
     return true;
   }
 
   bool RLabFrame::InitializeAnalysis(){
     m_Mind = false;
+    m_GraphBuilt = false;
+    m_AnalysisHash = GetAnalysisHash(m_AnalysisJigsaws);
    
     for(;;){
       if(!InitializeLabGroups())  break;
@@ -152,12 +171,248 @@ namespace RestFrames {
       break;
     }
     if(!m_Mind){
-      cout << endl << "Initialize Analysis Failure: ";
-      cout << "UnSound frame in tree" << endl;
+      RF_LOG(LogError, "Initialize Analysis Failure: UnSound frame in tree", this);
     }
+    if(m_Mind && m_TracePtr) SetEventTrace(m_TracePtr);
+    if(m_Mind) RF_DEBUG("analysis initialized with " + to_string(m_LabJigsaws.GetN()) + " jigsaws", this);
     return m_Mind;
   }
 
+  // FNV-1a hash of the names and wiring of every frame, group and
+  // jigsaw, taken before the groups are initialized. Fills jigsaws
+  // with all the jigsaws of the analysis in a reproducible order.
+  unsigned long long RLabFrame::GetAnalysisHash(JigsawList& jigsaws){
+    jigsaws.Clear();
+    string desc;
+    char buf[64];
+
+    RestFrameList* framesPtr = GetListFrames();
+    int Nf = framesPtr->GetN();
+    for(int f = 0; f < Nf; f++){
+      RestFrame* framePtr = framesPtr->Get(f);
+      const RestFrame* parentPtr = framePtr->GetParentFrame();
+      sprintf(buf, "F%d:", int(framePtr->GetType()));
+      desc += buf + framePtr->GetName() + "<" + (parentPtr ? parentPtr->GetName() : "") + ";";
+    }
+    delete framesPtr;
+
+    GroupList* groupsPtr = GetListGroups();
+    int Ng = groupsPtr->GetN();
+    for(int g = 0; g < Ng; g++){
+      Group* groupPtr = groupsPtr->Get(g);
+      sprintf(buf, "G%d:", int(groupPtr->GetType()));
+      desc += buf + groupPtr->GetName() + "{";
+      RestFrameList* group_framesPtr = groupPtr->GetFrames();
+      int N = group_framesPtr->GetN();
+      for(int f = 0; f < N; f++) desc += group_framesPtr->Get(f)->GetName() + ",";
+      delete group_framesPtr;
+      desc += "}";
+
+      JigsawList* group_jigsawsPtr = groupPtr->GetJigsawsToUse();
+      int Nj = group_jigsawsPtr->GetN();
+      for(int j = 0; j < Nj; j++){
+	Jigsaw* jigsawPtr = group_jigsawsPtr->Get(j);
+	jigsaws.Add(jigsawPtr);
+	sprintf(buf, "J%d,%d:", int(jigsawPtr->GetType()), jigsawPtr->GetPriority());
+	desc += buf + jigsawPtr->GetName();
+	int Nc = jigsawPtr->GetNChildStates();
+	for(int c = 0; c < Nc; c++){
+	  desc += "[";
+	  RestFrameList* child_framesPtr = jigsawPtr->GetChildFrames(c);
+	  int Ncf = child_framesPtr->GetN();
+	  for(int f = 0; f < Ncf; f++) desc += child_framesPtr->Get(f)->GetName() + ",";
+	  delete child_framesPtr;
+	  desc += "]";
+	}
+	int Nd = jigsawPtr->GetNDependancyFrames();
+	for(int d = 0; d < Nd; d++){
+	  desc += "(";
+	  RestFrameList* dep_framesPtr = jigsawPtr->GetDependancyFrames(d);
+	  int Ndf = dep_framesPtr->GetN();
+	  for(int f = 0; f < Ndf; f++) desc += dep_framesPtr->Get(f)->GetName() + ",";
+	  delete dep_framesPtr;
+	  desc += ")";
+	}
+	desc += ";";
+      }
+      delete group_jigsawsPtr;
+    }
+    delete groupsPtr;
+
+    unsigned long long hash = 14695981039346656037ULL;
+    int N = desc.size();
+    for(int i = 0; i < N; i++){
+      hash ^= (unsigned char)desc[i];
+      hash *= 1099511628211ULL;
+    }
+    return hash;
+  }
+
+  bool RLabFrame::WriteIndices(FILE* file, const JigsawList* jigsawsPtr) const {
+    int N = jigsawsPtr ? jigsawsPtr->GetN() : 0;
+    vector<int> indices(1, N);
+    for(int i = 0; i < N; i++){
+      int index = m_AnalysisJigsaws.GetIndex(jigsawsPtr->Get(i));
+      if(index < 0) return false;
+      indices.push_back(index);
+    }
+    return fwrite(&indices[0], sizeof(int), N+1, file) == size_t(N+1);
+  }
+
+  bool RLabFrame::ReadIndices(FILE* file, JigsawList& jigsaws) const {
+    jigsaws.Clear();
+    int N;
+    if(fread(&N, sizeof(int), 1, file) != 1) return false;
+    if(N < 0 || N > m_AnalysisJigsaws.GetN()) return false;
+    if(N == 0) return true;
+    vector<int> indices(N);
+    if(fread(&indices[0], sizeof(int), N, file) != size_t(N)) return false;
+    for(int i = 0; i < N; i++){
+      Jigsaw* jigsawPtr = m_AnalysisJigsaws.Get(indices[i]);
+      if(!jigsawPtr) return false;
+      if(!jigsaws.Add(jigsawPtr)) return false;
+    }
+    return true;
+  }
+
+  bool RLabFrame::SaveAnalysis(const string& filename) const {
+    if(!m_Mind) return false;
+    FILE* file = fopen(filename.c_str(), "wb");
+    if(!file){
+      RF_LOG(LogError, "unable to open", this, "unable to open " + filename);
+      return false;
+    }
+    unsigned int head[2] = {m_AnalysisVersion, 0};
+    bool ok = fwrite(m_AnalysisMagic, 1, 8, file) == 8;
+    ok = ok && fwrite(head, sizeof(unsigned int), 2, file) == 2;
+    ok = ok && fwrite(&m_AnalysisHash, sizeof(m_AnalysisHash), 1, file) == 1;
+
+    int Ng = m_LabGroups.GetN();
+    for(int g = 0; g < Ng; g++){
+      JigsawList* jigsawsPtr = m_LabGroups.Get(g)->GetJigsaws();
+      ok = ok && WriteIndices(file, jigsawsPtr);
+      delete jigsawsPtr;
+    }
+    ok = ok && WriteIndices(file, &m_LabJigsaws);
+    int Nj = m_LabJigsaws.GetN();
+    for(int j = 0; j < Nj; j++){
+      CombinatoricJigsaw* jigsawPtr = dynamic_cast<CombinatoricJigsaw*>(m_LabJigsaws.Get(j));
+      JigsawList* jigsawsPtr = jigsawPtr ? jigsawPtr->GetExecuteJigsaws() : nullptr;
+      ok = ok && WriteIndices(file, jigsawsPtr);
+      delete jigsawsPtr;
+    }
+    ok = (fclose(file) == 0) && ok;
+    return ok;
+  }
+
+  bool RLabFrame::LoadAnalysis(const string& filename){
+    m_Mind = false;
+    m_GraphBuilt = false;
+    FILE* file = fopen(filename.c_str(), "rb");
+    if(!file){
+      RF_LOG(LogError, "unable to open", this, "unable to open " + filename);
+      return false;
+    }
+    m_AnalysisHash = GetAnalysisHash(m_AnalysisJigsaws);
+
+    char magic[8];
+    unsigned int head[2];
+    unsigned long long hash;
+    bool ok = fread(magic, 1, 8, file) == 8;
+    ok = ok && fread(head, sizeof(unsigned int), 2, file) == 2;
+    ok = ok && fread(&hash, sizeof(hash), 1, file) == 1;
+    if(!ok || memcmp(magic, m_AnalysisMagic, 8) != 0 || head[0] != m_AnalysisVersion){
+      RF_LOG(LogError, "not an analysis snapshot", this, filename + " is not an analysis snapshot");
+      fclose(file);
+      return false;
+    }
+    if(hash != m_AnalysisHash){
+      RF_LOG(LogError, "snapshot of a different analysis", this, filename + " is a snapshot of a different analysis");
+      fclose(file);
+      return false;
+    }
+
+    GroupList* groupsPtr = GetListGroups();
+    int Ng = groupsPtr->GetN();
+    vector<JigsawList> split_jigsaws(Ng);
+    for(int g = 0; g < Ng; g++) ok = ok && ReadIndices(file, split_jigsaws[g]);
+    JigsawList chain_jigsaws;
+    ok = ok && ReadIndices(file, chain_jigsaws);
+    int Nj = chain_jigsaws.GetN();
+    vector<JigsawList> execute_jigsaws(Nj);
+    for(int j = 0; j < Nj; j++) ok = ok && ReadIndices(file, execute_jigsaws[j]);
+    fclose(file);
+
+    for(;;){
+      if(!ok) break;
+      m_LabGroups.Clear();
+      m_LabGroups.Add(groupsPtr);
+      bool groups_ok = true;
+      for(int g = 0; g < Ng; g++)
+	if(!m_LabGroups.Get(g)->InitializeAnalysis(&split_jigsaws[g])) groups_ok = false;
+      if(!groups_ok) break;
+      if(!InitializeLabStates()) break;
+      m_LabJigsaws.Clear();
+      if(!InitializeLabDependancyStates()) break;
+      for(int j = 0; j < Nj; j++){
+	CombinatoricJigsaw* jigsawPtr = dynamic_cast<CombinatoricJigsaw*>(chain_jigsaws.Get(j));
+	if(jigsawPtr) jigsawPtr->SetExecuteJigsaws(&execute_jigsaws[j]);
+      }
+      m_LabJigsaws = chain_jigsaws;
+      if(!InitializeStatesRecursive(&m_LabStates,&m_LabGroups)) break;
+      m_Mind = true;
+      break;
+    }
+    delete groupsPtr;
+    if(!m_Mind){
+      RF_LOG(LogError, "Load Analysis Failure: snapshot does not match the tree", this, "Load Analysis Failure: " + filename + " does not match the tree");
+    }
+    if(m_Mind && m_TracePtr) SetEventTrace(m_TracePtr);
+    return m_Mind;
+  }
+
+  const JigsawGraph& RLabFrame::GetJigsawGraph() const {
+    BuildJigsawGraph();
+    return m_JigsawGraph;
+  }
+
+  // The graph is only needed by parallel execution and
+  // AnalyzeSolution, so it is built on first use after each
+  // initialization rather than by InitializeAnalysis
+  bool RLabFrame::BuildJigsawGraph() const {
+    if(m_GraphBuilt) return m_JigsawGraph.GetNJigsaws() == m_LabJigsaws.GetN();
+    m_GraphBuilt = true;
+    if(!m_Mind){
+      m_JigsawGraph.Clear();
+      return false;
+    }
+    if(!m_JigsawGraph.Build(&m_LabJigsaws)){
+      RF_LOG(LogError, "unable to build the jigsaw dependency graph", this);
+      m_JigsawGraph.Clear();
+      return false;
+    }
+    return true;
+  }
+
+  void RLabFrame::SetParallelJigsaws(int Nthread, double min_cost){
+    if(m_ExecutorPtr) delete m_ExecutorPtr;
+    m_ExecutorPtr = nullptr;
+    if(Nthread <= 1) return;
+    m_ExecutorPtr = new JigsawExecutor(Nthread);
+    m_ExecutorPtr->SetCostThreshold(min_cost);
+  }
+
+  void RLabFrame::SetImmutableStates(bool immutable){
+    RFrame::SetImmutableStates(immutable);
+    RestFrameList* framesPtr = GetListFrames();
+    int Nf = framesPtr->GetN();
+    for(int f = 0; f < Nf; f++){
+      RFrame* framePtr = dynamic_cast<RFrame*>(framesPtr->Get(f));
+      if(framePtr && !framePtr->IsSame(this)) framePtr->SetImmutableStates(immutable);
+    }
+    delete framesPtr;
+  }
+
   void RLabFrame::ClearEvent(){
     m_Spirit = false;
     if(!m_Body || !m_Mind) return;
@@ -170,31 +425,172 @@ namespace RestFrames {
   }
 
   bool RLabFrame::AnalyzeEvent(){
+    if(!m_TracePtr) return AnalyzeLabEvent();
+    m_TracePtr->StartEvent();
+    TraceInputs();
+    bool analyzed = AnalyzeLabEvent();
+    m_TracePtr->StopEvent(analyzed);
+    return analyzed;
+  }
+
+  bool RLabFrame::AnalyzeLabEvent(){
     m_Spirit = false;
     if(!m_Mind) return false;
 
+    SetLabStateFourVectors();
+
+    // failures are counted (FrameLog::PrintSummary), not printed
+    int Ng = m_LabGroups.GetN();
+    for(int i = 0; i < Ng; i++){
+      if(!m_LabGroups.Get(i)->AnalyzeEvent()){
+	RF_LOG(LogInfo, "Analyze Event Failure", m_LabGroups.Get(i));
+	return false;
+      }
+    }
+
+    // the trace records one sequence of executions
+    if(m_ExecutorPtr && !m_TracePtr){
+      if(!BuildJigsawGraph() || !m_ExecutorPtr->Execute(m_JigsawGraph)){
+	RF_LOG(LogInfo, "Analyze Event Failure: jigsaw execution failed", this);
+	return false;
+      }
+    } else {
+      int Nj = m_LabJigsaws.GetN();
+      for(int i = 0; i < Nj; i++){
+	if(!m_LabJigsaws.Get(i)->Execute()){
+	  RF_LOG(LogInfo, "Analyze Event Failure", m_LabJigsaws.Get(i));
+	  return false;
+	}
+      }
+    }
+
+    if(!AnalyzeEventRecursive()) return false;
+    if(!m_FrameTable.IsFilled()) m_FrameTable.Fill(this);
+    m_Spirit = true;
+    return true;
+  }
+
+  void RLabFrame::SetLabStateFourVectors(){
     int Ns = m_LabStates.GetN();
     for(int i = 0; i < Ns; i++){
-      State* statePtr = m_LabStates.Get(i);
-      RestFrameList* framesPtr = statePtr->GetFrames();
-      VisibleFrame* vframePtr = dynamic_cast<VisibleFrame*>(framesPtr->Get(0));
-      if(vframePtr) statePtr->SetFourVector(vframePtr->GetLabFrameFourVector());
-      delete framesPtr;
+      VisibleFrame* vframePtr = m_LabStateFrames[i];
+      if(vframePtr) m_LabStates.Get(i)->SetFourVector(vframePtr->GetLabFrameFourVector());
     }
+  }
+
+  bool RLabFrame::AnalyzeSolution(CombinatoricJigsaw& jigsaw, int i){
+    if(!m_Spirit) return false;
+    if(!BuildJigsawGraph()) return false;
+    int index = m_JigsawGraph.GetIndex(&jigsaw);
+    if(index < 0) return false;
+    m_Spirit = false;
 
+    // the frame boosts of the last analysis leave rounding
+    // differences in the states, so the inputs are reset
+    // (before the solution's outputs are built from them)
+    SetLabStateFourVectors();
     int Ng = m_LabGroups.GetN();
-    for(int i = 0; i < Ng; i++){
-      if(!m_LabGroups.Get(i)->AnalyzeEvent()) return false;
+    for(int g = 0; g < Ng; g++){
+      if(!m_LabGroups.Get(g)->AnalyzeEvent()) return false;
     }
+    if(!jigsaw.UseSolution(i)) return false;
 
-    int Nj = m_LabJigsaws.GetN();
-    for(int i = 0; i < Nj; i++){
-      if(!m_LabJigsaws.Get(i)->AnalyzeEvent()) return false;
+    int N = m_JigsawGraph.GetNJigsaws();
+    vector<bool> changed(N, false);
+    changed[index] = true;
+    for(int j = index+1; j < N; j++){
+      int Nd = m_JigsawGraph.GetNDependancies(j);
+      for(int d = 0; d < Nd && !changed[j]; d++)
+	if(changed[m_JigsawGraph.GetDependancy(j, d)]) changed[j] = true;
+      if(!changed[j]) continue;
+      if(!m_JigsawGraph.GetJigsaw(j)->Execute()) return false;
     }
 
     if(!AnalyzeEventRecursive()) return false;
+    if(!m_FrameTable.IsFilled()) m_FrameTable.Fill(this);
     m_Spirit = true;
     return true;
   }
 
+  bool RLabFrame::SetEventTrace(EventTrace& trace){
+    return SetEventTrace(&trace);
+  }
+
+  bool RLabFrame::SetEventTrace(EventTrace* tracePtr){
+    if(tracePtr && !m_Mind) return false;
+    m_TracePtr = tracePtr;
+    int Nj = m_AnalysisJigsaws.GetN();
+    for(int i = 0; i < Nj; i++) m_AnalysisJigsaws.Get(i)->SetEventTrace(tracePtr);
+    if(tracePtr) tracePtr->SetAnalysis(m_AnalysisHash, m_AnalysisJigsaws, GetTraceSources());
+    return true;
+  }
+
+  vector<string> RLabFrame::GetTraceSources() const {
+    vector<string> sources;
+    int Ns = m_LabStateFrames.size();
+    for(int i = 0; i < Ns; i++)
+      sources.push_back(m_LabStateFrames[i] ? m_LabStateFrames[i]->GetName() : "");
+    int Ng = m_LabGroups.GetN();
+    for(int g = 0; g < Ng; g++) sources.push_back(m_LabGroups.Get(g)->GetName());
+    return sources;
+  }
+
+  void RLabFrame::TraceInputs(){
+    int Ns = m_LabStateFrames.size();
+    for(int i = 0; i < Ns; i++){
+      VisibleFrame* vframePtr = m_LabStateFrames[i];
+      if(vframePtr) m_TracePtr->AddInput(i, vframePtr->GetLabFrameFourVector());
+    }
+    int Ng = m_LabGroups.GetN();
+    for(int g = 0; g < Ng; g++){
+      Group* groupPtr = m_LabGroups.Get(g);
+      if(groupPtr->IsInvisibleGroup()){
+	InvisibleGroup* inv_groupPtr = static_cast<InvisibleGroup*>(groupPtr);
+	m_TracePtr->AddInput(Ns+g, inv_groupPtr->GetLabFrameFourVector());
+      }
+      if(groupPtr->IsCombinatoricGroup()){
+	CombinatoricGroup* comb_groupPtr = static_cast<CombinatoricGroup*>(groupPtr);
+	int N = comb_groupPtr->GetNFourVectors();
+	for(int e = 0; e < N; e++)
+	  m_TracePtr->AddInput(Ns+g, comb_groupPtr->GetElementFourVector(e),
+			       comb_groupPtr->GetElementLabel(e));
+      }
+    }
+  }
+
+  bool RLabFrame::ReplayEvent(const EventTrace& trace, long ievent){
+    if(ievent < 0 || ievent >= trace.GetNEvents()) return false;
+    return ReplayEvent(trace, trace.GetEvent(ievent));
+  }
+
+  bool RLabFrame::ReplayEvent(const EventTrace& trace, const TraceEvent& event){
+    if(!m_Mind) return false;
+    int Ns = m_LabStateFrames.size();
+    int Ng = m_LabGroups.GetN();
+    if(trace.GetAnalysisHash() != m_AnalysisHash || trace.GetNSources() != Ns+Ng){
+      RF_LOG(LogError, "trace of a different analysis", this, "trace " + trace.GetName() + " is of a different analysis");
+      return false;
+    }
+
+    ClearEvent();
+    int N = event.Inputs.size();
+    for(int i = 0; i < N; i++){
+      int source = event.Sources[i];
+      if(source < 0 || source >= Ns+Ng) return false;
+      if(source < Ns){
+	if(m_LabStateFrames[source]) m_LabStateFrames[source]->SetLabFrameFourVector(event.Inputs[i]);
+	continue;
+      }
+      Group* groupPtr = m_LabGroups.Get(source-Ns);
+      if(groupPtr->IsInvisibleGroup())
+	static_cast<InvisibleGroup*>(groupPtr)->SetLabFrameFourVector(event.Inputs[i]);
+      if(groupPtr->IsCombinatoricGroup())
+	static_cast<CombinatoricGroup*>(groupPtr)->AddLabFrameFourVector(event.Inputs[i], event.Labels[i]);
+    }
+    // recording into the trace replayed would append to (and
+    // may move) the events being replayed
+    if(&trace == m_TracePtr) return AnalyzeLabEvent();
+    return AnalyzeEvent();
+  }
+
 }
@@ -26,9 +26,11 @@ namespace RestFrames {
     int Nv = m_VisibleFrames.GetN();
     for(int i = 0; i < Nv; i++) delete m_VisibleFrames.Get(i);
     m_VisibleFrames.Clear();
+    m_VisibleRFrames.clear();
     int Nd = m_DecayFrames.GetN();
     for(int i = 0; i < Nd; i++) delete m_DecayFrames.Get(i);
     m_DecayFrames.Clear();
+    m_DecayRFrames.clear();
   }
 
   void RSelfAssemblingFrame::Init(){
@@ -39,6 +41,15 @@ namespace RestFrames {
     m_Mind_UnAssembled = false;
     m_Nvisible = 0;
     m_Ndecay = 0;
+    m_LocalSearchMin = 0;
+  }
+
+  void RSelfAssemblingFrame::SetLocalSearch(int min_inputs){
+    m_LocalSearchMin = max(0, min_inputs);
+  }
+
+  int RSelfAssemblingFrame::GetLocalSearch() const {
+    return m_LocalSearchMin;
   }
 
   void RSelfAssemblingFrame::ClearEventRecursive(){
@@ -70,6 +81,7 @@ namespace RestFrames {
       m_ChildStates.push_back(m_ChildStates_UnAssembled[i]->Copy());
       //delete m_ChildStates_UnAssembled[i];
     }
+    m_ChildRFrames = m_ChildRFrames_UnAssembled;
     // m_ChildStates_UnAssembled.clear();
 
     m_IsAssembled = false;
@@ -102,8 +114,9 @@ namespace RestFrames {
       }
       bool expand = false;
       if(m_ChildStates[i]->GetN() == 1){
-	CombinatoricState* statePtr = dynamic_cast<CombinatoricState*>(m_ChildStates[i]->Get(0));
-	if(statePtr){
+	State* child_statePtr = m_ChildStates[i]->Get(0);
+	if(child_statePtr->IsCombinatoricState()){
+	  CombinatoricState* statePtr = static_cast<CombinatoricState*>(child_statePtr);
 	  const StateList* elementsPtr = statePtr->GetElements();
 	  int Nelement = elementsPtr->GetN();
 	  for(int e = 0; e < Nelement; e++){
@@ -131,6 +144,7 @@ namespace RestFrames {
     }
     m_Body_UnAssembled = m_Body;
     m_Mind_UnAssembled = m_Mind;
+    if(!m_IsBackedUp) m_ChildRFrames_UnAssembled = m_ChildRFrames;
     m_IsBackedUp = true;
     ClearFrame();
     ClearRFrame();
@@ -141,11 +155,11 @@ namespace RestFrames {
     m_Mind = InitializeStates(&states, &groups);
 
     for(int i = 0; i < m_Ndecay; i++){
-      RFrame* framePtr = dynamic_cast<RFrame*>(m_DecayFrames.Get(i));
+      RFrame* framePtr = m_DecayRFrames[i];
       m_Mind = m_Mind && framePtr->InitializeStates(&states, &groups);
     }
     for(int i = 0; i < m_Nvisible; i++){
-      RFrame* framePtr = dynamic_cast<RFrame*>(m_VisibleFrames.Get(i));
+      RFrame* framePtr = m_VisibleRFrames[i];
       m_Mind = m_Mind && framePtr->InitializeStates(&states, &groups);
     }
     m_IsAssembled = true;
@@ -165,6 +179,47 @@ namespace RestFrames {
       Ps[i].Boost(-boost);
     }
 
+    vector<RestFrame*> child_frames[2];
+    vector<TLorentzVector> child_Ps[2];
+    TLorentzVector hem[2];
+    for(int i = 0; i < 2; i++){
+      hem[i].SetPxPyPzE(0.,0.,0.,0.);
+    }
+
+    if(m_LocalSearchMin > 0 && Ninput >= m_LocalSearchMin){
+      MaximizeMomentumObjective objective;
+      HemisphereLocalSearch<MaximizeMomentumObjective> search(objective);
+      for(int i = 0; i < Ninput; i++) search.AddUnit(Ps[i]);
+      for(int i = 0; i < 2; i++) search.SetMultiplicity(i, 1, false);
+      search.Search();
+      for(int i = 0; i < Ninput; i++){
+	int ihem = search.GetHemisphere(i);
+	child_frames[ihem].push_back(frames[i]);
+	child_Ps[ihem].push_back(Ps[i]);
+	hem[ihem] += Ps[i];
+      }
+    } else {
+      AssembleHemispheres(frames, Ps, child_frames, child_Ps, hem);
+    }
+
+    int flip = int(hem[1].M() > hem[0].M());
+    for(int i = 0; i < 2; i++){
+      int j = (i+flip)%2;
+      if(child_frames[j].size() == 1){
+	framePtr->AddChildFrame(child_frames[j][0]);
+      } else {
+	RestFrame* new_framePtr = GetNewDecayFrame(GetName(),GetTitle());
+	framePtr->AddChildFrame(new_framePtr);
+	AssembleRecursive(new_framePtr, child_frames[j], child_Ps[j]);
+      }
+    }
+  }
+
+  // N^3 search over the planes of pairs of inputs
+  void RSelfAssemblingFrame::AssembleHemispheres(vector<RestFrame*>& frames, vector<TLorentzVector>& Ps,
+						 vector<RestFrame*>* child_frames, vector<TLorentzVector>* child_Ps,
+						 TLorentzVector* child_hem){
+    int Ninput = frames.size();
     int ip_max[2];
     int jp_max[2];
     for(int i = 0; i < 2; i++) ip_max[i] = -1;
@@ -206,16 +261,10 @@ namespace RestFrames {
       }
     }
 
-    vector<RestFrame*> child_frames[2];
-    vector<TLorentzVector> child_Ps[2];
-    TLorentzVector hem[2];
-    for(int i = 0; i < 2; i++){
-      hem[i].SetPxPyPzE(0.,0.,0.,0.);
-    }
     for(int i = 0; i < 2; i++){
       child_frames[jp_max[i]].push_back(frames[ip_max[i]]);
       child_Ps[jp_max[i]].push_back(Ps[ip_max[i]]);
-      hem[jp_max[i]] += Ps[ip_max[i]];
+      child_hem[jp_max[i]] += Ps[ip_max[i]];
     }
     TVector3 nRef = Ps[ip_max[0]].Vect().Cross(Ps[ip_max[1]].Vect());
     for(int i = 0; i < Ninput; i++){
@@ -223,19 +272,7 @@ namespace RestFrames {
       int ihem = int(Ps[i].Vect().Dot(nRef) > 0.);
       child_frames[ihem].push_back(frames[i]);
       child_Ps[ihem].push_back(Ps[i]);
-      hem[ihem] += Ps[i];
-    }
-
-    int flip = int(hem[1].M() > hem[0].M());
-    for(int i = 0; i < 2; i++){
-      int j = (i+flip)%2;
-      if(child_frames[j].size() == 1){
-	framePtr->AddChildFrame(child_frames[j][0]);
-      } else {
-	RestFrame* new_framePtr = GetNewDecayFrame(GetName(),GetTitle());
-	framePtr->AddChildFrame(new_framePtr);
-	AssembleRecursive(new_framePtr, child_frames[j], child_Ps[j]);
-      }
+      child_hem[ihem] += Ps[i];
     }
   }
 
@@ -249,7 +286,8 @@ namespace RestFrames {
   RestFrame* RSelfAssemblingFrame::GetNewDecayFrame(const string& sname, const string& stitle){
     if(m_Ndecay < m_DecayFrames.GetN()){
       m_DecayFrames.Get(m_Ndecay)->ClearFrame();
-      dynamic_cast<RFrame*>(m_DecayFrames.Get(m_Ndecay))->ClearRFrame();
+      m_DecayRFrames[m_Ndecay]->ClearRFrame();
+      m_DecayRFrames[m_Ndecay]->SetImmutableStates(m_ImmutableStates);
       m_Ndecay++;
       return m_DecayFrames.Get(m_Ndecay-1);
     }
@@ -259,8 +297,10 @@ namespace RestFrames {
     ostringstream title; 
     title << "#left(" << stitle << "#right)_{" << m_Ndecay+1 << "}";
     RDecayFrame* framePtr = new RDecayFrame(name.str(),title.str());
+    framePtr->SetImmutableStates(m_ImmutableStates);
     
     m_DecayFrames.Add(framePtr);
+    m_DecayRFrames.push_back(framePtr);
     m_Ndecay++;
     return framePtr;
   }
@@ -268,7 +308,7 @@ namespace RestFrames {
   RestFrame* RSelfAssemblingFrame::GetNewVisibleFrame(const string& sname, const string& stitle){
     if(m_Nvisible < m_VisibleFrames.GetN()){
       m_VisibleFrames.Get(m_Nvisible)->ClearFrame();
-      dynamic_cast<RFrame*>(m_VisibleFrames.Get(m_Nvisible))->ClearRFrame();
+      m_VisibleRFrames[m_Nvisible]->ClearRFrame();
       m_Nvisible++;
       return m_VisibleFrames.Get(m_Nvisible-1);
     }
@@ -280,6 +320,7 @@ namespace RestFrames {
     RVisibleFrame* framePtr = new RVisibleFrame(name.str(),title.str());
     
     m_VisibleFrames.Add(framePtr);
+    m_VisibleRFrames.push_back(framePtr);
     m_Nvisible++;
     return framePtr;
   }
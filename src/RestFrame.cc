@@ -1,8 +1,8 @@
 #include <iostream>
-#include "RestFrames/RestFrames_config.h"
 #include "RestFrames/RestFrame.hh"
 #include "RestFrames/RestFrameList.hh"
 #include "RestFrames/FrameLink.hh"
+#include "RestFrames/FrameTable.hh"
 #include "RestFrames/FrameLog.hh"
 
 
@@ -26,6 +26,7 @@ namespace RestFrames {
   }
 
   RestFrame::~RestFrame(){
+    if(m_TablePtr) m_TablePtr->RemoveFrame(this);
     ClearFrame();
   }
 
@@ -36,6 +37,9 @@ namespace RestFrames {
     m_Mind   = false;
     m_Spirit = false;
     m_ParentLinkPtr = nullptr;
+    m_ProdFramePtr = nullptr;
+    m_TablePtr = nullptr;
+    m_TableIndex = -1;
   }
 
   int RestFrame::GenKey(){
@@ -247,6 +251,8 @@ namespace RestFrames {
 
   const RestFrame* RestFrame::GetLabFrame() const {
     if(m_Type == FLab) return this;
+    if(m_TablePtr && m_TablePtr->IsFilled() && m_TablePtr->GetIndex(this) >= 0)
+      return m_TablePtr->GetFrame(0);
     if(!m_ParentLinkPtr) return nullptr;
     const RestFrame* parentPtr = GetParentFrame();
     if(parentPtr) return parentPtr->GetLabFrame();
@@ -324,8 +330,7 @@ namespace RestFrames {
   
     for(int i = 0; i < Nkey; i++){
       if((*KEYS)[i] == m_Key){
-	cout << endl << "Warning: reference frame ";
-	cout << m_Name.c_str() << " appears more than once in tree" << endl;
+	RF_LOG(LogWarning, "reference frame appears more than once in tree", this);
 	return true;
       }
     }
@@ -505,6 +510,110 @@ namespace RestFrames {
     return V1.Angle(V2);
   }
 
+  DecayAngles RestFrame::GetDecayAngles(const TVector3& axis) const {
+    DecayAngles angles;
+    angles.CosDecayAngle = 0.;
+    angles.DeltaPhiDecayAngle = 0.;
+    angles.DeltaPhiBoostVisible = 0.;
+    angles.DeltaPhiDecayVisible = 0.;
+    angles.DeltaPhiVisible = 0.;
+    angles.DecayPlaneNormalVector.SetXYZ(0.,0.,0.);
+
+    // the lab frame defines some of these differently
+    if(IsLabFrame()){
+      angles.CosDecayAngle = GetCosDecayAngle();
+      angles.DeltaPhiDecayAngle = GetDeltaPhiDecayAngle(axis);
+      angles.DeltaPhiBoostVisible = GetDeltaPhiBoostVisible(axis);
+      angles.DeltaPhiDecayVisible = GetDeltaPhiDecayVisible(axis);
+      angles.DeltaPhiVisible = GetDeltaPhiVisible(axis);
+      angles.DecayPlaneNormalVector = GetDecayPlaneNormalVector();
+      return angles;
+    }
+
+    int Nchild = GetNChildren();
+    TVector3 axis_unit = axis.Unit();
+    const RestFrame* child_framePtr = Nchild > 0 ? GetChildFrame(0) : nullptr;
+
+    if(child_framePtr && m_ParentLinkPtr){
+      TVector3 V1 = GetParentBoostVector().Unit();
+      TVector3 V2 = child_framePtr->GetFourVector(this).Vect().Unit();
+      angles.CosDecayAngle = V1.Dot(V2);
+    }
+
+    // production frame
+    const RestFrame* prod_framePtr = GetProductionFrame();
+    TLorentzVector Pchild_prod;
+    if(prod_framePtr && child_framePtr){
+      TLorentzVector Pthis = GetFourVector(prod_framePtr);
+      Pchild_prod = child_framePtr->GetFourVector(prod_framePtr);
+      TLorentzVector Pchild = Pchild_prod;
+
+      TVector3 boost_par = Pthis.BoostVector();
+      boost_par = boost_par.Dot(axis_unit)*axis_unit;
+      Pthis.Boost(-boost_par);
+      Pchild.Boost(-boost_par);
+      TVector3 boost_perp = Pthis.BoostVector();
+      Pchild.Boost(-boost_perp);
+
+      TVector3 V = Pchild.Vect();
+      V = V - V.Dot(axis_unit)*axis_unit;
+      angles.DeltaPhiDecayAngle = V.Angle(boost_perp);
+    }
+
+    if(Nchild >= 2){
+      const RestFrame* parentPtr = GetParentFrame();
+      TVector3 V1;
+      if(prod_framePtr && parentPtr == prod_framePtr)
+	V1 = Pchild_prod.Vect();
+      else
+	V1 = child_framePtr->GetFourVector(parentPtr).Vect();
+      TVector3 V2 = GetChildFrame(1)->GetFourVector(parentPtr).Vect();
+      angles.DecayPlaneNormalVector = V1.Cross(V2).Unit();
+    }
+
+    // lab frame, boosted to rest along and then perpendicular to axis
+    const RestFrame* labPtr = GetLabFrame();
+    if(!labPtr) return angles;
+    TLorentzVector Pthis = GetFourVector(labPtr);
+    TLorentzVector Pvis = GetVisibleFourVector(labPtr);
+
+    TVector3 boost_par = Pthis.BoostVector();
+    boost_par = boost_par.Dot(axis_unit)*axis_unit;
+    Pthis.Boost(-boost_par);
+    TVector3 boost_perp = Pthis.BoostVector();
+
+    Pvis.Boost(-boost_par);
+    Pvis.Boost(-boost_perp);
+    TVector3 Vv = Pvis.Vect();
+    Vv = Vv - Vv.Dot(axis_unit)*axis_unit;
+    angles.DeltaPhiBoostVisible = Vv.Angle(boost_perp);
+
+    if(child_framePtr){
+      TLorentzVector Pchild = child_framePtr->GetFourVector(labPtr);
+      Pchild.Boost(-boost_par);
+      Pchild.Boost(-boost_perp);
+      TVector3 Vc = Pchild.Vect();
+      Vc = Vc - Vc.Dot(axis_unit)*axis_unit;
+      angles.DeltaPhiDecayVisible = Vv.Angle(Vc);
+    }
+
+    if(Nchild == 2){
+      TLorentzVector P1 = GetChildFrame(0)->GetVisibleFourVector(labPtr);
+      TLorentzVector P2 = GetChildFrame(1)->GetVisibleFourVector(labPtr);
+      P1.Boost(-boost_par);
+      P2.Boost(-boost_par);
+      P1.Boost(-boost_perp);
+      P2.Boost(-boost_perp);
+      TVector3 V1 = P1.Vect();
+      TVector3 V2 = P2.Vect();
+      V1 = V1 - V1.Dot(axis_unit)*axis_unit;
+      V2 = V2 - V2.Dot(axis_unit)*axis_unit;
+      angles.DeltaPhiVisible = V1.Angle(V2);
+    }
+
+    return angles;
+  }
+
   double RestFrame::GetVisibleShape() const {
     if(GetNChildren() != 2) return 0.;
     TVector3 P1 = m_ChildLinks[0]->GetChildFrame()->GetVisibleFourVector(this).Vect();
@@ -579,19 +688,52 @@ namespace RestFrames {
     if(!framePtr) framePtr = GetLabFrame();
  
     V.SetVectM(m_P.Vect(),m_P.M());
-    if(framePtr->IsSame(m_ProdFramePtr)) return V;
+    BoostFromProductionFrame(V, framePtr);
+    return V;
+  }
+
+  void RestFrame::BoostFromProductionFrame(TLorentzVector& V, const RestFrame* framePtr) const {
+    // a frame never given a four-vector (a generator lab frame)
+    // is its own production frame
+    const RestFrame* prod_framePtr = m_ProdFramePtr ? m_ProdFramePtr : this;
+    if(framePtr->IsSame(prod_framePtr)) return;
+
+    if(m_TablePtr && m_TablePtr->IsFilled()){
+      int i = m_TablePtr->GetIndex(prod_framePtr);
+      int j = m_TablePtr->GetIndex(framePtr);
+      if(i >= 0 && j >= 0){
+	m_TablePtr->Boost(V, i, j);
+	return;
+      }
+    }
 
-    vector<FrameLink*>* linksPtr = new vector<FrameLink*>;
-    vector<int>* linkSignsPtr = new vector<int>;
-    if(!m_ProdFramePtr->FindPathToFrame(framePtr,linksPtr,linkSignsPtr,nullptr)) return V;
+    vector<FrameLink*> links;
+    vector<int> linkSigns;
+    if(!prod_framePtr->FindPathToFrame(framePtr,&links,&linkSigns,nullptr)) return;
   
-    int Nlink = linksPtr->size();
+    int Nlink = links.size();
     for(int i = 0; i < Nlink; i++){
-      V.Boost((*linkSignsPtr)[i]*(*linksPtr)[i]->GetBoostVector());
+      V.Boost(linkSigns[i]*links[i]->GetBoostVector());
     }
-    delete linksPtr;
-    delete linkSignsPtr;
-    return V;
+  }
+
+  void RestFrame::SumDescendantFourVectors(){
+    m_VisibleP.SetPxPyPzE(0.,0.,0.,0.);
+    m_InvisibleP.SetPxPyPzE(0.,0.,0.,0.);
+    // nothing to boost for a leaf (which may be massless)
+    int Nc = GetNChildren();
+    if(Nc == 0) return;
+    // children's sums are in this frame
+    for(int c = 0; c < Nc; c++){
+      RestFrame* childPtr = GetChildFrame(c);
+      if(childPtr->IsVisibleFrame()) m_VisibleP += childPtr->m_P;
+      if(childPtr->IsInvisibleFrame()) m_InvisibleP += childPtr->m_P;
+      m_VisibleP += childPtr->m_VisibleP;
+      m_InvisibleP += childPtr->m_InvisibleP;
+    }
+    if(!m_ParentLinkPtr || IsSame(m_ProdFramePtr)) return;
+    m_VisibleP.Boost(GetParentBoostVector());
+    m_InvisibleP.Boost(GetParentBoostVector());
   }
 
   TLorentzVector RestFrame::GetVisibleFourVector(const RestFrame& frame) const {
@@ -600,13 +742,8 @@ namespace RestFrames {
   TLorentzVector RestFrame::GetVisibleFourVector(const RestFrame* framePtr) const {
     TLorentzVector V(0.,0.,0.,0.);
     if(!framePtr || !m_Spirit) return V;
-    int Nc = GetNChildren();
-    for(int c = 0; c < Nc; c++){
-      RestFrameList* framesPtr = m_ChildLinks[c]->GetChildFrame()->GetListVisibleFrames();
-      int Nf = framesPtr->GetN();
-      for(int f = 0; f < Nf; f++) V += framesPtr->Get(f)->GetFourVector(framePtr);
-      delete framesPtr;
-    }
+    V = m_VisibleP;
+    BoostFromProductionFrame(V, framePtr);
     return V;
   }
   TLorentzVector RestFrame::GetInvisibleFourVector(const RestFrame& frame) const {
@@ -616,13 +753,8 @@ namespace RestFrames {
     TLorentzVector V(0.,0.,0.,0.);
     if(!m_Spirit) return V;
     if(!framePtr) framePtr = this;
-    int Nc = GetNChildren();
-    for(int c = 0; c < Nc; c++){
-      RestFrameList* framesPtr = GetChildFrame(c)->GetListInvisibleFrames();
-      int Nf = framesPtr->GetN();
-      for(int f = 0; f < Nf; f++) V += framesPtr->Get(f)->GetFourVector(framePtr);
-      delete framesPtr;
-    }
+    V = m_InvisibleP;
+    BoostFromProductionFrame(V, framePtr);
     return V;
   }
   double RestFrame::GetEnergy(const RestFrame& frame) const {
@@ -755,19 +887,4 @@ namespace RestFrames {
     return prod;
   }
 
-  // Initializer.
-  __attribute__((constructor))
-  static void initializer(void){
-    printf("\n" "\x1b[36m");
-    printf(PACKAGE_NAME);
-    printf(" v");
-    printf(PACKAGE_VERSION);
-    printf(" -- Developed by Christopher Rogan (crogan@cern.ch)\n");
-    printf("                     ");
-    printf("Copyright (c) 2014-2015, Christopher Rogan\n");
-    printf("                     ");
-    printf("http://RestFrames.com\n");
-    printf("\x1b[0m" "\n");
-  }
-
 }
@@ -1,3 +1,4 @@
+#include <algorithm>
 #include "RestFrames/RestFrameList.hh"
 
 using namespace std;
@@ -15,8 +16,18 @@ namespace RestFrames {
     Clear();
   }
 
+  void RestFrameList::AddKey(int key){
+    m_Keys.insert(lower_bound(m_Keys.begin(), m_Keys.end(), key), key);
+  }
+
+  void RestFrameList::RemoveKey(int key){
+    vector<int>::iterator it = lower_bound(m_Keys.begin(), m_Keys.end(), key);
+    if(it != m_Keys.end() && *it == key) m_Keys.erase(it);
+  }
+
   void RestFrameList::Clear(){
     m_Frames.clear();
+    m_Keys.clear();
   }
 
   RestFrame* RestFrameList::Get(int i) const { 
@@ -25,23 +36,24 @@ namespace RestFrames {
   }
 
   void RestFrameList::Add(RestFrame* framePtr){
-    int N = GetN();
-    for(int i = 0; i < N; i++){
-      if(framePtr->GetKey() == m_Frames[i]->GetKey()) return;
-    }
+    if(!framePtr) return;
+    if(Contains(framePtr)) return;
     m_Frames.push_back(framePtr);
+    AddKey(framePtr->GetKey());
   }
 
-  void RestFrameList::Add(RestFrameList* framesPtr){
+  void RestFrameList::Add(const RestFrameList* framesPtr){
     int N = framesPtr->GetN();
     for(int i = 0; i < N; i++) Add(framesPtr->Get(i));
   }
 
   int RestFrameList::Remove(const RestFrame* framePtr){
+    if(!Contains(framePtr)) return -1;
     int N = GetN();
     for(int i = 0; i < N; i++){
       if(framePtr->GetKey() == m_Frames[i]->GetKey()){
 	m_Frames.erase(m_Frames.begin()+i);
+	RemoveKey(framePtr->GetKey());
 	return i;
       }
     }
@@ -55,11 +67,7 @@ namespace RestFrames {
 
   bool RestFrameList::Contains(const RestFrame* framePtr) const {
     if(!framePtr) return false;
-    int N = GetN();
-    for(int i = 0; i < N; i++){
-      if(framePtr->GetKey() == m_Frames[i]->GetKey()) return true;
-    }
-    return false;
+    return binary_search(m_Keys.begin(), m_Keys.end(), framePtr->GetKey());
   }
 
   bool RestFrameList::Contains(const RestFrameList* framesPtr) const {
@@ -86,8 +94,9 @@ namespace RestFrames {
 
   RestFrameList* RestFrameList::Copy() const {
     RestFrameList* framesPtr = new RestFrameList();
-    int N = GetN();
-    for(int i = 0; i < N; i++) framesPtr->Add(m_Frames[i]);
+    // entries are already unique
+    framesPtr->m_Frames = m_Frames;
+    framesPtr->m_Keys = m_Keys;
     return framesPtr;
   }
 
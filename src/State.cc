@@ -27,12 +27,15 @@ namespace RestFrames {
   void State::Init(){
     m_ParentJigsawPtr = nullptr;
     m_ChildJigsawPtr = nullptr;
+    m_Version = 0;
+    UpdateCache();
   }
 
   void State::Clear(){
     m_ParentJigsawPtr = nullptr;
     m_ChildJigsawPtr = nullptr;
     m_P.SetPxPyPzE(0.,0.,0.,0.);
+    UpdateCache();
     m_Frames.Clear();
   }
 
@@ -56,8 +59,17 @@ namespace RestFrames {
     return newkey;
   }
 
+  bool State::IsInvisibleState() const {
+    return m_Type == SInvisible;
+  }
+
+  bool State::IsCombinatoricState() const {
+    return m_Type == SCombinatoric;
+  }
+
   void State::Boost(const TVector3& B){
     m_P.Boost(B);
+    InvalidateCache();
   }
 
   void State::AddFrame(RestFrame* framePtr){
@@ -105,12 +117,50 @@ namespace RestFrames {
 
   void State::SetFourVector(const TLorentzVector& V){
     m_P.SetVectM(V.Vect(),V.M());
+    UpdateCache();
+  }
+
+  // the four-vector is read far more often than it changes
+  void State::UpdateCache(){
+    m_Version++;
+    FillCache();
+  }
+
+  void State::InvalidateCache(){
+    m_Version++;
+    m_CacheValid = false;
+  }
+
+  void State::FillCache() const {
+    m_CachedP.SetVectM(m_P.Vect(),m_P.M());
+    m_CachedM = m_CachedP.M();
+    m_CachedPMag = m_CachedP.P();
+    m_CacheValid = true;
   }
 
   TLorentzVector State::GetFourVector() const {
-    TLorentzVector V;
-    V.SetVectM(m_P.Vect(),m_P.M());
-    return V;
+    if(!m_CacheValid) FillCache();
+    return m_CachedP;
+  }
+
+  double State::GetMass() const {
+    if(!m_CacheValid) FillCache();
+    return m_CachedM;
+  }
+
+  double State::GetMomentum() const {
+    if(!m_CacheValid) FillCache();
+    return m_CachedPMag;
+  }
+
+  void State::SaveFourVectors(vector<TLorentzVector>& Ps) const {
+    Ps.push_back(m_P);
+  }
+
+  int State::RestoreFourVectors(const vector<TLorentzVector>& Ps, int i){
+    m_P = Ps[i];
+    UpdateCache();
+    return i+1;
   }
 
   void State::FillGroupJigsawDependancies(JigsawList* jigsawsPtr) const {
@@ -75,8 +75,8 @@ namespace RestFrames {
 
   StateList* StateList::Copy() const {
     StateList* statesPtr = new StateList();
-    int N = GetN();
-    for(int i = 0; i < N; i++) statesPtr->Add(m_States[i]);
+    // entries are already unique
+    statesPtr->m_States = m_States;
     return statesPtr;
   }
 
@@ -96,4 +96,19 @@ namespace RestFrames {
     }
   }
 
+  void StateList::SaveFourVectors(vector<TLorentzVector>& Ps) const {
+    int N = GetN();
+    for(int i = 0; i < N; i++){
+      m_States[i]->SaveFourVectors(Ps);
+    }
+  }
+
+  int StateList::RestoreFourVectors(const vector<TLorentzVector>& Ps, int i){
+    int N = GetN();
+    for(int s = 0; s < N; s++){
+      i = m_States[s]->RestoreFourVectors(Ps, i);
+    }
+    return i;
+  }
+
 }